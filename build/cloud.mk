@@ -5,9 +5,14 @@ CLOUD_SERVER_SOURCES = \
 	$(SRC)/Cloud/Client.cpp \
 	$(SRC)/Cloud/Thermal.cpp \
 	$(SRC)/Cloud/Data.cpp \
+	$(SRC)/Cloud/Shard.cpp \
+	$(SRC)/Cloud/Journal.cpp \
+	$(SRC)/Cloud/Metrics.cpp \
+	$(SRC)/Cloud/AccessLog.cpp \
 	$(SRC)/Cloud/Sender.cpp \
+	$(SRC)/Cloud/TrafficFanout.cpp \
 	$(SRC)/Cloud/Main.cpp
-CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
+CLOUD_SERVER_DEPENDS = ASYNC LIBNET IO OS THREAD GEO MATH UTIL
 $(eval $(call link-program,xcsoar-cloud-server,CLOUD_SERVER))
 
 CLOUD_TO_KML_SOURCES = \
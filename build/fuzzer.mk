@@ -29,7 +29,7 @@ FUZZ_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
 	$(FUZZER_SRC_DIR)/FuzzAirspaceParser.cpp
-FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
+FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS THREAD AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,FuzzAirspaceParser,FUZZ_AIRSPACE_PARSER))
 
 OUTPUTS += $(FUZZ_WAYPOINT_READER_BIN) $(FUZZ_AIRSPACE_PARSER_BIN)
@@ -88,14 +88,18 @@ TEST_NAMES = \
 	test_pressure \
 	test_task \
 	TestOverwritingRingBuffer \
+	TestTripleBuffer \
+	TestAsyncFileOutputStream \
 	TestDateTime TestRoughTime TestWrapClock \
 	TestMath \
 	TestMathTables \
 	TestAngle TestARange \
 	TestUnits TestEarth TestSunEphemeris \
 	TestValidity TestUTM TestProfile \
+	TestTerrainCache \
 	TestAllocatedGrid \
-	TestRadixTree TestGeoBounds TestGeoClip \
+	TestRadixTree TestFlatHashMap TestGeoBounds TestGeoClip \
+	TestGeoGridIndex \
 	TestLogger TestGRecord TestDriver TestClimbAvCalc \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet \
@@ -111,6 +115,8 @@ TEST_NAMES = \
 	TestAirspaceParser \
 	TestMETARParser \
 	TestIGCParser \
+	TestIGCBulkParser \
+	TestTriangleContest \
 	TestStrings TestUTF8 \
 	TestCRC \
 	TestUnitsFormatter \
@@ -122,7 +128,9 @@ TEST_NAMES = \
 	TestLXNToIGC \
 	TestLeastSquares \
 	TestHexString \
-	TestThermalBand
+	TestThermalBand \
+	TestRasterInterpolation \
+	TestSearchPointArrays
 
 
 TESTS = $(call name-to-bin,$(TEST_NAMES))
@@ -160,6 +168,22 @@ TEST_OVERWRITING_RING_BUFFER_SOURCES = \
 TEST_OVERWRITING_RING_BUFFER_DEPENDS = MATH
 $(eval $(call link-program,TestOverwritingRingBuffer,TEST_OVERWRITING_RING_BUFFER))
 
+TEST_TRIPLE_BUFFER_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTripleBuffer.cpp
+$(eval $(call link-program,TestTripleBuffer,TEST_TRIPLE_BUFFER))
+
+TEST_ASYNC_FILE_OUTPUT_STREAM_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAsyncFileOutputStream.cpp
+TEST_ASYNC_FILE_OUTPUT_STREAM_DEPENDS = IO OS THREAD UTIL
+$(eval $(call link-program,TestAsyncFileOutputStream,TEST_ASYNC_FILE_OUTPUT_STREAM))
+
+BENCHMARK_DEVICE_HAND_OVER_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkDeviceHandOver.cpp
+BENCHMARK_DEVICE_HAND_OVER_DEPENDS = THREAD
+$(eval $(call link-program,BenchmarkDeviceHandOver,BENCHMARK_DEVICE_HAND_OVER))
+
 TEST_IGC_PARSER_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -167,6 +191,24 @@ TEST_IGC_PARSER_SOURCES = \
 TEST_IGC_PARSER_DEPENDS = MATH UTIL
 $(eval $(call link-program,TestIGCParser,TEST_IGC_PARSER))
 
+TEST_IGC_BULK_PARSER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCBulkParser.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestIGCBulkParser.cpp
+TEST_IGC_BULK_PARSER_DEPENDS = OS IO MATH UTIL TIME
+$(eval $(call link-program,TestIGCBulkParser,TEST_IGC_BULK_PARSER))
+
+TEST_TRIANGLE_CONTEST_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCBulkParser.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestTriangleContest.cpp
+TEST_TRIANGLE_CONTEST_DEPENDS = CONTEST OS IO GEO MATH UTIL TIME
+$(eval $(call link-program,TestTriangleContest,TEST_TRIANGLE_CONTEST))
+
 TEST_METAR_PARSER_SOURCES = \
 	$(SRC)/Weather/METARParser.cpp \
 	$(SRC)/Units/Descriptor.cpp \
@@ -189,7 +231,7 @@ TEST_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAirspaceParser.cpp
 TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
+TEST_AIRSPACE_PARSER_DEPENDS = IO OS THREAD AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
 TEST_DATE_TIME_SOURCES = \
@@ -219,6 +261,16 @@ TEST_PROFILE_SOURCES = \
 TEST_PROFILE_DEPENDS = PROFILE MATH IO OS UTIL
 $(eval $(call link-program,TestProfile,TEST_PROFILE))
 
+TEST_TERRAIN_CACHE_SOURCES = \
+	$(SRC)/LocalPath.cpp \
+	$(SRC)/Profile/Profile.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/FakeLogFile.cpp \
+	$(TEST_SRC_DIR)/TestTerrainCache.cpp
+TEST_TERRAIN_CACHE_DEPENDS = TERRAIN PROFILE IO OS ZZIP THREAD GEO MATH UTIL
+$(eval $(call link-program,TestTerrainCache,TEST_TERRAIN_CACHE))
+
 TEST_MAC_CREADY_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestMacCready.cpp
@@ -288,7 +340,7 @@ TEST_TROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_troute.cpp
-TEST_TROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_TROUTE_DEPENDS = TERRAIN OS IO ZZIP ROUTE THREAD GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_troute,TEST_TROUTE))
 
 TEST_REACH_SOURCES = \
@@ -297,9 +349,15 @@ TEST_REACH_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_reach.cpp
-TEST_REACH_DEPENDS = TERRAIN IO ZZIP OS ROUTE GLIDE GEO MATH UTIL
+TEST_REACH_DEPENDS = TERRAIN OS IO ZZIP ROUTE THREAD GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_reach,TEST_REACH))
 
+BENCHMARK_REACH_UPDATE_SOURCES = \
+	$(SRC)/Operation/Operation.cpp \
+	$(TEST_SRC_DIR)/BenchmarkReachUpdate.cpp
+BENCHMARK_REACH_UPDATE_DEPENDS = TERRAIN OS IO ZZIP ROUTE THREAD GLIDE GEO MATH UTIL
+$(eval $(call link-program,BenchmarkReachUpdate,BENCHMARK_REACH_UPDATE))
+
 TEST_ROUTE_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -313,7 +371,7 @@ TEST_ROUTE_SOURCES = \
 	$(TEST_SRC_DIR)/harness_airspace.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/test_route.cpp
-TEST_ROUTE_DEPENDS = TERRAIN IO ZZIP OS ROUTE AIRSPACE GLIDE GEO MATH UTIL
+TEST_ROUTE_DEPENDS = TERRAIN OS IO ZZIP ROUTE THREAD AIRSPACE GLIDE GEO MATH UTIL
 $(eval $(call link-program,test_route,TEST_ROUTE))
 
 TEST_REPLAY_TASK_SOURCES = \
@@ -351,6 +409,18 @@ TEST_REPLAY_TASK_SOURCES = \
 TEST_REPLAY_TASK_DEPENDS = TASK ROUTE WAYPOINT GLIDE GEO MATH IO OS UTIL TIME
 $(eval $(call link-program,test_replay_task,TEST_REPLAY_TASK))
 
+TEST_RASTER_INTERPOLATION_SOURCES = \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestRasterInterpolation.cpp
+$(eval $(call link-program,TestRasterInterpolation,TEST_RASTER_INTERPOLATION))
+
+TEST_SEARCH_POINT_ARRAYS_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestSearchPointArrays.cpp
+TEST_SEARCH_POINT_ARRAYS_DEPENDS = GEO MATH UTIL
+$(eval $(call link-program,TestSearchPointArrays,TEST_SEARCH_POINT_ARRAYS))
+
 TEST_MATH_TABLES_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestMathTables.cpp
@@ -606,6 +676,17 @@ TEST_RADIX_TREE_SOURCES = \
 TEST_RADIX_TREE_DEPENDS = UTIL
 $(eval $(call link-program,TestRadixTree,TEST_RADIX_TREE))
 
+TEST_FLAT_HASH_MAP_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestFlatHashMap.cpp
+$(eval $(call link-program,TestFlatHashMap,TEST_FLAT_HASH_MAP))
+
+TEST_GEO_GRID_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestGeoGridIndex.cpp
+TEST_GEO_GRID_INDEX_DEPENDS = GEO MATH
+$(eval $(call link-program,TestGeoGridIndex,TEST_GEO_GRID_INDEX))
+
 TEST_LOGGER_SOURCES = \
 	$(SRC)/IGC/IGCFix.cpp \
 	$(SRC)/IGC/IGCWriter.cpp \
@@ -621,7 +702,7 @@ TEST_LOGGER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestLogger.cpp
-TEST_LOGGER_DEPENDS = IO OS GEO MATH UTIL
+TEST_LOGGER_DEPENDS = IO OS THREAD GEO MATH UTIL
 $(eval $(call link-program,TestLogger,TEST_LOGGER))
 
 TEST_GRECORD_SOURCES = \
@@ -724,6 +805,7 @@ DEBUG_PROGRAM_NAMES = \
 	FlightTable \
 	RunTrace \
 	RunContestAnalysis \
+	BenchmarkContestDijkstra \
 	RunWaveComputer \
 	FlightPath \
 	BenchmarkProjection \
@@ -739,6 +821,12 @@ DEBUG_PROGRAM_NAMES = \
 	KeyCodeDumper \
 	LoadTopography LoadTerrain \
 	RunHeightMatrix \
+	BenchmarkScanLine \
+	BenchmarkReachUpdate \
+	BenchmarkAirspacePolygon \
+	BenchmarkAirspaceTree \
+	BenchmarkIGCParser \
+	BenchmarkDeviceHandOver \
 	RunInputParser \
 	RunWaypointParser RunAirspaceParser \
 	RunFlightParser \
@@ -769,6 +857,7 @@ DEBUG_PROGRAM_NAMES = \
 	RunProgressWindow \
 	RunJobDialog \
 	RunAnalysis \
+	RunBatchAnalysis \
 	RunAirspaceWarningDialog \
 	RunProfileListDialog \
 	TestNotify \
@@ -789,7 +878,9 @@ DEBUG_PROGRAM_NAMES = \
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
-	FeedFlyNetData
+	FeedFlyNetData \
+	FeedSkyLinesFixes \
+	BenchmarkCloudIndex
 endif
 
 ifeq ($(TARGET),PC)
@@ -1143,7 +1234,7 @@ LOAD_TERRAIN_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/LoadTerrain.cpp
 LOAD_TERRAIN_CPPFLAGS = $(SCREEN_CPPFLAGS)
-LOAD_TERRAIN_DEPENDS = TERRAIN GEO MATH OS IO ZZIP UTIL
+LOAD_TERRAIN_DEPENDS = TERRAIN THREAD GEO MATH OS IO ZZIP UTIL
 $(eval $(call link-program,LoadTerrain,LOAD_TERRAIN))
 
 RUN_HEIGHT_MATRIX_SOURCES = \
@@ -1152,9 +1243,48 @@ RUN_HEIGHT_MATRIX_SOURCES = \
 	$(SRC)/Operation/Operation.cpp \
 	$(TEST_SRC_DIR)/RunHeightMatrix.cpp
 RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
-RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN GEO MATH IO OS ZZIP UTIL
+RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN THREAD OS IO ZZIP GEO MATH UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
+BENCHMARK_SCAN_LINE_SOURCES = \
+	$(SRC)/Terrain/RasterBuffer.cpp \
+	$(TEST_SRC_DIR)/BenchmarkScanLine.cpp
+BENCHMARK_SCAN_LINE_DEPENDS = MATH
+$(eval $(call link-program,BenchmarkScanLine,BENCHMARK_SCAN_LINE))
+
+BENCHMARK_AIRSPACE_POLYGON_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspacePolygon.cpp
+BENCHMARK_AIRSPACE_POLYGON_LDADD = $(FAKE_LIBS)
+BENCHMARK_AIRSPACE_POLYGON_DEPENDS = IO OS THREAD AIRSPACE ZZIP GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAirspacePolygon,BENCHMARK_AIRSPACE_POLYGON))
+
+BENCHMARK_AIRSPACE_TREE_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Units/Descriptor.cpp \
+	$(SRC)/Units/System.cpp \
+	$(SRC)/Operation/Operation.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceTree.cpp
+BENCHMARK_AIRSPACE_TREE_LDADD = $(FAKE_LIBS)
+BENCHMARK_AIRSPACE_TREE_DEPENDS = IO OS THREAD AIRSPACE ZZIP GEO MATH UTIL
+$(eval $(call link-program,BenchmarkAirspaceTree,BENCHMARK_AIRSPACE_TREE))
+
+BENCHMARK_IGC_PARSER_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/IGC/IGCBulkParser.cpp \
+	$(TEST_SRC_DIR)/BenchmarkIGCParser.cpp
+BENCHMARK_IGC_PARSER_DEPENDS = IO OS MATH UTIL TIME
+$(eval $(call link-program,BenchmarkIGCParser,BENCHMARK_IGC_PARSER))
+
 RUN_INPUT_PARSER_SOURCES = \
 	$(SRC)/Input/InputKeys.cpp \
 	$(SRC)/Input/InputConfig.cpp \
@@ -1219,6 +1349,7 @@ $(eval $(call link-program,RunFlightParser,RUN_FLIGHT_PARSER))
 
 RUN_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceStore.cpp \
 	$(SRC)/Units/Descriptor.cpp \
 	$(SRC)/Units/System.cpp \
 	$(SRC)/Operation/Operation.cpp \
@@ -1227,7 +1358,7 @@ RUN_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/FakeLanguage.cpp \
 	$(TEST_SRC_DIR)/RunAirspaceParser.cpp
 RUN_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-RUN_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL
+RUN_AIRSPACE_PARSER_DEPENDS = IO OS THREAD AIRSPACE ZZIP GEO MATH UTIL
 $(eval $(call link-program,RunAirspaceParser,RUN_AIRSPACE_PARSER))
 
 ENUMERATE_PORTS_SOURCES = \
@@ -1669,10 +1800,22 @@ RUN_CONTEST_SOURCES = \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/ContestPrinting.cpp \
 	$(TEST_SRC_DIR)/RunContestAnalysis.cpp
-RUN_CONTEST_LDADD = $(DEBUG_REPLAY_LDADD)
+RUN_CONTEST_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
 RUN_CONTEST_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,RunContestAnalysis,RUN_CONTEST))
 
+BENCHMARK_CONTEST_DIJKSTRA_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/BenchmarkContestDijkstra.cpp
+BENCHMARK_CONTEST_DIJKSTRA_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
+BENCHMARK_CONTEST_DIJKSTRA_DEPENDS = CONTEST UTIL GEO MATH TIME
+$(eval $(call link-program,BenchmarkContestDijkstra,BENCHMARK_CONTEST_DIJKSTRA))
+
 RUN_WAVE_COMPUTER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/WaveComputer.cpp \
@@ -1703,7 +1846,7 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(TEST_SRC_DIR)/FlightPhaseJSON.cpp \
 	$(TEST_SRC_DIR)/FlightPhaseDetector.cpp \
 	$(TEST_SRC_DIR)/AnalyseFlight.cpp
-ANALYSE_FLIGHT_LDADD = $(DEBUG_REPLAY_LDADD)
+ANALYSE_FLIGHT_LDADD = $(CONTEST_LIBS) $(DEBUG_REPLAY_LDADD)
 ANALYSE_FLIGHT_DEPENDS = CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,AnalyseFlight,ANALYSE_FLIGHT))
 
@@ -2340,6 +2483,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ActivePredicate.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceStore.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
@@ -2365,10 +2509,73 @@ RUN_ANALYSIS_DEPENDS = \
 	FORM WIDGET \
 	LOOK \
 	SCREEN EVENT RESOURCE ASYNC IO DATA_FIELD \
-	OS THREAD \
-	CONTEST TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
+	OS \
+	CONTEST THREAD TASK ROUTE GLIDE WAYPOINT ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+RUN_BATCH_ANALYSIS_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/NMEA/Aircraft.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Computer/Wind/CirclingWind.cpp \
+	$(SRC)/Computer/Wind/Store.cpp \
+	$(SRC)/Computer/Wind/MeasurementList.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(SRC)/Computer/Wind/WindEKFGlue.cpp \
+	$(SRC)/Units/Settings.cpp \
+	$(SRC)/Formatter/TimeFormatter.cpp \
+	$(SRC)/JSON/Writer.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/Computer/ThermalLocator.cpp \
+	$(SRC)/Computer/ThermalBase.cpp \
+	$(SRC)/Computer/ThermalBandComputer.cpp \
+	$(SRC)/Computer/GlideRatioCalculator.cpp \
+	$(SRC)/Computer/AutoQNH.cpp \
+	$(SRC)/Computer/CirclingComputer.cpp \
+	$(SRC)/Computer/Wind/Computer.cpp \
+	$(SRC)/Computer/Wind/Settings.cpp \
+	$(SRC)/Computer/ContestComputer.cpp \
+	$(SRC)/Computer/TraceComputer.cpp \
+	$(SRC)/Computer/WarningComputer.cpp \
+	$(SRC)/Computer/LiftDatabaseComputer.cpp \
+	$(SRC)/Computer/AverageVarioComputer.cpp \
+	$(SRC)/Computer/GlideRatioComputer.cpp \
+	$(SRC)/Computer/GlideComputer.cpp \
+	$(SRC)/Computer/GlideComputerBlackboard.cpp \
+	$(SRC)/Computer/TaskComputer.cpp \
+	$(SRC)/Computer/RouteComputer.cpp \
+	$(SRC)/Computer/GlideComputerAirData.cpp \
+	$(SRC)/Computer/WaveComputer.cpp \
+	$(SRC)/Computer/StatsComputer.cpp \
+	$(SRC)/Computer/GlideComputerInterface.cpp \
+	$(SRC)/Computer/LogComputer.cpp \
+	$(SRC)/Computer/CuComputer.cpp \
+	$(SRC)/Computer/Settings.cpp \
+	$(SRC)/Audio/Settings.cpp \
+	$(SRC)/Audio/VarioSettings.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Engine/Navigation/TraceHistory.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(TEST_SRC_DIR)/RunBatchAnalysis.cpp
+RUN_BATCH_ANALYSIS_DEPENDS = \
+	TERRAIN \
+	DRIVER \
+	CONTEST TASK ROUTE GLIDE WAYPOINT AIRSPACE ZZIP IO OS THREAD \
+	UTIL GEO MATH TIME
+$(eval $(call link-program,RunBatchAnalysis,RUN_BATCH_ANALYSIS))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
@@ -2576,6 +2783,18 @@ FEED_FLYNET_DATA_DEPENDS = PORT ASYNC LIBNET IO OS THREAD TIME UTIL
 
 $(eval $(call link-program,FeedFlyNetData,FEED_FLYNET_DATA))
 
+FEED_SKYLINES_FIXES_SOURCES = \
+	$(SRC)/net/SocketError.cxx \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(TEST_SRC_DIR)/FeedSkyLinesFixes.cpp
+FEED_SKYLINES_FIXES_DEPENDS = LIBNET IO OS GEO MATH UTIL
+$(eval $(call link-program,FeedSkyLinesFixes,FEED_SKYLINES_FIXES))
+
+BENCHMARK_CLOUD_INDEX_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkCloudIndex.cpp
+BENCHMARK_CLOUD_INDEX_DEPENDS = GEO MATH
+$(eval $(call link-program,BenchmarkCloudIndex,BENCHMARK_CLOUD_INDEX))
+
 TASK_INFO_SOURCES = \
 	$(SRC)/Engine/Util/Gradient.cpp \
 	$(SRC)/Task/Deserialiser.cpp \
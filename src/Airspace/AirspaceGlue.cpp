@@ -23,27 +23,49 @@ Copyright_License {
 
 #include "Airspace/AirspaceGlue.hpp"
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceStore.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "Profile/ProfileKeys.hpp"
 #include "Operation/Operation.hpp"
 #include "Language/Language.hpp"
 #include "LogFile.hpp"
 #include "system/Path.hpp"
+#include "system/FileUtil.hpp"
+#include "util/StringAPI.hxx"
+#include "io/FileCache.hpp"
+#include "io/FileOutputStream.hxx"
 #include "io/FileLineReader.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/ZipLineReader.hpp"
 #include "io/MapFile.hpp"
 #include "Profile/Profile.hpp"
 
+#include <algorithm>
+#include <initializer_list>
+#include <thread>
+
 #include <string.h>
 
+static const TCHAR *const airspace_cache_name = _T("airspace");
+
+/**
+ * The number of threads which may parse one (large) OpenAir file.
+ */
+static unsigned
+GetParserThreads() noexcept
+{
+  constexpr unsigned MAX_PARSER_THREADS = 8;
+  return std::clamp(std::thread::hardware_concurrency(),
+                    1u, MAX_PARSER_THREADS);
+}
+
 static bool
 ParseAirspaceFile(Airspaces &airspaces, Path path,
                   OperationEnvironment &operation)
 try {
   FileLineReader reader(path, Charset::AUTO);
 
-  if (!ParseAirspaceFile(airspaces, reader, operation)) {
+  if (!ParseAirspaceFile(airspaces, reader, operation, GetParserThreads())) {
     LogFormat(_T("Failed to parse airspace file: %s"), path.c_str());
     return false;
   }
@@ -62,7 +84,7 @@ ParseAirspaceFile(Airspaces &airspaces,
 try {
   ZipLineReader reader(dir, path, Charset::AUTO);
 
-  if (!ParseAirspaceFile(airspaces, reader, operation)) {
+  if (!ParseAirspaceFile(airspaces, reader, operation, GetParserThreads())) {
     LogFormat("Failed to parse airspace file: %s", path);
     return false;
   }
@@ -74,8 +96,79 @@ try {
   return false;
 }
 
+/**
+ * Calculate a key which identifies the given set of airspace source
+ * files.  #FileCache only checks the first one; this covers all of
+ * them, including their order.
+ */
+[[gnu::pure]]
+static uint64_t
+CalculateSourceKey(std::initializer_list<Path> paths) noexcept
+{
+  /* FNV-1a */
+  uint64_t key = 0xcbf29ce484222325ULL;
+  const auto update = [&key](const void *data, std::size_t size){
+    for (const auto *p = (const uint8_t *)data, *end = p + size;
+         p != end; ++p) {
+      key ^= *p;
+      key *= 0x100000001b3ULL;
+    }
+  };
+
+  for (const Path path : paths) {
+    if (path == nullptr) {
+      update("", 1);
+      continue;
+    }
+
+    update(path.c_str(), (StringLength(path.c_str()) + 1) * sizeof(TCHAR));
+
+    const uint64_t size = File::GetSize(path);
+    const uint64_t mtime = File::GetLastModification(path);
+    update(&size, sizeof(size));
+    update(&mtime, sizeof(mtime));
+  }
+
+  return key;
+}
+
+static bool
+LoadAirspaceCache(Airspaces &airspaces, FileCache &cache,
+                  Path original_path, uint64_t key) noexcept
+try {
+  const auto path = cache.LoadPath(airspace_cache_name, original_path);
+  if (path == nullptr)
+    return false;
+
+  if (!AirspaceStore::Load(path, key, airspaces)) {
+    LogFormat("Airspace cache does not match");
+    return false;
+  }
+
+  return true;
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load airspace cache");
+  airspaces.Clear();
+
+  /* discard the broken file, it will be rebuilt */
+  cache.Flush(airspace_cache_name);
+  return false;
+}
+
+static void
+SaveAirspaceCache(const Airspaces &airspaces, FileCache &cache,
+                  Path original_path, uint64_t key) noexcept
+try {
+  auto os = cache.Save(airspace_cache_name, original_path);
+  AirspaceStore::Save(*os, os->Tell(), airspaces, key);
+  os->Commit();
+} catch (...) {
+  LogError(std::current_exception(), "Failed to save airspace cache");
+}
+
 void
 ReadAirspace(Airspaces &airspaces,
+             FileCache *cache,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
              OperationEnvironment &operation)
@@ -83,24 +176,54 @@ ReadAirspace(Airspaces &airspaces,
   LogFormat("ReadAirspace");
   operation.SetText(_("Loading Airspace File..."));
 
-  bool airspace_ok = false;
-
   // Read the airspace filenames from the registry
-  auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
-  if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+  const auto path = Profile::GetPath(ProfileKeys::AirspaceFile);
+  const auto additional_path =
+    Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
+  const auto map_path = Profile::GetPath(ProfileKeys::MapFile);
+
+  /* the cache file is keyed on the first configured source file */
+  const Path cache_key_path = path != nullptr
+    ? Path(path)
+    : (additional_path != nullptr ? Path(additional_path) : Path(map_path));
+  if (cache_key_path == nullptr)
+    cache = nullptr;
+
+  bool use_cache = true;
+  Profile::Get(ProfileKeys::AirspaceCache, use_cache);
+  if (cache != nullptr && !use_cache) {
+    cache->Flush(airspace_cache_name);
+    cache = nullptr;
+  }
+
+  const uint64_t key = cache != nullptr
+    ? CalculateSourceKey({path, additional_path, map_path})
+    : 0;
+
+  bool airspace_ok = cache != nullptr &&
+    LoadAirspaceCache(airspaces, *cache, cache_key_path, key);
 
-  path = Profile::GetPath(ProfileKeys::AdditionalAirspaceFile);
-  if (!path.IsNull())
-    airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+  if (!airspace_ok) {
+    if (path != nullptr)
+      airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
 
-  auto archive = OpenMapFile();
-  if (archive)
-    airspace_ok |= ParseAirspaceFile(airspaces, archive->get(), "airspace.txt",
-                                     operation);
+    if (additional_path != nullptr)
+      airspace_ok |= ParseAirspaceFile(airspaces, additional_path, operation);
+
+    auto archive = OpenMapFile();
+    if (archive)
+      airspace_ok |= ParseAirspaceFile(airspaces, archive->get(),
+                                       "airspace.txt", operation);
+
+    if (airspace_ok) {
+      airspaces.Optimise();
+
+      if (cache != nullptr && !airspaces.IsEmpty())
+        SaveAirspaceCache(airspaces, *cache, cache_key_path, key);
+    }
+  }
 
   if (airspace_ok) {
-    airspaces.Optimise();
     airspaces.SetFlightLevels(press);
 
     if (terrain != NULL)
@@ -28,12 +28,17 @@ class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
 class OperationEnvironment;
+class FileCache;
 
 /**
  * Reads the airspace files into the memory
+ *
+ * @param cache if not nullptr, then the parsed airspaces are stored
+ * in (and loaded from) an #AirspaceStore file in this cache
  */
 void
 ReadAirspace(Airspaces &airspaces,
+             FileCache *cache,
              RasterTerrain *terrain,
              const AtmosphericPressure &press,
              OperationEnvironment &operation);
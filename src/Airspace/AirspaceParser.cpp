@@ -39,6 +39,12 @@ Copyright_License {
 #include "Engine/Airspace/AirspaceClass.hpp"
 #include "util/StaticString.hxx"
 #include "util/StringCompare.hxx"
+#include "thread/Thread.hpp"
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <vector>
 
 #include <tchar.h>
 
@@ -144,6 +150,7 @@ struct TempAirspaceType
   Reset()
   {
     days_of_operation.SetAll();
+    name.clear();
     radio = _T("");
     type = OTHER;
     base = top = AirspaceAltitude();
@@ -165,8 +172,9 @@ struct TempAirspaceType
     radius = 0;
   }
 
+  template<typename Database>
   void
-  AddPolygon(Airspaces &airspace_database)
+  AddPolygon(Database &airspace_database)
   {
     if (points.size() < 3)
       return;
@@ -178,8 +186,9 @@ struct TempAirspaceType
     airspace_database.Add(as);
   }
 
+  template<typename Database>
   void
-  AddCircle(Airspaces &airspace_database)
+  AddCircle(Database &airspace_database)
   {
     AbstractAirspace *as = new AirspaceCircle(center, radius);
     as->SetProperties(std::move(name), type, base, top);
@@ -495,8 +504,9 @@ ParseType(const TCHAR *buffer)
   return OTHER;
 }
 
+template<typename Database>
 static bool
-ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
+ParseLine(Database &airspace_database, StringParser<TCHAR> &&input,
           TempAirspaceType &temp_area)
 {
   double d;
@@ -605,8 +615,9 @@ ParseLine(Airspaces &airspace_database, StringParser<TCHAR> &&input,
   return true;
 }
 
+template<typename Database>
 static bool
-ParseLine(Airspaces &airspace_database, TCHAR *line,
+ParseLine(Database &airspace_database, TCHAR *line,
           TempAirspaceType &temp_area)
 {
   // Strip comments
@@ -841,9 +852,189 @@ DetectFileType(const TCHAR *line)
   return AirspaceFileType::UNKNOWN;
 }
 
+/**
+ * Does this OpenAir line begin a new record, i.e. is it an "AC"
+ * line which makes ParseLine() flush the previous airspace and reset
+ * all state?
+ */
+[[gnu::pure]]
+static bool
+IsOpenAirRecordStart(const TCHAR *line)
+{
+  return (line[0] == _T('A') || line[0] == _T('a')) &&
+    (line[1] == _T('C') || line[1] == _T('c')) &&
+    IsWhitespaceNotNull(line[2]);
+}
+
+/**
+ * The non-empty lines of an OpenAir file, loaded into memory.
+ */
+struct OpenAirLines {
+  struct Line {
+    std::size_t offset;
+    unsigned number;
+  };
+
+  std::vector<TCHAR> text;
+  std::vector<Line> lines;
+
+  std::size_t size() const {
+    return lines.size();
+  }
+
+  void Append(const TCHAR *line, unsigned number) {
+    lines.push_back({text.size(), number});
+    text.insert(text.end(), line, line + StringLength(line) + 1);
+  }
+
+  TCHAR *operator[](std::size_t i) {
+    return text.data() + lines[i].offset;
+  }
+};
+
+/**
+ * A range of OpenAir records which is parsed independently of the
+ * others.  It begins with an "AC" line (or the beginning of the file),
+ * which resets all #TempAirspaceType state, so the result is the same
+ * as if the whole file was parsed at once.
+ */
+struct OpenAirChunk {
+  OpenAirLines &file;
+
+  const std::size_t begin, end;
+
+  /**
+   * The index of the line which could not be parsed, or #end.
+   */
+  std::size_t error;
+
+  /**
+   * The airspaces parsed from this chunk (until #error), in file
+   * order.
+   */
+  std::vector<std::unique_ptr<AbstractAirspace>> airspaces;
+
+  OpenAirChunk(OpenAirLines &_file, std::size_t _begin, std::size_t _end)
+    :file(_file), begin(_begin), end(_end), error(_end) {}
+
+  /* this is the "airspace database" of ParseLine() */
+  void Add(AbstractAirspace *as) {
+    airspaces.emplace_back(as);
+  }
+
+  void Parse() noexcept {
+    TempAirspaceType temp_area;
+
+    for (std::size_t i = begin; i < end; ++i) {
+      if (!ParseLine(*this, file[i], temp_area)) {
+        error = i;
+        return;
+      }
+    }
+
+    /* flush the last record; in the serial parser, this happens at
+       the "AC" line beginning the next chunk */
+    temp_area.AddPolygon(*this);
+  }
+};
+
+class OpenAirParserThread final : public Thread {
+  OpenAirChunk &chunk;
+
+public:
+  explicit OpenAirParserThread(OpenAirChunk &_chunk)
+    :Thread("AirspaceParser"), chunk(_chunk) {}
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() noexcept override {
+    chunk.Parse();
+  }
+};
+
+/**
+ * Chunks smaller than this are not worth a thread.
+ */
+static constexpr std::size_t MIN_CHUNK_LINES = 1024;
+
+/**
+ * Parse the rest of an OpenAir file with several threads.  The first
+ * pass loads all lines into memory, and the second one splits them
+ * at record boundaries and parses the chunks in parallel.  The
+ * airspaces are then added to #airspaces in file order, just like
+ * the serial parser does.
+ *
+ * @param line the current (first non-empty) line
+ */
+static bool
+ParseOpenAirParallel(Airspaces &airspaces, TLineReader &reader,
+                     TCHAR *line, unsigned line_num, unsigned n_threads,
+                     OperationEnvironment &operation)
+{
+  const long file_size = reader.GetSize();
+
+  OpenAirLines file;
+
+  do {
+    StripRight(line);
+
+    if (!StringIsEmpty(line))
+      file.Append(line, line_num);
+
+    if ((line_num & 0xff) == 0)
+      operation.SetProgressPosition(reader.Tell() * 1024 / file_size);
+
+    ++line_num;
+  } while ((line = reader.ReadLine()) != nullptr);
+
+  const std::size_t n_lines = file.size();
+  const std::size_t n_chunks =
+    std::clamp<std::size_t>(n_lines / MIN_CHUNK_LINES, 1, n_threads);
+
+  std::list<OpenAirChunk> chunks;
+  for (std::size_t i = 1, begin = 0; begin < n_lines; ++i) {
+    std::size_t end = std::max(begin, n_lines * i / n_chunks);
+    while (end < n_lines && !IsOpenAirRecordStart(file[end]))
+      ++end;
+
+    if (end > begin)
+      chunks.emplace_back(file, begin, end);
+
+    begin = end;
+  }
+
+  std::list<OpenAirParserThread> threads;
+  for (auto i = std::next(chunks.begin()); i != chunks.end(); ++i) {
+    auto &thread = threads.emplace_back(*i);
+    if (!thread.Start()) {
+      /* no more threads; parse it here */
+      threads.pop_back();
+      i->Parse();
+    }
+  }
+
+  /* the calling thread parses the first chunk */
+  chunks.front().Parse();
+
+  for (auto &thread : threads)
+    thread.Join();
+
+  for (auto &chunk : chunks) {
+    for (auto &as : chunk.airspaces)
+      airspaces.Add(as.release());
+
+    if (chunk.error != chunk.end)
+      return ShowParseWarning(file.lines[chunk.error].number,
+                              file[chunk.error], operation);
+  }
+
+  return true;
+}
+
 bool
 ParseAirspaceFile(Airspaces &airspaces,
-                  TLineReader &reader, OperationEnvironment &operation)
+                  TLineReader &reader, OperationEnvironment &operation,
+                  unsigned n_threads)
 {
   bool ignore = false;
 
@@ -869,6 +1060,10 @@ ParseAirspaceFile(Airspaces &airspaces,
       filetype = DetectFileType(line);
       if (filetype == AirspaceFileType::UNKNOWN)
         continue;
+
+      if (filetype == AirspaceFileType::OPENAIR && n_threads > 1)
+        return ParseOpenAirParallel(airspaces, reader, line, line_num,
+                                    n_threads, operation);
     }
 
     // Parse the line
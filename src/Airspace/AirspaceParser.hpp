@@ -28,8 +28,19 @@ class Airspaces;
 class TLineReader;
 class OperationEnvironment;
 
+/**
+ * Parse an OpenAir or TNP file and add its airspaces to the given
+ * database.
+ *
+ * @param n_threads if greater than 1, OpenAir files are loaded into
+ * memory, split at record boundaries and parsed by up to this many
+ * threads; the result is the same as with the serial parser (TNP
+ * files are always parsed serially, because their state carries over
+ * from one record to the next)
+ */
 bool
 ParseAirspaceFile(Airspaces &airspaces,
-                  TLineReader &reader, OperationEnvironment &operation);
+                  TLineReader &reader, OperationEnvironment &operation,
+                  unsigned n_threads=1);
 
 #endif
@@ -0,0 +1,262 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "AirspaceStore.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "system/FileMapping.hpp"
+#include "system/Path.hpp"
+#include "io/BufferedOutputStream.hxx"
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <string.h>
+
+static_assert(std::is_trivially_copyable_v<AirspaceStore::Record>);
+
+namespace AirspaceStore {
+
+static constexpr unsigned ALIGNMENT = 8;
+
+static uint32_t
+AddName(std::basic_string<TCHAR> &names, const tstring &s,
+        uint32_t &length_r) noexcept
+{
+  const uint32_t offset = names.length();
+  names.append(s);
+  length_r = s.length();
+  return offset;
+}
+
+static void
+Pad(BufferedOutputStream &bos, uint64_t &position)
+{
+  static constexpr char zero[ALIGNMENT]{};
+
+  const unsigned remainder = position % ALIGNMENT;
+  if (remainder > 0) {
+    bos.Write(zero, ALIGNMENT - remainder);
+    position += ALIGNMENT - remainder;
+  }
+}
+
+static uint64_t
+Write(BufferedOutputStream &bos, uint64_t &position,
+      const void *data, std::size_t size)
+{
+  Pad(bos, position);
+
+  const uint64_t offset = position;
+  bos.Write(data, size);
+  position += size;
+  return offset;
+}
+
+void
+Save(OutputStream &os, uint64_t position, const Airspaces &airspaces,
+     uint64_t key)
+{
+  std::basic_string<TCHAR> names;
+  std::vector<Point> points;
+  std::vector<Record> records;
+  records.reserve(airspaces.GetSize());
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &as = i.GetAirspace();
+
+    Record record{};
+    record.base = as.GetBase();
+    record.top = as.GetTop();
+    record.shape = uint8_t(as.GetShape());
+    record.type = uint8_t(as.GetType());
+    record.days = as.GetDays();
+
+    if (as.GetShape() == AbstractAirspace::Shape::CIRCLE) {
+      const auto &circle = (const AirspaceCircle &)as;
+      const GeoPoint center = circle.GetCenter();
+      record.longitude = center.longitude.Native();
+      record.latitude = center.latitude.Native();
+      record.radius = circle.GetRadius();
+    }
+
+    record.min_x = i.GetLowerLeft().x;
+    record.min_y = i.GetLowerLeft().y;
+    record.max_x = i.GetUpperRight().x;
+    record.max_y = i.GetUpperRight().y;
+
+    const auto &border = as.GetPoints();
+    record.first_point = points.size();
+    record.n_points = border.size();
+    for (const auto &p : border)
+      points.push_back({
+          p.GetLocation().longitude.Native(),
+          p.GetLocation().latitude.Native(),
+          p.GetFlatLocation().x, p.GetFlatLocation().y,
+        });
+
+    record.name_offset = AddName(names, as.GetName(), record.name_length);
+    record.radio_offset = AddName(names, as.GetRadioText(),
+                                  record.radio_length);
+
+    records.push_back(record);
+  }
+
+  const GeoBounds &bounds = airspaces.GetTaskProjection().GetBounds();
+
+  Trailer trailer{};
+  trailer.magic = MAGIC;
+  trailer.version = VERSION;
+  trailer.n_records = records.size();
+  trailer.n_points = points.size();
+  trailer.key = key;
+  trailer.west = bounds.GetWest().Native();
+  trailer.north = bounds.GetNorth().Native();
+  trailer.east = bounds.GetEast().Native();
+  trailer.south = bounds.GetSouth().Native();
+
+  BufferedOutputStream bos(os);
+
+  trailer.names_size = names.length() * sizeof(TCHAR);
+  trailer.names_offset = Write(bos, position, names.data(),
+                               trailer.names_size);
+  trailer.points_offset = Write(bos, position, points.data(),
+                                points.size() * sizeof(Point));
+  trailer.records_offset = Write(bos, position, records.data(),
+                                 records.size() * sizeof(Record));
+  Write(bos, position, &trailer, sizeof(trailer));
+
+  bos.Flush();
+}
+
+/**
+ * Check whether the given table fits into the file (before the
+ * #Trailer).
+ */
+[[gnu::pure]]
+static bool
+CheckTable(uint64_t offset, uint64_t count, std::size_t element_size,
+           std::size_t end) noexcept
+{
+  return offset % ALIGNMENT == 0 && offset <= end &&
+    count <= (end - offset) / element_size;
+}
+
+static std::unique_ptr<AbstractAirspace>
+MakeAirspace(const Record &record, const Point *points,
+             const TCHAR *names)
+{
+  SearchPointVector border;
+  border.reserve(record.n_points);
+  for (const auto *p = points + record.first_point,
+         *end = p + record.n_points; p != end; ++p)
+    border.emplace_back(GeoPoint(Angle::Native(p->longitude),
+                                 Angle::Native(p->latitude)),
+                        FlatGeoPoint(p->x, p->y));
+
+  std::unique_ptr<AbstractAirspace> as;
+  if (record.shape == uint8_t(AbstractAirspace::Shape::CIRCLE))
+    as = std::make_unique<AirspaceCircle>(GeoPoint(Angle::Native(record.longitude),
+                                                   Angle::Native(record.latitude)),
+                                          record.radius, std::move(border));
+  else
+    as = std::make_unique<AirspacePolygon>(std::move(border));
+
+  as->SetProperties(tstring(names + record.name_offset, record.name_length),
+                    AirspaceClass(record.type), record.base, record.top);
+  as->SetRadio(tstring(names + record.radio_offset, record.radio_length));
+  as->SetDays(record.days);
+  return as;
+}
+
+bool
+Load(Path path, uint64_t key, Airspaces &airspaces)
+{
+  const FileMapping mapping(path);
+
+  const std::size_t size = mapping.size();
+  if (size < sizeof(Trailer))
+    throw std::runtime_error("Airspace store too small");
+
+  Trailer trailer;
+  memcpy(&trailer, mapping.at(size - sizeof(trailer)), sizeof(trailer));
+
+  if (trailer.magic != MAGIC || trailer.version != VERSION)
+    throw std::runtime_error("Wrong airspace store version");
+
+  if (trailer.key != key)
+    return false;
+
+  const std::size_t end = size - sizeof(trailer);
+  if (!CheckTable(trailer.names_offset, trailer.names_size, 1, end) ||
+      trailer.names_size % sizeof(TCHAR) != 0 ||
+      !CheckTable(trailer.points_offset, trailer.n_points,
+                  sizeof(Point), end) ||
+      !CheckTable(trailer.records_offset, trailer.n_records,
+                  sizeof(Record), end))
+    throw std::runtime_error("Malformed airspace store");
+
+  const auto *names = (const TCHAR *)mapping.at(trailer.names_offset);
+  const uint64_t n_names = trailer.names_size / sizeof(TCHAR);
+  const auto *points = (const Point *)mapping.at(trailer.points_offset);
+  const auto *records = (const Record *)mapping.at(trailer.records_offset);
+
+  Airspaces::AirspaceVector items;
+  items.reserve(trailer.n_records);
+
+  try {
+    for (const auto *r = records, *r_end = r + trailer.n_records;
+         r != r_end; ++r) {
+      if (uint64_t(r->first_point) + r->n_points > trailer.n_points ||
+          r->n_points < 3 ||
+          uint64_t(r->name_offset) + r->name_length > n_names ||
+          uint64_t(r->radio_offset) + r->radio_length > n_names ||
+          r->type >= AIRSPACECLASSCOUNT ||
+          r->shape > uint8_t(AbstractAirspace::Shape::POLYGON))
+        throw std::runtime_error("Malformed airspace store");
+
+      auto as = MakeAirspace(*r, points, names);
+      items.emplace_back(*as,
+                         FlatBoundingBox(FlatGeoPoint(r->min_x, r->min_y),
+                                         FlatGeoPoint(r->max_x, r->max_y)));
+      as.release();
+    }
+  } catch (...) {
+    for (auto &i : items)
+      i.Destroy();
+    throw;
+  }
+
+  airspaces.Restore(TaskProjection(GeoBounds(GeoPoint(Angle::Native(trailer.west),
+                                                      Angle::Native(trailer.north)),
+                                             GeoPoint(Angle::Native(trailer.east),
+                                                      Angle::Native(trailer.south)))),
+                    std::move(items));
+  return true;
+}
+
+}
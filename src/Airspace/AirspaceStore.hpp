@@ -0,0 +1,137 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_AIRSPACE_STORE_HPP
+#define XCSOAR_AIRSPACE_STORE_HPP
+
+#include "Engine/Airspace/AirspaceAltitude.hpp"
+#include "Engine/Airspace/AirspaceActivity.hpp"
+
+#include <cstdint>
+
+class Path;
+class OutputStream;
+class Airspaces;
+
+/**
+ * A compiled copy of the airspace database, so startup does not need
+ * to parse the OpenAir/TNP files.  It contains everything
+ * Airspaces::Optimise() has produced: the projection, the projected
+ * borders and the bounding boxes which are used to bulk-load the
+ * search tree.  The file is mapped into memory and decoded without
+ * any text parsing, trigonometry or projection.
+ *
+ * File layout: the names (#TCHAR strings without terminator), the
+ * #Point table, the #Record table and a #Trailer.  All offsets are
+ * relative to the beginning of the file, which allows arbitrary
+ * data (e.g. the #FileCache header) in front of the names.
+ *
+ * The file is only meaningful on the machine which wrote it; there
+ * is no attempt at portability.
+ */
+namespace AirspaceStore {
+
+static constexpr uint32_t MAGIC = 0x53505341;
+static constexpr uint32_t VERSION = 1;
+
+struct Point {
+  double longitude, latitude;
+
+  int32_t x, y;
+};
+
+struct Record {
+  AirspaceAltitude base, top;
+
+  /**
+   * The center and radius of a circle; unused for polygons.
+   */
+  double longitude, latitude, radius;
+
+  /**
+   * The bounding box in the stored projection.
+   */
+  int32_t min_x, min_y, max_x, max_y;
+
+  /**
+   * The border within the #Point table.
+   */
+  uint32_t first_point, n_points;
+
+  /**
+   * Offsets and lengths (in characters) within the name table.
+   */
+  uint32_t name_offset, name_length;
+  uint32_t radio_offset, radio_length;
+
+  uint8_t shape, type;
+
+  AirspaceActivity days;
+
+  uint8_t reserved[5];
+};
+
+struct Trailer {
+  uint32_t magic, version;
+
+  uint32_t n_records, n_points;
+
+  /**
+   * Identifies the source files; see Load().
+   */
+  uint64_t key;
+
+  /**
+   * The bounds of the projection, in radians.
+   */
+  double west, north, east, south;
+
+  uint64_t names_offset, names_size;
+  uint64_t points_offset, records_offset;
+};
+
+/**
+ * Write the (optimised) airspace database.  Throws on error.
+ *
+ * @param os the file which receives the data
+ * @param position the current position within the file, i.e. the
+ * size of the data which has already been written
+ * @param key an arbitrary value identifying the source files
+ */
+void
+Save(OutputStream &os, uint64_t position, const Airspaces &airspaces,
+     uint64_t key);
+
+/**
+ * Load a file written by Save() into an empty #Airspaces container.
+ * Throws on error.
+ *
+ * @return false if the file was written with a different key
+ */
+bool
+Load(Path path, uint64_t key, Airspaces &airspaces);
+
+}
+
+#endif
@@ -51,6 +51,9 @@ DeviceBlackboard::DeviceBlackboard()
 
   real_clock.Reset();
   replay_clock.Reset();
+
+  for (auto &i : startup_location_pending)
+    i.store(false, std::memory_order_relaxed);
 }
 
 /**
@@ -68,9 +71,17 @@ DeviceBlackboard::SetStartupLocation(const GeoPoint &loc, const double alt)
   if (Calculated().flight.flying)
     return;
 
-  for (unsigned i = 0; i < unsigned(NUMDEV); ++i)
+  /* the devices' I/O threads will apply this to their own copies,
+     see ApplyPendingChanges() */
+  startup_location = loc;
+  startup_altitude = alt;
+
+  for (unsigned i = 0; i < unsigned(NUMDEV); ++i) {
+    startup_location_pending[i].store(true, std::memory_order_relaxed);
+
     if (!per_device_data[i].location_available)
       per_device_data[i].SetFakeLocation(loc, alt);
+  }
 
   if (!real_data.location_available)
     real_data.SetFakeLocation(loc, alt);
@@ -230,6 +241,9 @@ DeviceBlackboard::Merge()
 
   real_data.Reset();
   for (unsigned i = 0; i < unsigned(NUMDEV); ++i) {
+    if (staged_device_data[i].Consume())
+      per_device_data[i] = staged_device_data[i].GetFront();
+
     if (!per_device_data[i].alive)
       continue;
 
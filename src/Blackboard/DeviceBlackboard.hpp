@@ -29,8 +29,10 @@ Copyright_License {
 #include "Device/Simulator.hpp"
 #include "Device/Features.hpp"
 #include "thread/Mutex.hxx"
+#include "thread/TripleBuffer.hpp"
 #include "time/WrapClock.hpp"
 
+#include <atomic>
 #include <cassert>
 
 class MultipleDevices;
@@ -59,6 +61,28 @@ class DeviceBlackboard
    */
   NMEAInfo per_device_data[NUMDEV];
 
+  /**
+   * Snapshots of #per_device_data staged by the devices' I/O threads
+   * with StageDeviceData(), without holding the #mutex.  Merge()
+   * copies the latest one to #per_device_data.
+   */
+  TripleBuffer<NMEAInfo> staged_device_data[NUMDEV];
+
+  /**
+   * The location passed to SetStartupLocation().  Protected by
+   * #mutex.
+   */
+  GeoPoint startup_location;
+  double startup_altitude;
+
+  /**
+   * Set by SetStartupLocation() for each device, and cleared by
+   * ApplyPendingChanges() after it has applied #startup_location to
+   * the copy owned by the device's I/O thread.  Only modified while
+   * #mutex is locked.
+   */
+  std::atomic<bool> startup_location_pending[NUMDEV];
+
   /**
    * Merged data from the physical devices.
    */
@@ -109,6 +133,61 @@ public:
     return per_device_data[i];
   }
 
+  /**
+   * Reset a device's data, and discard the snapshot staged by
+   * StageDeviceData() if Merge() has not picked it up yet.  Caller
+   * must lock the blackboard, and the device's I/O thread must not
+   * be running.
+   */
+  NMEAInfo &ResetRealState(unsigned i) noexcept {
+    assert(i < NUMDEV);
+
+    staged_device_data[i].Consume();
+    startup_location_pending[i].store(false, std::memory_order_relaxed);
+    per_device_data[i].Reset();
+    return per_device_data[i];
+  }
+
+  /**
+   * Stage a new copy of a device's data, and schedule the
+   * MergeThread, which will replace #per_device_data with it.  This
+   * does not lock the mutex.  For each device, this may only be
+   * called by one thread at a time (the one which parses the device's
+   * input), and the caller must own the only authoritative copy of
+   * the device's data; modifications of #per_device_data by other
+   * threads will be overwritten, unless they are forwarded with
+   * ApplyPendingChanges().
+   */
+  void StageDeviceData(unsigned i, const NMEAInfo &src) noexcept {
+    assert(i < NUMDEV);
+
+    auto &staged = staged_device_data[i];
+    staged.GetBack() = src;
+    staged.Publish();
+
+    ScheduleMerge();
+  }
+
+  /**
+   * Apply modifications made by other threads since the last call
+   * (i.e. SetStartupLocation()) to the copy of a device's data which
+   * is owned by its I/O thread.  Call this before parsing into that
+   * copy, so the following StageDeviceData() call does not revert
+   * them.  This locks the mutex only if there is something to do.
+   */
+  void ApplyPendingChanges(unsigned i, NMEAInfo &data) noexcept {
+    assert(i < NUMDEV);
+
+    if (!startup_location_pending[i].load(std::memory_order_relaxed))
+      return;
+
+    const std::lock_guard<Mutex> lock(mutex);
+    startup_location_pending[i].store(false, std::memory_order_relaxed);
+
+    if (!data.location_available)
+      data.SetFakeLocation(startup_location, startup_altitude);
+  }
+
   /**
    * Return a copy of a device's data after updating its clock via
    * NMEAInfo::UpdateClock().  The method takes care for locking and
@@ -0,0 +1,147 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "AccessLog.hpp"
+#include "system/Error.hxx"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+#include "util/StringAPI.hxx"
+
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Lines are written at least this often.
+ */
+static constexpr std::chrono::steady_clock::duration FLUSH_INTERVAL =
+  std::chrono::seconds(1);
+
+/**
+ * Wake up the thread early if the buffer grows larger than this.
+ */
+static constexpr std::size_t FLUSH_THRESHOLD = 64 * 1024;
+
+/**
+ * Discard new lines if the buffer grows larger than this.
+ */
+static constexpr std::size_t MAX_BUFFER = 16 * 1024 * 1024;
+
+AccessLog::AccessLog(Path path)
+  :Thread("access_log")
+{
+  if (StringIsEqual(path.c_str(), "-")) {
+    fd = UniqueFileDescriptor(dup(STDOUT_FILENO));
+    if (!fd.IsDefined())
+      throw MakeErrno("Failed to duplicate stdout");
+  } else if (!fd.Open(path.c_str(), O_WRONLY|O_APPEND|O_CREAT))
+    throw FormatErrno("Failed to open %s", path.c_str());
+}
+
+void
+AccessLog::Start()
+{
+  if (!Thread::Start())
+    throw std::runtime_error("Failed to start access log thread");
+}
+
+void
+AccessLog::Stop() noexcept
+{
+  if (!IsDefined())
+    return;
+
+  {
+    const std::lock_guard<Mutex> lock(mutex);
+    should_stop = true;
+  }
+
+  cond.notify_one();
+  Join();
+}
+
+void
+AccessLog::Append(std::string_view line) noexcept
+{
+  bool wake;
+
+  {
+    const std::lock_guard<Mutex> lock(mutex);
+
+    const std::size_t size = buffer.size();
+    if (size + line.size() >= MAX_BUFFER) {
+      ++dropped;
+      return;
+    }
+
+    try {
+      buffer.append(line);
+      buffer.push_back('\n');
+    } catch (const std::bad_alloc &) {
+      /* don't leave a line without its newline behind */
+      buffer.resize(size);
+      ++dropped;
+      return;
+    }
+
+    wake = buffer.size() >= FLUSH_THRESHOLD && size < FLUSH_THRESHOLD;
+  }
+
+  if (wake)
+    cond.notify_one();
+}
+
+void
+AccessLog::Run() noexcept
+{
+  std::string chunk;
+
+  std::unique_lock<Mutex> lock(mutex);
+
+  while (true) {
+    if (!should_stop && buffer.size() < FLUSH_THRESHOLD)
+      cond.wait_for(lock, FLUSH_INTERVAL);
+
+    /* swap buffers, so the next chunk can reuse the allocation */
+    chunk.clear();
+    chunk.swap(buffer);
+
+    const bool stop = should_stop;
+
+    lock.unlock();
+
+    if (!chunk.empty()) {
+      try {
+        fd.FullWrite(chunk.data(), chunk.size());
+      } catch (...) {
+        PrintException(std::current_exception());
+      }
+    }
+
+    if (stop)
+      break;
+
+    lock.lock();
+  }
+}
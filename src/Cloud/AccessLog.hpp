@@ -0,0 +1,108 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_ACCESS_LOG_HPP
+#define XCSOAR_CLOUD_ACCESS_LOG_HPP
+
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+#include "io/UniqueFileDescriptor.hxx"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+class Path;
+
+/**
+ * A log file for per-packet events.  Lines are collected in memory
+ * and written by a separate thread once per second (or earlier if
+ * the buffer grows large), so the receive threads never wait for
+ * I/O.  If the disk cannot keep up, new lines are discarded.
+ */
+class AccessLog final : Thread {
+  UniqueFileDescriptor fd;
+
+  mutable Mutex mutex;
+  Cond cond;
+
+  /**
+   * Lines which have not yet been written.  Protected by #mutex.
+   */
+  std::string buffer;
+
+  /**
+   * The number of lines which were discarded because the buffer was
+   * full or out of memory.  Protected by #mutex.
+   */
+  uint64_t dropped = 0;
+
+  bool should_stop = false;
+
+public:
+  /**
+   * Open the log file for appending.  The special path "-" means
+   * stdout.  Throws on error.
+   */
+  explicit AccessLog(Path path);
+
+  ~AccessLog() noexcept {
+    Stop();
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start();
+
+  /**
+   * Write all pending lines and stop the thread.
+   */
+  void Stop() noexcept;
+
+  /**
+   * Append one line (without the trailing newline).  This method is
+   * thread-safe.  If the buffer is full or memory cannot be
+   * allocated, the line is discarded and counted (see GetDropped()).
+   */
+  void Append(std::string_view line) noexcept;
+
+  [[gnu::pure]]
+  std::size_t GetBufferedSize() const noexcept {
+    const std::lock_guard<Mutex> lock(mutex);
+    return buffer.size();
+  }
+
+  [[gnu::pure]]
+  uint64_t GetDropped() const noexcept {
+    const std::lock_guard<Mutex> lock(mutex);
+    return dropped;
+  }
+
+private:
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
+
+#endif
@@ -23,15 +23,9 @@ Copyright_License {
 
 #include "Client.hpp"
 #include "Serialiser.hpp"
-#include "Geo/Boost/RangeBox.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "Tracking/SkyLines/Assemble.hpp"
 #include "Tracking/SkyLines/Import.hpp"
-#include "net/AddressInfo.hxx"
-#include "net/Resolver.hxx"
-
-#include <boost/geometry/algorithms/intersection.hpp>
-#include <boost/geometry/strategies/strategies.hpp>
 
 CloudClientContainer::CloudClientContainer()
   :key_set(typename KeySet::bucket_traits(key_buckets, N_KEY_BUCKETS)) {}
@@ -66,8 +60,9 @@ CloudClientContainer::Make(SocketAddress address,
   auto result = key_set.insert_check(key, key_set.hash_function(),
                                      key_set.key_eq(), hint);
   if (result.second) {
-    auto client = std::make_shared<CloudClient>(address, key, next_id++,
+    auto client = std::make_shared<CloudClient>(address, key, next_id,
                                                 location, altitude);
+    next_id += id_step;
     Insert(*client);
     return *client;
   } else {
@@ -96,9 +91,9 @@ CloudClientContainer::Refresh(CloudClient &client,
 
   if (location != client.location) {
     auto ptr = client.shared_from_this();
-    rtree.remove(ptr);
+    index.remove(ptr);
     client.location = location;
-    rtree.insert(ptr);
+    index.insert(ptr);
   }
 
   client.altitude = altitude;
@@ -110,7 +105,7 @@ CloudClientContainer::Insert(CloudClient &client)
   list.push_front(client);
   key_set.insert(client);
   id_set.push_back(client);
-  rtree.insert(client.shared_from_this());
+  index.insert(client.shared_from_this());
 }
 
 void
@@ -119,7 +114,7 @@ CloudClientContainer::Remove(CloudClient &client)
   list.erase(list.iterator_to(client));
   key_set.erase(key_set.iterator_to(client));
   id_set.erase(id_set.iterator_to(client));
-  rtree.remove(client.shared_from_this());
+  index.remove(client.shared_from_this());
 }
 
 void
@@ -129,39 +124,22 @@ CloudClientContainer::Expire(std::chrono::steady_clock::time_point before)
     Remove(list.back());
 }
 
-CloudClientContainer::query_iterator_range
-CloudClientContainer::QueryWithinRange(GeoPoint location, double range) const
+CloudClientPtr
+CloudClientContainer::PopOldest() noexcept
 {
-  const auto q = boost::geometry::index::intersects(BoostRangeBox(location, range));
-  return {rtree.qbegin(q), rtree.qend()};
-}
+  if (list.empty())
+    return nullptr;
 
-inline Serialiser &
-operator<<(Serialiser &s, SocketAddress address)
-{
-  char host[NI_MAXHOST], serv[NI_MAXSERV];
-  int ret = getnameinfo(address.GetAddress(), address.GetSize(),
-                        host, sizeof(host), serv, sizeof(serv),
-                        NI_NUMERICHOST|NI_NUMERICSERV);
-  s.WriteString(ret == 0 ? host : "unkown");
-  s.Write16(address.GetPort());
-  return s;
+  auto &client = list.back();
+  auto ptr = client.shared_from_this();
+  Remove(client);
+  return ptr;
 }
 
-inline Deserialiser &
-operator>>(Deserialiser &s, AllocatedSocketAddress &address)
+CloudClientContainer::query_iterator_range
+CloudClientContainer::QueryWithinRange(GeoPoint location, double range) const
 {
-  static constexpr auto hints =
-    MakeAddrInfo(AI_NUMERICHOST, AF_UNSPEC, SOCK_DGRAM);
-
-  const auto node = s.ReadString();
-  char service[32];
-  snprintf(service, sizeof(service), "%u", s.Read16());
-
-  const auto ai = Resolve(node.c_str(), service, &hints);
-  address = ai.front();
-
-  return s;
+  return index.QueryWithinRange(location, range);
 }
 
 void
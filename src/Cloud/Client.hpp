@@ -24,14 +24,12 @@ Copyright_License {
 #ifndef XCSOAR_CLOUD_CLIENT_HPP
 #define XCSOAR_CLOUD_CLIENT_HPP
 
-#include "Geo/Boost/GeoPoint.hpp"
+#include "GridIndex.hpp"
 #include "net/AllocatedSocketAddress.hxx"
 
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/set.hpp>
 #include <boost/intrusive/unordered_set.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/range/iterator_range_core.hpp>
 
 #include <memory>
 #include <chrono>
@@ -46,7 +44,8 @@ struct CloudClient
   : std::enable_shared_from_this<CloudClient>,
     boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
     boost::intrusive::set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
-    boost::intrusive::unordered_set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
+    boost::intrusive::unordered_set_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
+    GeoGridHook
 {
   /**
    * Last known IP address.
@@ -96,6 +95,13 @@ struct CloudClient
    */
   int altitude;
 
+  /**
+   * Has this client submitted a new location which has not yet been
+   * distributed to its neighbours?  If yes, then it is listed in
+   * CloudShard::dirty_traffic.
+   */
+  bool traffic_dirty = false;
+
   struct KeyHash {
     constexpr std::size_t operator()(uint64_t key) const {
       return key;
@@ -151,7 +157,7 @@ struct CloudClient
 using CloudClientPtr = std::shared_ptr<CloudClient>;
 
 /**
- * Helper for boost::geometry::index::rtree.
+ * Helper for #GeoGridIndex and #GeoRTreeIndex.
  */
 struct CloudClientIndexable {
   typedef GeoPoint result_type;
@@ -163,8 +169,11 @@ struct CloudClientIndexable {
 };
 
 class CloudClientContainer {
-  typedef boost::geometry::index::rtree<CloudClientPtr, boost::geometry::index::rstar<16>,
-                                        CloudClientIndexable> Tree;
+  /**
+   * The geospatial index implementation.  #GeoRTreeIndex may be
+   * used instead; it is slower for objects which move a lot.
+   */
+  using Index = GeoGridIndex<CloudClient, CloudClientIndexable>;
 
   typedef boost::intrusive::list<CloudClient,
                                  boost::intrusive::constant_time_size<false>> List;
@@ -182,7 +191,7 @@ class CloudClientContainer {
    * A geospatial container of all clients, for fast geographic
    * lookups.
    */
-  Tree rtree;
+  Index index;
 
   /**
    * A linked list of clients, sorted by last fix, with fresh items at
@@ -205,6 +214,12 @@ class CloudClientContainer {
    */
   unsigned next_id = 1;
 
+  /**
+   * The increment for #next_id.  This is larger than one if several
+   * containers (shards) share the public id space.
+   */
+  unsigned id_step = 1;
+
   static constexpr size_t N_KEY_BUCKETS = 65521;
   typename KeySet::bucket_type key_buckets[N_KEY_BUCKETS];
 
@@ -218,6 +233,10 @@ public:
     return list.empty();
   }
 
+  std::size_t size() const noexcept {
+    return index.size();
+  }
+
   /**
    * For iteration over the list of all clients in unspecified order.
    * The iterators get invalidated by all modifying calls.
@@ -230,6 +249,20 @@ public:
     return list.end();
   }
 
+  unsigned GetNextId() const noexcept {
+    return next_id;
+  }
+
+  /**
+   * Configure how public ids are assigned to new clients.  Each
+   * container of a sharded database gets its own residue class, so
+   * ids remain unique across all shards.
+   */
+  void SetIdSequence(unsigned _next_id, unsigned _id_step) noexcept {
+    next_id = _next_id;
+    id_step = _id_step;
+  }
+
   /**
    * Look up a client by its secret key.  Note that this does not
    * increment the reference counter.
@@ -260,8 +293,16 @@ public:
 
   void Expire(std::chrono::steady_clock::time_point before);
 
-  typedef Tree::const_query_iterator query_iterator;
-  typedef boost::iterator_range<query_iterator> query_iterator_range;
+  /**
+   * Remove the client which has not been refreshed for the longest
+   * time and return it.  Returns nullptr if the container is empty.
+   * Inserting the returned clients into another container preserves
+   * their order.
+   */
+  CloudClientPtr PopOldest() noexcept;
+
+  typedef Index::const_query_iterator query_iterator;
+  typedef Index::const_query_range query_iterator_range;
 
   [[gnu::pure]]
   query_iterator_range QueryWithinRange(GeoPoint location, double range) const;
@@ -31,6 +31,9 @@ class Serialiser;
 class Deserialiser;
 
 struct CloudData {
+  static constexpr uint32_t MAGIC = 0x5753f60f;
+  static constexpr uint32_t VERSION = 1;
+
   CloudClientContainer clients;
   CloudThermalContainer thermals;
 
@@ -0,0 +1,348 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_GRID_INDEX_HPP
+#define XCSOAR_CLOUD_GRID_INDEX_HPP
+
+#include "Geo/GeoPoint.hpp"
+#include "Geo/FAISphere.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Base class for objects which can be stored in a #GeoGridIndex.
+ */
+struct GeoGridHook {
+  /**
+   * The position of this object in its #GeoGridIndex cell.  Only
+   * used by #GeoGridIndex.
+   */
+  std::size_t geo_grid_slot;
+};
+
+/**
+ * A geospatial index which divides the earth into cells of equal
+ * angular size.  Unlike an R-tree, inserting and removing an object
+ * is O(1), which makes this a good choice for many objects which move
+ * all the time (e.g. live traffic), queried with a range which is
+ * similar to the cell size.
+ *
+ * The interface is compatible with #GeoRTreeIndex.
+ *
+ * @param T the object type; must derive from #GeoGridHook
+ * @param Indexable a function object which returns the #GeoPoint of
+ * a std::shared_ptr<T>
+ */
+template<typename T, typename Indexable>
+class GeoGridIndex {
+public:
+  using value_type = std::shared_ptr<T>;
+
+private:
+  using Cell = std::vector<value_type>;
+
+  /**
+   * The cell size in radians.
+   */
+  double cell_size;
+
+  unsigned n_columns, n_rows;
+
+  /**
+   * Only cells which contain objects are allocated.
+   */
+  std::unordered_map<uint32_t, Cell> cells;
+
+  std::size_t n_objects = 0;
+
+  Indexable indexable;
+
+public:
+  /**
+   * @param _cell_size the size of each cell; should be similar to
+   * the range of typical queries
+   */
+  explicit GeoGridIndex(Angle _cell_size=Angle::Degrees(0.25)) noexcept
+    :cell_size(_cell_size.Radians()),
+     n_columns(std::ceil(2 * M_PI / cell_size)),
+     n_rows(std::ceil(M_PI / cell_size)) {}
+
+  std::size_t size() const noexcept {
+    return n_objects;
+  }
+
+  bool empty() const noexcept {
+    return n_objects == 0;
+  }
+
+  void clear() noexcept {
+    cells.clear();
+    n_objects = 0;
+  }
+
+  void insert(const value_type &value) {
+    Cell &cell = cells[GetCellKey(indexable(value))];
+    value->geo_grid_slot = cell.size();
+    cell.push_back(value);
+    ++n_objects;
+  }
+
+  /**
+   * Remove an object.  Its location must not have been modified
+   * since it was inserted.
+   */
+  void remove(const value_type &value) noexcept {
+    auto i = cells.find(GetCellKey(indexable(value)));
+    assert(i != cells.end());
+
+    Cell &cell = i->second;
+    const std::size_t slot = value->geo_grid_slot;
+    assert(slot < cell.size());
+    assert(cell[slot] == value);
+
+    /* move the last object of this cell into the gap */
+    if (slot + 1 < cell.size()) {
+      cell[slot] = std::move(cell.back());
+      cell[slot]->geo_grid_slot = slot;
+    }
+
+    cell.pop_back();
+    if (cell.empty())
+      cells.erase(i);
+
+    --n_objects;
+  }
+
+  /**
+   * A "box" in radians.  If #west is larger than #east, it crosses
+   * the antimeridian.
+   */
+  struct Box {
+    double west, east, south, north;
+
+    [[gnu::pure]]
+    bool Contains(const GeoPoint &p) const noexcept {
+      const double latitude = p.latitude.Native();
+      if (latitude < south || latitude > north)
+        return false;
+
+      const double longitude = p.longitude.Native();
+      return west <= east
+        ? longitude >= west && longitude <= east
+        : longitude >= west || longitude <= east;
+    }
+  };
+
+  /**
+   * Iterates over all objects within a #Box.
+   */
+  class const_query_iterator {
+    friend class GeoGridIndex;
+
+    const GeoGridIndex *grid = nullptr;
+
+    Box box;
+
+    unsigned row, end_row;
+    unsigned first_column, column, remaining_columns, n_query_columns;
+
+    const Cell *cell = nullptr;
+    std::size_t position;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = GeoGridIndex::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+
+    /**
+     * Construct the "end" iterator.
+     */
+    const_query_iterator() noexcept = default;
+
+    reference operator*() const noexcept {
+      return (*cell)[position];
+    }
+
+    pointer operator->() const noexcept {
+      return &(*cell)[position];
+    }
+
+    const_query_iterator &operator++() noexcept {
+      ++position;
+      Skip();
+      return *this;
+    }
+
+    bool operator==(const const_query_iterator &other) const noexcept {
+      return grid == other.grid && cell == other.cell &&
+        (cell == nullptr || position == other.position);
+    }
+
+    bool operator!=(const const_query_iterator &other) const noexcept {
+      return !(*this == other);
+    }
+
+  private:
+    const_query_iterator(const GeoGridIndex &_grid, const Box &_box) noexcept
+      :grid(&_grid), box(_box),
+       row(grid->GetRow(box.south)), end_row(grid->GetRow(box.north) + 1),
+       first_column(grid->GetColumn(box.west))
+    {
+      const unsigned last_column = grid->GetColumn(box.east);
+      n_query_columns = box.west <= box.east
+        ? last_column - first_column + 1
+        : last_column + grid->n_columns - first_column + 1;
+      n_query_columns = std::min(n_query_columns, grid->n_columns);
+
+      StartRow();
+      position = 0;
+      Skip();
+    }
+
+    void StartRow() noexcept {
+      column = first_column;
+      remaining_columns = n_query_columns;
+      LoadCell();
+    }
+
+    void LoadCell() noexcept {
+      auto i = grid->cells.find(row * grid->n_columns + column);
+      cell = i != grid->cells.end() ? &i->second : nullptr;
+    }
+
+    /**
+     * Advance to the next cell.  Returns false if there are no
+     * more cells.
+     */
+    bool NextCell() noexcept {
+      if (--remaining_columns > 0) {
+        if (++column == grid->n_columns)
+          column = 0;
+        LoadCell();
+        return true;
+      }
+
+      if (++row < end_row) {
+        StartRow();
+        return true;
+      }
+
+      /* this is now the "end" iterator */
+      grid = nullptr;
+      cell = nullptr;
+      return false;
+    }
+
+    /**
+     * Skip objects which are not inside the box, and empty cells.
+     */
+    void Skip() noexcept {
+      while (true) {
+        if (cell != nullptr) {
+          for (; position < cell->size(); ++position)
+            if (box.Contains(grid->indexable((*cell)[position])))
+              return;
+        }
+
+        if (!NextCell())
+          return;
+
+        position = 0;
+      }
+    }
+  };
+
+  struct const_query_range {
+    const_query_iterator first;
+
+    const_query_iterator begin() const noexcept {
+      return first;
+    }
+
+    const_query_iterator end() const noexcept {
+      return {};
+    }
+  };
+
+  [[gnu::pure]]
+  const_query_range QueryWithinRange(GeoPoint location,
+                                     double range) const noexcept {
+    return {const_query_iterator(*this, MakeRangeBox(location, range))};
+  }
+
+private:
+  [[gnu::pure]]
+  unsigned GetRow(double latitude) const noexcept {
+    const int row = (latitude + M_PI_2) / cell_size;
+    return std::clamp(row, 0, int(n_rows) - 1);
+  }
+
+  [[gnu::pure]]
+  unsigned GetColumn(double longitude) const noexcept {
+    const int column = (longitude + M_PI) / cell_size;
+    return std::clamp(column, 0, int(n_columns) - 1);
+  }
+
+  [[gnu::pure]]
+  uint32_t GetCellKey(const GeoPoint &p) const noexcept {
+    return GetRow(p.latitude.Native()) * n_columns
+      + GetColumn(p.longitude.Native());
+  }
+
+  /**
+   * Like BoostRangeBox(), but if the range includes a pole, the box
+   * covers all longitudes.
+   */
+  [[gnu::const]]
+  static Box MakeRangeBox(const GeoPoint location, double range) noexcept {
+    const Angle latitude_delta = FAISphere::EarthDistanceToAngle(range);
+
+    const Angle north = std::min(location.latitude + latitude_delta,
+                                 Angle::QuarterCircle());
+    const Angle south = std::max(location.latitude - latitude_delta,
+                                 -Angle::QuarterCircle());
+
+    if (north == Angle::QuarterCircle() || south == -Angle::QuarterCircle())
+      return {-M_PI, M_PI, south.Native(), north.Native()};
+
+    const auto c = std::max(location.latitude.cos(), 0.01);
+    const Angle longitude_delta = std::min(latitude_delta / c,
+                                           Angle::QuarterCircle());
+
+    const Angle west = (location.longitude - longitude_delta).AsDelta();
+    const Angle east = (location.longitude + longitude_delta).AsDelta();
+
+    return {west.Native(), east.Native(), south.Native(), north.Native()};
+  }
+};
+
+#endif
@@ -0,0 +1,416 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Journal.hpp"
+#include "Shard.hpp"
+#include "Serialiser.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/FileReader.hxx"
+#include "system/Error.hxx"
+#include "system/FileUtil.hpp"
+#include "util/PrintException.hxx"
+
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static constexpr uint32_t JOURNAL_MAGIC = 0x5753f610;
+static constexpr uint32_t JOURNAL_VERSION = 1;
+
+enum class JournalRecordType : uint8_t {
+  FIX = 1,
+  THERMAL = 2,
+  EXPIRE = 3,
+};
+
+/**
+ * Records which were written less than this long ago may be lost in
+ * a crash.
+ */
+static constexpr std::chrono::steady_clock::duration SYNC_INTERVAL =
+  std::chrono::seconds(1);
+
+static constexpr std::chrono::steady_clock::duration COMPACTION_INTERVAL =
+  std::chrono::minutes(10);
+
+/**
+ * Thermals submitted by the same client within this period and this
+ * distance are considered duplicates while replaying the journal.
+ * This is necessary because time stamps are stored in seconds.
+ */
+static constexpr std::chrono::steady_clock::duration THERMAL_TIME_TOLERANCE =
+  std::chrono::seconds(2);
+static constexpr double THERMAL_DISTANCE_TOLERANCE = 100;
+
+/**
+ * Collects all data in memory, so it can be written with one
+ * system call, and without holding a lock.
+ */
+class MemoryOutputStream final : public OutputStream {
+  std::vector<std::byte> buffer;
+
+public:
+  const std::byte *data() const noexcept {
+    return buffer.data();
+  }
+
+  std::size_t size() const noexcept {
+    return buffer.size();
+  }
+
+  /* virtual methods from class OutputStream */
+  void Write(const void *data, size_t size) override {
+    const auto *p = (const std::byte *)data;
+    buffer.insert(buffer.end(), p, p + size);
+  }
+};
+
+CloudJournal::CloudJournal(ShardedCloudData &_data, Path _db_path)
+  :Thread("journal"),
+   data(_data),
+   db_path(_db_path),
+   journal_path(_db_path + ".journal"),
+   old_journal_path(_db_path + ".journal.old")
+{
+}
+
+static void
+ReplayFix(CloudData &data, CloudClient &&record)
+{
+  auto &clients = data.clients;
+
+  auto *client = clients.Find(record.key);
+  if (client == nullptr) {
+    auto ptr = std::make_shared<CloudClient>(std::move(record));
+    clients.Insert(*ptr);
+
+    if (ptr->id >= clients.GetNextId())
+      clients.SetIdSequence(ptr->id + 1, 1);
+  } else if (record.stamp >= client->stamp) {
+    clients.Refresh(*client, record.address,
+                    record.location, record.altitude);
+    client->stamp = record.stamp;
+  } else {
+    /* the snapshot is newer than this record */
+  }
+}
+
+static void
+ReplayThermal(CloudData &data, CloudThermal &&record)
+{
+  for (const auto &i : data.thermals.QueryWithinRange(record.top_location,
+                                                      THERMAL_DISTANCE_TOLERANCE)) {
+    if (i->client_key == record.client_key &&
+        i->time < record.time + THERMAL_TIME_TOLERANCE &&
+        record.time < i->time + THERMAL_TIME_TOLERANCE)
+      /* already contained in the snapshot */
+      return;
+  }
+
+  auto ptr = std::make_shared<CloudThermal>(std::move(record));
+  data.thermals.Insert(*ptr);
+}
+
+/**
+ * Is there more data to be read?
+ */
+static bool
+HasMore(Deserialiser &s)
+{
+  return !s.Read().empty() || s.Fill(true);
+}
+
+static void
+ReplayJournal(Path path, CloudData &data)
+{
+  FileReader r(path);
+  Deserialiser s(r);
+
+  if (!HasMore(s))
+    /* empty file; we crashed before the header was written */
+    return;
+
+  if (s.Read32() != JOURNAL_MAGIC)
+    throw std::runtime_error("Bad journal magic");
+
+  if (s.Read32() != JOURNAL_VERSION)
+    throw std::runtime_error("Bad journal version");
+
+  unsigned n = 0;
+
+  try {
+    while (HasMore(s)) {
+      switch (JournalRecordType(s.Read8())) {
+      case JournalRecordType::FIX:
+        ReplayFix(data, CloudClient::Load(s));
+        break;
+
+      case JournalRecordType::THERMAL:
+        ReplayThermal(data, CloudThermal::Load(s));
+        break;
+
+      case JournalRecordType::EXPIRE:
+        {
+          std::chrono::steady_clock::time_point before;
+          s >> before;
+          data.clients.Expire(before);
+        }
+        break;
+
+      default:
+        throw std::runtime_error("Malformed journal record");
+      }
+
+      ++n;
+    }
+  } catch (const std::runtime_error &e) {
+    /* the last record was probably not written completely because
+       we crashed; everything before it is still usable */
+    std::ostringstream line;
+    line << "Journal " << path.c_str() << " truncated after "
+         << n << " records: " << e.what();
+    std::cerr << line.str() << std::endl;
+  }
+}
+
+void
+CloudJournal::Load(CloudData &dest) const
+{
+  if (File::Exists(db_path)) {
+    FileReader r(db_path);
+    Deserialiser s(r);
+    dest.Load(s);
+  }
+
+  /* the old journal may be left over from a compaction which did
+     not finish */
+  if (File::Exists(old_journal_path))
+    ReplayJournal(old_journal_path, dest);
+
+  if (File::Exists(journal_path))
+    ReplayJournal(journal_path, dest);
+}
+
+void
+CloudJournal::WriteSnapshot()
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  /* serialise into memory first, so the shard locks are not held
+     during disk I/O */
+  MemoryOutputStream buffer;
+
+  {
+    Serialiser s(buffer);
+    data.Save(s);
+    s.Flush();
+  }
+
+  FileOutputStream fos(db_path);
+  fos.Write(buffer.data(), buffer.size());
+  fos.Commit();
+
+  const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  std::ostringstream line;
+  line << "Saved " << buffer.size() << " bytes to " << db_path.c_str()
+       << " in " << duration.count() << "ms";
+  std::cout << line.str() << std::endl;
+}
+
+void
+CloudJournal::Compact()
+{
+  assert(!IsDefined());
+  assert(!fd.IsDefined());
+
+  WriteSnapshot();
+
+  File::Delete(old_journal_path);
+  File::Delete(journal_path);
+}
+
+void
+CloudJournal::OpenJournal()
+{
+  if (!fd.Open(journal_path.c_str(), O_WRONLY|O_APPEND|O_CREAT))
+    throw FormatErrno("Failed to open %s", journal_path.c_str());
+
+  if (fd.GetSize() == 0) {
+    MemoryOutputStream buffer;
+
+    {
+      Serialiser s(buffer);
+      s.Write32(JOURNAL_MAGIC);
+      s.Write32(JOURNAL_VERSION);
+      s.Flush();
+    }
+
+    fd.FullWrite(buffer.data(), buffer.size());
+  }
+}
+
+void
+CloudJournal::Start()
+{
+  assert(!IsDefined());
+
+  OpenJournal();
+
+  should_stop = false;
+  next_compaction = std::chrono::steady_clock::now() + COMPACTION_INTERVAL;
+
+  if (!Thread::Start())
+    throw std::runtime_error("Failed to start journal thread");
+}
+
+void
+CloudJournal::Stop() noexcept
+{
+  if (!IsDefined())
+    return;
+
+  {
+    const std::lock_guard<Mutex> lock(mutex);
+    should_stop = true;
+  }
+
+  cond.notify_one();
+  Join();
+
+  fd.Close();
+}
+
+void
+CloudJournal::RequestCompaction() noexcept
+{
+  {
+    const std::lock_guard<Mutex> lock(mutex);
+    compact_requested = true;
+  }
+
+  cond.notify_one();
+}
+
+void
+CloudJournal::Write(const std::vector<Record> &records)
+{
+  if (records.empty())
+    return;
+
+  MemoryOutputStream buffer;
+
+  {
+    Serialiser s(buffer);
+
+    for (const auto &record : records) {
+      if (const auto *client = std::get_if<CloudClient>(&record)) {
+        s.Write8(uint8_t(JournalRecordType::FIX));
+        client->Save(s);
+      } else if (const auto *thermal = std::get_if<CloudThermal>(&record)) {
+        s.Write8(uint8_t(JournalRecordType::THERMAL));
+        thermal->Save(s);
+      } else if (const auto *expire = std::get_if<Expire>(&record)) {
+        s.Write8(uint8_t(JournalRecordType::EXPIRE));
+        s << expire->before;
+      }
+    }
+
+    s.Flush();
+  }
+
+  fd.FullWrite(buffer.data(), buffer.size());
+
+  if (fdatasync(fd.Get()) < 0)
+    throw FormatErrno("Failed to sync %s", journal_path.c_str());
+}
+
+void
+CloudJournal::RotateAndCompact()
+{
+  /* if the old journal still exists, the previous compaction has
+     failed; its records are not yet in the snapshot, so keep it
+     and keep appending to the current journal */
+  if (!File::Exists(old_journal_path)) {
+    if (!File::Rename(journal_path, old_journal_path))
+      throw FormatErrno("Failed to rename %s", journal_path.c_str());
+
+    fd.Close();
+    OpenJournal();
+  }
+
+  /* all records queued from now on go to the new journal; all
+     modifications recorded in the old journal happened before this
+     point and are therefore contained in the snapshot */
+  WriteSnapshot();
+
+  File::Delete(old_journal_path);
+}
+
+void
+CloudJournal::Run() noexcept
+{
+  std::unique_lock<Mutex> lock(mutex);
+
+  while (true) {
+    if (!should_stop && !compact_requested)
+      cond.wait_for(lock, SYNC_INTERVAL);
+
+    const auto records = std::move(queue);
+    queue.clear();
+
+    const bool stop = should_stop;
+    bool compact = compact_requested;
+    compact_requested = false;
+
+    lock.unlock();
+
+    try {
+      Write(records);
+    } catch (...) {
+      PrintException(std::current_exception());
+    }
+
+    if (stop)
+      break;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_compaction)
+      compact = true;
+
+    if (compact) {
+      next_compaction = now + COMPACTION_INTERVAL;
+
+      try {
+        RotateAndCompact();
+      } catch (...) {
+        PrintException(std::current_exception());
+      }
+    }
+
+    lock.lock();
+  }
+}
@@ -0,0 +1,181 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_JOURNAL_HPP
+#define XCSOAR_CLOUD_JOURNAL_HPP
+
+#include "Client.hpp"
+#include "Thermal.hpp"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+#include "io/UniqueFileDescriptor.hxx"
+#include "system/Path.hpp"
+
+#include <chrono>
+#include <variant>
+#include <vector>
+
+struct CloudData;
+class ShardedCloudData;
+
+/**
+ * An append-only log of all modifications to the cloud database.
+ * It is written by a separate thread, so disk I/O never blocks the
+ * receive threads; the buffered records are flushed and synced to
+ * disk once per second.
+ *
+ * Periodically, the thread writes a new snapshot of the whole
+ * database and discards the journal which is covered by it
+ * ("compaction").  To restore the database, load the snapshot and
+ * replay the journal files; replaying is idempotent, so records
+ * which are already contained in the snapshot do no harm.
+ *
+ * Files: "DB" is the snapshot, "DB.journal" the current journal and
+ * "DB.journal.old" the journal which is being compacted.
+ */
+class CloudJournal final : Thread {
+  /**
+   * Marks a call to CloudClientContainer::Expire().
+   */
+  struct Expire {
+    std::chrono::steady_clock::time_point before;
+  };
+
+  using Record = std::variant<CloudClient, CloudThermal, Expire>;
+
+  ShardedCloudData &data;
+
+  const AllocatedPath db_path, journal_path, old_journal_path;
+
+  mutable Mutex mutex;
+  Cond cond;
+
+  /**
+   * Records which have not yet been written.  Protected by #mutex.
+   */
+  std::vector<Record> queue;
+
+  /**
+   * Protected by #mutex.
+   */
+  bool compact_requested = false, should_stop = false;
+
+  /**
+   * The current journal file.  Only used by the journal thread.
+   */
+  UniqueFileDescriptor fd;
+
+  std::chrono::steady_clock::time_point next_compaction;
+
+public:
+  CloudJournal(ShardedCloudData &_data, Path _db_path);
+
+  ~CloudJournal() noexcept {
+    Stop();
+  }
+
+  /**
+   * Load the snapshot and replay the journals into the given
+   * (empty) #CloudData.  Throws on error; a truncated journal (after
+   * a crash) is not an error.
+   */
+  void Load(CloudData &dest) const;
+
+  /**
+   * Write a snapshot and delete all journal files.  Must not be
+   * called while the thread is running.  Throws on error.
+   */
+  void Compact();
+
+  /**
+   * Open the journal file and start the thread.  Throws on error.
+   */
+  void Start();
+
+  /**
+   * Write all pending records and stop the thread.
+   */
+  void Stop() noexcept;
+
+  /* the following methods may be called from any thread; the caller
+     must hold the mutex of the #CloudShard which was modified, to
+     ensure that snapshots and journal records are ordered
+     correctly */
+
+  /**
+   * Record a new fix.
+   */
+  void AppendFix(const CloudClient &client) noexcept {
+    Append(client);
+  }
+
+  void AppendThermal(const CloudThermal &thermal) noexcept {
+    Append(thermal);
+  }
+
+  void AppendExpire(std::chrono::steady_clock::time_point before) noexcept {
+    Append(Expire{before});
+  }
+
+  /**
+   * Ask the thread to write a new snapshot as soon as possible.
+   */
+  void RequestCompaction() noexcept;
+
+  /**
+   * Returns the number of records which have not yet been written.
+   */
+  [[gnu::pure]]
+  std::size_t GetQueueSize() const noexcept {
+    const std::lock_guard<Mutex> lock(mutex);
+    return queue.size();
+  }
+
+private:
+  template<typename T>
+  void Append(T &&record) noexcept {
+    const std::lock_guard<Mutex> lock(mutex);
+    queue.emplace_back(std::forward<T>(record));
+  }
+
+  void OpenJournal();
+
+  /**
+   * Write the given records to the journal file and sync it.
+   */
+  void Write(const std::vector<Record> &records);
+
+  /**
+   * Rename the current journal to #old_journal_path and write a new
+   * snapshot.
+   */
+  void RotateAndCompact();
+
+  void WriteSnapshot();
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
+
+#endif
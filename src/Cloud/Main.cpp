@@ -21,10 +21,13 @@ Copyright_License {
 }
 */
 
-#include "Data.hpp"
+#include "Shard.hpp"
+#include "Journal.hpp"
+#include "Metrics.hpp"
+#include "AccessLog.hpp"
+#include "TrafficFanout.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
-#include "Serialiser.hpp"
 #include "Tracking/SkyLines/Server.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "util/ByteOrder.hxx"
@@ -32,44 +35,224 @@ Copyright_License {
 #include "event/CoarseTimerEvent.hxx"
 #include "event/SignalMonitor.hxx"
 #include "net/IPv4Address.hxx"
+#include "net/StaticSocketAddress.hxx"
 #include "io/FileOutputStream.hxx"
-#include "io/FileReader.hxx"
+#include "system/Args.hpp"
+#include "thread/Thread.hpp"
 #include "util/PrintException.hxx"
 #include "util/Exception.hxx"
 #include "util/Compiler.h"
 #include "util/ScopeExit.hxx"
+#include "util/StringCompare.hxx"
 
 #include <array>
+#include <list>
+#include <vector>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 // TODO: review these settings
 static constexpr double TRAFFIC_RANGE = 50000;
 static constexpr double THERMAL_RANGE = 50000;
 
+/**
+ * The maximum number of records sent in response to one traffic or
+ * thermal request.
+ */
+static constexpr std::size_t MAX_TRAFFIC_RESPONSE = 64;
+static constexpr std::size_t MAX_THERMAL_RESPONSE = 256;
+
 static constexpr std::chrono::steady_clock::duration MAX_TRAFFIC_AGE = std::chrono::minutes(15);
 static constexpr std::chrono::steady_clock::duration MAX_THERMAL_AGE = std::chrono::minutes(30);
 
 static constexpr std::chrono::steady_clock::duration REQUEST_EXPIRY = std::chrono::minutes(5);
 
+static constexpr std::chrono::steady_clock::duration STATISTICS_INTERVAL = std::chrono::seconds(10);
+
+static constexpr std::chrono::steady_clock::duration METRICS_INTERVAL = std::chrono::seconds(10);
+
 using std::cout;
 using std::cerr;
 using std::endl;
 
-class CloudServer final
-  : public SkyLinesTracking::Server, CloudData
+/**
+ * Write one line to stdout with a single call, so lines logged by
+ * different receive threads do not get mixed up.
+ */
+static void
+LogLine(const std::ostringstream &line) noexcept
 {
+  cout << line.str() << endl;
+}
+
+class CloudServer;
+
+/**
+ * A receive socket of the #CloudServer.  It forwards all packets to
+ * the #CloudServer and is used to send the responses.
+ */
+class CloudListener final : public SkyLinesTracking::Server {
+  CloudServer &cloud;
+
+public:
+  CloudListener(CloudServer &_cloud, EventLoop &event_loop,
+                SocketAddress bind_address, bool reuse_port)
+    :SkyLinesTracking::Server(event_loop, bind_address, reuse_port),
+     cloud(_cloud) {}
+
+protected:
+  /* virtual methods from class SkyLinesTracking::Server */
+  void OnFix(const Client &client,
+             std::chrono::milliseconds time_of_day,
+             const ::GeoPoint &location, int altitude) override;
+
+  void OnTrafficRequest(const Client &client,
+                        bool near) override;
+
+  void OnWaveSubmit(const Client &client,
+                    std::chrono::milliseconds time_of_day,
+                    const ::GeoPoint &a, const ::GeoPoint &b,
+                    int bottom_altitude,
+                    int top_altitude,
+                    double lift) override;
+
+  void OnThermalSubmit(const Client &client,
+                       std::chrono::milliseconds time_of_day,
+                       const ::GeoPoint &bottom_location,
+                       int bottom_altitude,
+                       const ::GeoPoint &top_location,
+                       int top_altitude,
+                       double lift) override;
+
+  void OnThermalRequest(const Client &client) override;
+
+  void OnSendError(SocketAddress address,
+                   std::exception_ptr e) noexcept override {
+    std::ostringstream line;
+    line << "Failed to send to " << address
+         << ": " << GetFullMessage(e);
+    cerr << line.str() << endl;
+  }
+
+  void OnError(std::exception_ptr e) override;
+};
+
+/**
+ * A thread which runs its own #EventLoop with one #CloudListener.
+ * All of them bind to the same port with SO_REUSEPORT, and the
+ * kernel distributes the datagrams.
+ */
+class CloudListenerThread final : Thread {
+  EventLoop event_loop{ThreadId::Null()};
+  CloudListener listener;
+
+public:
+  CloudListenerThread(CloudServer &cloud, SocketAddress bind_address)
+    :Thread("listener"),
+     listener(cloud, event_loop, bind_address, true) {}
+
+  CloudListener &GetListener() noexcept {
+    return listener;
+  }
+
+  const CloudListener &GetListener() const noexcept {
+    return listener;
+  }
+
+  /**
+   * Throws on error.
+   */
+  void Start() {
+    event_loop.SetAlive(true);
+    if (!Thread::Start())
+      throw std::runtime_error("Failed to start listener thread");
+  }
+
+  void Stop() noexcept {
+    event_loop.Break();
+    Join();
+
+    /* the listener will be destructed in the main thread */
+    event_loop.SetAlive(false);
+  }
+
+private:
+  /* virtual methods from class Thread */
+  void Run() noexcept override {
+    event_loop.Run();
+  }
+};
+
+class CloudServer final {
+  EventLoop &event_loop;
+
   const AllocatedPath db_path;
 
-  CoarseTimerEvent save_timer, expire_timer;
+  ShardedCloudData data;
+
+  /**
+   * All modifications are logged here, and it writes snapshots
+   * periodically.
+   */
+  CloudJournal journal;
+
+  CoarseTimerEvent expire_timer, statistics_timer, metrics_timer;
+
+  /**
+   * Handler latencies.
+   */
+  struct {
+    LatencyHistogram fix, traffic_request, wave_submit;
+    LatencyHistogram thermal_submit, thermal_request;
+  } latency;
+
+  /**
+   * The file which receives the metrics, or nullptr if disabled.
+   */
+  AllocatedPath metrics_path = nullptr;
+
+  /**
+   * Per-packet events are logged here (optional).
+   */
+  std::unique_ptr<AccessLog> access_log;
+
+  /**
+   * The I/O counters at the time of the last statistics report.
+   */
+  SkyLinesTracking::Server::Statistics last_statistics;
+
+  /**
+   * The listener which runs in the main #EventLoop (only in
+   * single-threaded mode).
+   */
+  std::unique_ptr<CloudListener> listener;
+
+  std::list<CloudListenerThread> threads;
+
+  /**
+   * Sends the coalesced traffic updates through the first listener.
+   */
+  std::unique_ptr<TrafficFanout> fanout;
+
+  /**
+   * A client which shall receive a copy of a new submission.
+   */
+  struct Recipient {
+    StaticSocketAddress address;
+    uint64_t key;
+  };
 
 public:
-  CloudServer(AllocatedPath &&_db_path, EventLoop &event_loop,
-              SocketAddress bind_address)
-    :SkyLinesTracking::Server(event_loop, bind_address),
+  CloudServer(AllocatedPath &&_db_path, EventLoop &_event_loop,
+              unsigned n_shards)
+    :event_loop(_event_loop),
      db_path(std::move(_db_path)),
-     save_timer(event_loop, BIND_THIS_METHOD(OnSaveTimer)),
-     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
+     data(n_shards),
+     journal(data, db_path),
+     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer)),
+     statistics_timer(event_loop, BIND_THIS_METHOD(OnStatisticsTimer)),
+     metrics_timer(event_loop, BIND_THIS_METHOD(OnMetricsTimer))
   {
 #ifndef _WIN32
     SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
@@ -80,202 +263,558 @@ public:
     SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
 #endif
 
-    ScheduleSave();
+    ScheduleExpire();
   }
 
+  ~CloudServer() noexcept {
+    Stop();
+  }
+
+  /**
+   * Load the snapshot and replay the journal.  Throws on error.
+   */
   void Load();
+
+  /**
+   * Write a new snapshot and discard the journal.  Must not be
+   * called while the server is running.  Throws on error.
+   */
   void Save();
 
-private:
-  void OnSaveTimer() noexcept {
-    Save();
-    ScheduleSave();
+  /**
+   * Start the journal and open the receive sockets.  With
+   * n_threads>1, each of them gets its own thread.  Throws on error.
+   *
+   * @param batched use recvmmsg()/sendmmsg() where available
+   */
+  void Start(SocketAddress bind_address, unsigned n_threads,
+             bool batched);
+
+  /**
+   * Print I/O statistics periodically.
+   */
+  void EnableStatistics() noexcept {
+    last_statistics = GetStatistics();
+    ScheduleStatistics();
   }
 
-  void ScheduleSave() {
-    save_timer.Schedule(std::chrono::minutes(1));
+  /**
+   * Write metrics in the Prometheus text format to the given file
+   * periodically (e.g. for the node_exporter "textfile" collector).
+   */
+  void EnableMetrics(Path path) noexcept {
+    metrics_path = path;
+    ScheduleMetrics();
   }
 
-  void OnExpireTimer() noexcept {
-    clients.Expire(GetEventLoop().SteadyNow() - std::chrono::minutes(10));
-    if (!clients.empty())
-      ScheduleExpire();
+  /**
+   * Log per-packet events to the given file.  Throws on error.
+   */
+  void EnableAccessLog(Path path) {
+    access_log = std::make_unique<AccessLog>(path);
+    access_log->Start();
   }
 
-  void ScheduleExpire() {
-    expire_timer.Schedule(std::chrono::minutes(5));
-  }
+  /**
+   * Stop all listener threads and the journal.
+   */
+  void Stop() noexcept;
 
-protected:
-  /* virtual methods from class SkyLinesTracking::Server */
-  void OnFix(const Client &client,
+  /* these methods may be called from any listener thread */
+
+  void OnFix(SkyLinesTracking::Server &server,
+             const SkyLinesTracking::Server::Client &client,
              std::chrono::milliseconds time_of_day,
-             const ::GeoPoint &location, int altitude) override;
+             const ::GeoPoint &location, int altitude);
 
-  void OnTrafficRequest(const Client &client,
-                        bool near) override;
+  void OnTrafficRequest(SkyLinesTracking::Server &server,
+                        const SkyLinesTracking::Server::Client &client,
+                        bool near);
 
-  void OnWaveSubmit(const Client &client,
+  void OnWaveSubmit(const SkyLinesTracking::Server::Client &client,
                     std::chrono::milliseconds time_of_day,
                     const ::GeoPoint &a, const ::GeoPoint &b,
                     int bottom_altitude,
                     int top_altitude,
-                    double lift) override;
+                    double lift);
 
-  void OnThermalSubmit(const Client &client,
+  void OnThermalSubmit(SkyLinesTracking::Server &server,
+                       const SkyLinesTracking::Server::Client &client,
                        std::chrono::milliseconds time_of_day,
                        const ::GeoPoint &bottom_location,
                        int bottom_altitude,
                        const ::GeoPoint &top_location,
                        int top_altitude,
-                       double lift) override;
+                       double lift);
 
-  void OnThermalRequest(const Client &client) override;
+  void OnThermalRequest(SkyLinesTracking::Server &server,
+                        const SkyLinesTracking::Server::Client &client);
 
-  void OnSendError(SocketAddress address,
-                   std::exception_ptr e) noexcept override {
-    cerr << "Failed to send to " << address
-         << ": " << GetFullMessage(e)
-         << endl;
+  void OnListenerError(std::exception_ptr e) noexcept {
+    cerr << GetFullMessage(e) << endl;
+    event_loop.Break();
   }
 
-  void OnError(std::exception_ptr e) override {
-    cerr << GetFullMessage(e) << endl;
-    GetEventLoop().Break();
+private:
+  /**
+   * Collect all clients (from all shards) near the given location
+   * which have requested data until after the given time stamp.
+   * The client which has submitted the data is skipped - it knows
+   * it already.
+   */
+  std::vector<Recipient> FindRecipients(uint64_t except_key,
+                                        ::GeoPoint location, double range,
+                                        std::chrono::steady_clock::time_point CloudClient::*wants,
+                                        std::chrono::steady_clock::time_point now);
+
+  void OnExpireTimer() noexcept {
+    const auto before = event_loop.SteadyNow() - std::chrono::minutes(10);
+    data.ForEachLocked([before](CloudData &d){
+      d.clients.Expire(before);
+    });
+
+    journal.AppendExpire(before);
+
+    ScheduleExpire();
+  }
+
+  void ScheduleExpire() {
+    expire_timer.Schedule(std::chrono::minutes(5));
+  }
+
+  /**
+   * Sum up the I/O counters of all listeners.
+   */
+  SkyLinesTracking::Server::Statistics GetStatistics() const noexcept;
+
+  void OnStatisticsTimer() noexcept;
+
+  void ScheduleStatistics() noexcept {
+    statistics_timer.Schedule(STATISTICS_INTERVAL);
+  }
+
+  void WriteMetrics(std::ostream &os) const;
+
+  void OnMetricsTimer() noexcept;
+
+  void ScheduleMetrics() noexcept {
+    metrics_timer.Schedule(METRICS_INTERVAL);
   }
 
 #ifndef _WIN32
   void OnQuitSignal() noexcept {
-    GetEventLoop().Break();
+    event_loop.Break();
   }
 
   void OnReloadSignal() noexcept {
-    Save();
+    journal.RequestCompaction();
   }
 
   void OnDumpSignal() noexcept {
-    DumpClients();
+    data.DumpClients();
   }
 #endif
 };
 
 void
-CloudServer::OnFix(const Client &c,
+CloudListener::OnFix(const Client &client,
+                     std::chrono::milliseconds time_of_day,
+                     const ::GeoPoint &location, int altitude)
+{
+  cloud.OnFix(*this, client, time_of_day, location, altitude);
+}
+
+void
+CloudListener::OnTrafficRequest(const Client &client, bool near)
+{
+  cloud.OnTrafficRequest(*this, client, near);
+}
+
+void
+CloudListener::OnWaveSubmit(const Client &client,
+                            std::chrono::milliseconds time_of_day,
+                            const ::GeoPoint &a, const ::GeoPoint &b,
+                            int bottom_altitude,
+                            int top_altitude,
+                            double lift)
+{
+  cloud.OnWaveSubmit(client, time_of_day, a, b,
+                     bottom_altitude, top_altitude, lift);
+}
+
+void
+CloudListener::OnThermalSubmit(const Client &client,
+                               std::chrono::milliseconds time_of_day,
+                               const ::GeoPoint &bottom_location,
+                               int bottom_altitude,
+                               const ::GeoPoint &top_location,
+                               int top_altitude,
+                               double lift)
+{
+  cloud.OnThermalSubmit(*this, client, time_of_day,
+                        bottom_location, bottom_altitude,
+                        top_location, top_altitude, lift);
+}
+
+void
+CloudListener::OnThermalRequest(const Client &client)
+{
+  cloud.OnThermalRequest(*this, client);
+}
+
+void
+CloudListener::OnError(std::exception_ptr e)
+{
+  cloud.OnListenerError(e);
+}
+
+void
+CloudServer::Start(SocketAddress bind_address, unsigned n_threads,
+                   bool batched)
+{
+  assert(n_threads > 0);
+  assert(listener == nullptr);
+  assert(threads.empty());
+
+  journal.Start();
+
+  if (n_threads == 1) {
+    listener = std::make_unique<CloudListener>(*this, event_loop,
+                                               bind_address, false);
+    listener->SetBatched(batched);
+    fanout = std::make_unique<TrafficFanout>(data, *listener,
+                                             TRAFFIC_RANGE);
+    fanout->Start();
+    return;
+  }
+
+  for (unsigned i = 0; i < n_threads; ++i) {
+    auto &thread = threads.emplace_back(*this, bind_address);
+    thread.GetListener().SetBatched(batched);
+
+    if (i == 0) {
+      fanout = std::make_unique<TrafficFanout>(data, thread.GetListener(),
+                                               TRAFFIC_RANGE);
+      fanout->Start();
+    }
+
+    thread.Start();
+  }
+}
+
+void
+CloudServer::Stop() noexcept
+{
+  for (auto &i : threads)
+    i.Stop();
+
+  fanout.reset();
+  threads.clear();
+  listener.reset();
+
+  journal.Stop();
+
+  if (access_log)
+    access_log->Stop();
+}
+
+SkyLinesTracking::Server::Statistics
+CloudServer::GetStatistics() const noexcept
+{
+  SkyLinesTracking::Server::Statistics result;
+
+  if (listener)
+    result += listener->GetStatistics();
+
+  for (const auto &i : threads)
+    result += i.GetListener().GetStatistics();
+
+  return result;
+}
+
+/**
+ * Divide, returning 0 if the divisor is 0.
+ */
+static constexpr double
+SafeRatio(uint64_t a, uint64_t b) noexcept
+{
+  return b > 0 ? double(a) / double(b) : 0.;
+}
+
+void
+CloudServer::OnStatisticsTimer() noexcept
+{
+  const auto s = GetStatistics();
+  const auto &l = last_statistics;
+
+  const double seconds =
+    std::chrono::duration_cast<std::chrono::duration<double>>(STATISTICS_INTERVAL).count();
+
+  const uint64_t rx = s.received_packets - l.received_packets;
+  const uint64_t rx_calls = s.receive_calls - l.receive_calls;
+  const uint64_t tx = s.sent_packets - l.sent_packets;
+  const uint64_t tx_calls = s.send_calls - l.send_calls;
+
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(2)
+       << "STATS\t"
+       << "rx " << rx / seconds << " packets/s, "
+       << SafeRatio(rx_calls, rx) << " syscalls/packet\t"
+       << "tx " << tx / seconds << " packets/s, "
+       << SafeRatio(tx_calls, tx) << " syscalls/packet";
+  LogLine(line);
+
+  last_statistics = s;
+  ScheduleStatistics();
+}
+
+void
+CloudServer::WriteMetrics(std::ostream &os) const
+{
+  const auto s = GetStatistics();
+
+  WriteMetric(os, "xcsoar_cloud_received_packets_total", "counter",
+              "Number of datagrams received.", s.received_packets);
+  WriteMetric(os, "xcsoar_cloud_receive_calls_total", "counter",
+              "Number of receive system calls.", s.receive_calls);
+  WriteMetric(os, "xcsoar_cloud_sent_packets_total", "counter",
+              "Number of datagrams sent.", s.sent_packets);
+  WriteMetric(os, "xcsoar_cloud_send_calls_total", "counter",
+              "Number of send system calls.", s.send_calls);
+
+  std::size_t n_clients = 0, n_thermals = 0, n_dirty = 0;
+  for (unsigned i = 0; i < data.size(); ++i) {
+    const auto &shard = data[i];
+    const std::lock_guard<Mutex> lock(shard.mutex);
+    n_clients += shard.data.clients.size();
+    n_thermals += shard.data.thermals.size();
+    n_dirty += shard.dirty_traffic.size();
+  }
+
+  WriteMetric(os, "xcsoar_cloud_clients", "gauge",
+              "Number of clients in the geospatial index.", n_clients);
+  WriteMetric(os, "xcsoar_cloud_thermals", "gauge",
+              "Number of thermals in the geospatial index.", n_thermals);
+  WriteMetric(os, "xcsoar_cloud_traffic_queue", "gauge",
+              "Number of fixes waiting for the traffic fan-out.", n_dirty);
+  WriteMetric(os, "xcsoar_cloud_journal_queue", "gauge",
+              "Number of journal records not yet written.",
+              journal.GetQueueSize());
+
+  if (access_log) {
+    WriteMetric(os, "xcsoar_cloud_access_log_buffer_bytes", "gauge",
+                "Size of the access log data not yet written.",
+                access_log->GetBufferedSize());
+    WriteMetric(os, "xcsoar_cloud_access_log_dropped_total", "counter",
+                "Number of access log lines discarded.",
+                access_log->GetDropped());
+  }
+
+  static constexpr const char *latency_name =
+    "xcsoar_cloud_handler_duration_seconds";
+  os << "# HELP " << latency_name << " Time spent in packet handlers.\n"
+     << "# TYPE " << latency_name << " histogram\n";
+  latency.fix.Write(os, latency_name, "handler=\"fix\"");
+  latency.traffic_request.Write(os, latency_name,
+                                "handler=\"traffic_request\"");
+  latency.wave_submit.Write(os, latency_name, "handler=\"wave_submit\"");
+  latency.thermal_submit.Write(os, latency_name,
+                               "handler=\"thermal_submit\"");
+  latency.thermal_request.Write(os, latency_name,
+                                "handler=\"thermal_request\"");
+}
+
+void
+CloudServer::OnMetricsTimer() noexcept
+{
+  ScheduleMetrics();
+
+  try {
+    std::ostringstream os;
+    WriteMetrics(os);
+    const auto text = os.str();
+
+    /* replace the file atomically, so readers never see a partial
+       file */
+    FileOutputStream fos(metrics_path);
+    fos.Write(text.data(), text.size());
+    fos.Commit();
+  } catch (...) {
+    PrintException(std::current_exception());
+  }
+}
+
+std::vector<CloudServer::Recipient>
+CloudServer::FindRecipients(uint64_t except_key,
+                            ::GeoPoint location, double range,
+                            std::chrono::steady_clock::time_point CloudClient::*wants,
+                            std::chrono::steady_clock::time_point now)
+{
+  std::vector<Recipient> result;
+
+  data.ForEachLocked([&](const CloudData &d){
+    for (const auto &i : d.clients.QueryWithinRange(location, range)) {
+      if (i->key == except_key)
+        continue;
+
+      if (now > (*i).*wants)
+        /* not interested (anymore) */
+        continue;
+
+      auto &r = result.emplace_back();
+      r.address = i->address;
+      r.key = i->key;
+    }
+  });
+
+  return result;
+}
+
+void
+CloudServer::OnFix(SkyLinesTracking::Server &,
+                   const SkyLinesTracking::Server::Client &c,
                    std::chrono::milliseconds time_of_day,
                    const ::GeoPoint &location, int altitude)
 {
   (void)time_of_day; // TODO: use this parameter
 
-  CloudClient *client;
-  if (location.IsValid()) {
-    bool was_empty = clients.empty();
+  const ScopeLatency measure(latency.fix);
 
-    client = &clients.Make(c.address, c.key, location, altitude);
+  auto &shard = data.GetShard(c.key);
+  const std::lock_guard<Mutex> lock(shard.mutex);
+  auto &clients = shard.data.clients;
 
-    cout << "FIX\t"
-         << client->address << '\t'
-         << std::hex << client->key << std::dec << '\t'
-         << client->id << '\t'
-         << client->location << '\t'
-         << client->altitude << 'm'
-         << endl;
-
-    if (was_empty)
-      ScheduleExpire();
-  } else {
-    client = clients.Find(c.key);
+  if (!location.IsValid()) {
+    auto *client = clients.Find(c.key);
     if (client != nullptr)
       clients.Refresh(*client, c.address);
+    return;
   }
 
-  /* send this new traffic location to all interested clients
-     immediately */
-  const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(location, TRAFFIC_RANGE)) {
-    if (i->key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
-
-    if (now > i->wants_traffic)
-      /* not interested (anymore) */
-      continue;
-
-    TrafficResponseSender s(*this, i->address, i->key);
-    s.Add(client->id, 0, //TODO: time?
-          client->location, client->altitude);
-    s.Flush();
+  auto &client = clients.Make(c.address, c.key, location, altitude);
+
+  if (access_log) {
+    std::ostringstream line;
+    line << "FIX\t"
+         << client.address << '\t'
+         << std::hex << client.key << std::dec << '\t'
+         << client.id << '\t'
+         << client.location << '\t'
+         << client.altitude << 'm';
+    access_log->Append(line.str());
   }
+
+  journal.AppendFix(client);
+
+  /* the new traffic location will be sent to all interested clients
+     by the TrafficFanout on its next tick */
+  shard.MarkTrafficDirty(client);
 }
 
 void
-CloudServer::OnTrafficRequest(const Client &c, bool near)
+CloudServer::OnTrafficRequest(SkyLinesTracking::Server &server,
+                              const SkyLinesTracking::Server::Client &c,
+                              bool near)
 {
+  const ScopeLatency measure(latency.traffic_request);
+
   if (!near)
     /* "near" is the only selection flag we know */
     return;
 
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
-    /* we don't send our data to clients who didn't sent anything to
-       us yet */
-    return;
-
   const auto now = std::chrono::steady_clock::now();
 
-  client->wants_traffic = now + REQUEST_EXPIRY;
+  ::GeoPoint location;
+
+  {
+    auto &shard = data.GetShard(c.key);
+    const std::lock_guard<Mutex> lock(shard.mutex);
+
+    auto *client = shard.data.clients.Find(c.key);
+    if (client == nullptr)
+      /* we don't send our data to clients who didn't sent anything to
+         us yet */
+      return;
+
+    client->wants_traffic = now + REQUEST_EXPIRY;
+    location = client->location;
+  }
 
   const auto min_stamp = now - MAX_TRAFFIC_AGE;
 
-  TrafficResponseSender s(*this, c.address, c.key);
+  struct Traffic {
+    unsigned id;
+    ::GeoPoint location;
+    int altitude;
+  };
 
-  unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  /* collect the matches first and send them after all shard locks
+     have been released */
+  std::vector<Traffic> result;
 
-    if (traffic->stamp < min_stamp)
-      /* don't send stale traffic, it's probably not there anymore */
-      continue;
+  data.ForEachLocked([&](const CloudData &d){
+    if (result.size() >= MAX_TRAFFIC_RESPONSE)
+      return;
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
+    for (const auto &traffic : d.clients.QueryWithinRange(location,
+                                                          TRAFFIC_RANGE)) {
+      if (traffic->key == c.key)
+        continue;
 
-    if (++n > 64)
-      break;
-  }
+      if (traffic->stamp < min_stamp)
+        /* don't send stale traffic, it's probably not there anymore */
+        continue;
+
+      result.push_back({traffic->id, traffic->location, traffic->altitude});
+      if (result.size() >= MAX_TRAFFIC_RESPONSE)
+        break;
+    }
+  });
+
+  TrafficResponseSender s(server, c.address, c.key);
+  for (const auto &i : result)
+    s.Add(i.id, 0, //TODO: time?
+          i.location, i.altitude);
 
   s.Flush();
 }
 
 void
-CloudServer::OnWaveSubmit(const Client &c,
+CloudServer::OnWaveSubmit(const SkyLinesTracking::Server::Client &c,
                           std::chrono::milliseconds time_of_day,
                           const ::GeoPoint &a, const ::GeoPoint &b,
                           int bottom_altitude,
                           int top_altitude,
                           double lift)
 {
-  auto *client = clients.Find(c.key);
+  const ScopeLatency measure(latency.wave_submit);
+
+  auto &shard = data.GetShard(c.key);
+  const std::lock_guard<Mutex> lock(shard.mutex);
+
+  auto *client = shard.data.clients.Find(c.key);
   if (client == nullptr)
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "WAVE\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << a << '\t'
-       << b << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+  if (access_log) {
+    std::ostringstream line;
+    line << "WAVE\t"
+         << client->address << '\t'
+         << std::hex << client->key << std::dec << '\t'
+         << client->id << '\t'
+         << a << '\t'
+         << b << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s";
+    access_log->Append(line.str());
+  }
 }
 
 void
-CloudServer::OnThermalSubmit(const Client &c,
+CloudServer::OnThermalSubmit(SkyLinesTracking::Server &server,
+                             const SkyLinesTracking::Server::Client &c,
                              std::chrono::milliseconds time_of_day,
                              const ::GeoPoint &bottom_location,
                              int bottom_altitude,
@@ -283,80 +822,105 @@ CloudServer::OnThermalSubmit(const Client &c,
                              int top_altitude,
                              double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
-    /* we don't trust the client if he didn't sent anything to us
-       yet */
-    return;
+  const ScopeLatency measure(latency.thermal_submit);
 
-  cout << "THERMAL\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << top_location << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
-
-  const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+  SkyLinesTracking::Thermal packed;
+
+  {
+    auto &shard = data.GetShard(c.key);
+    const std::lock_guard<Mutex> lock(shard.mutex);
+
+    auto *client = shard.data.clients.Find(c.key);
+    if (client == nullptr)
+      /* we don't trust the client if he didn't sent anything to us
+         yet */
+      return;
+
+    if (access_log) {
+      std::ostringstream line;
+      line << "THERMAL\t"
+           << client->address << '\t'
+           << std::hex << client->key << std::dec << '\t'
+           << client->id << '\t'
+           << top_location << '\t'
+           << bottom_altitude << '-' << top_altitude << "m\t"
+           << lift << "m/s";
+      access_log->Append(line.str());
+    }
+
+    const auto &thermal =
+      shard.data.thermals.Make(c.key,
+                               AGeoPoint(bottom_location, bottom_altitude),
+                               AGeoPoint(top_location, top_altitude),
+                               lift);
+    journal.AppendThermal(thermal);
+    packed = thermal.Pack();
+  }
 
   /* send this new thermal to all interested clients immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(bottom_location,
-                                                THERMAL_RANGE)) {
-    if (i->key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
-
-    if (now > i->wants_thermals)
-      /* not interested (anymore) */
-      continue;
-
-    ThermalResponseSender s(*this, i->address, i->key);
-    s.Add(thermal.Pack());
+  for (const auto &i : FindRecipients(c.key, bottom_location, THERMAL_RANGE,
+                                      &CloudClient::wants_thermals, now)) {
+    ThermalResponseSender s(server, i.address, i.key);
+    s.Add(packed);
     s.Flush();
   }
 }
 
 void
-CloudServer::OnThermalRequest(const Client &c)
+CloudServer::OnThermalRequest(SkyLinesTracking::Server &server,
+                              const SkyLinesTracking::Server::Client &c)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
-    /* we don't send our data to clients who didn't sent anything to
-       us yet */
-    return;
+  const ScopeLatency measure(latency.thermal_request);
 
   const auto now = std::chrono::steady_clock::now();
 
-  client->wants_thermals = now + REQUEST_EXPIRY;
+  ::GeoPoint location;
+
+  {
+    auto &shard = data.GetShard(c.key);
+    const std::lock_guard<Mutex> lock(shard.mutex);
+
+    auto *client = shard.data.clients.Find(c.key);
+    if (client == nullptr)
+      /* we don't send our data to clients who didn't sent anything to
+         us yet */
+      return;
+
+    client->wants_thermals = now + REQUEST_EXPIRY;
+    location = client->location;
+  }
 
   const auto min_time = now - MAX_THERMAL_AGE;
 
-  ThermalResponseSender s(*this, c.address, c.key);
+  /* collect the matches first and send them after all shard locks
+     have been released */
+  std::vector<SkyLinesTracking::Thermal> result;
 
-  unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
-      /* ignore this client's own submissions - he knows them
-         already */
-      continue;
+  data.ForEachLocked([&](const CloudData &d){
+    if (result.size() >= MAX_THERMAL_RESPONSE)
+      return;
 
-    if (thermal->time < min_time)
-      /* don't send old thermals, they're useless */
-      continue;
+    for (const auto &thermal : d.thermals.QueryWithinRange(location,
+                                                           THERMAL_RANGE)) {
+      if (thermal->client_key == c.key)
+        /* ignore this client's own submissions - he knows them
+           already */
+        continue;
 
-    s.Add(thermal->Pack());
+      if (thermal->time < min_time)
+        /* don't send old thermals, they're useless */
+        continue;
 
-    if (++n > 256)
-      break;
-  }
+      result.push_back(thermal->Pack());
+      if (result.size() >= MAX_THERMAL_RESPONSE)
+        break;
+    }
+  });
+
+  ThermalResponseSender s(server, c.address, c.key);
+  for (const auto &i : result)
+    s.Add(i);
 
   s.Flush();
 }
@@ -364,43 +928,79 @@ CloudServer::OnThermalRequest(const Client &c)
 void
 CloudServer::Load()
 {
-  FileReader fr(db_path);
-  Deserialiser s(fr);
-  CloudData::Load(s);
+  auto tmp = std::make_unique<CloudData>();
+  journal.Load(*tmp);
+  data.Distribute(*tmp);
 }
 
 void
 CloudServer::Save()
 {
-  cout << "Saving data to " << db_path.c_str() << endl;
-
-  FileOutputStream fos(db_path);
+  journal.Compact();
+}
 
-  {
-    Serialiser s(fos);
-    CloudData::Save(s);
-    s.Flush();
-  }
+static unsigned
+ParsePositive(Args &args, const char *value)
+{
+  char *endptr;
+  const auto result = strtoul(value, &endptr, 10);
+  if (endptr == value || *endptr != 0 || result == 0 || result > 1024)
+    args.UsageError();
 
-  fos.Commit();
+  return result;
 }
 
 int
 main(int argc, char **argv)
 try {
-  if (argc != 2) {
-    cerr << "Usage: " << argv[0] << " DBPATH" << endl;
-    return EXIT_FAILURE;
+  Args args(argc, argv,
+            "[OPTIONS] DBPATH\n"
+            "Options:\n"
+            "  --threads=N     Number of receive threads (default 1)\n"
+            "  --shards=N      Number of database partitions (default: one per thread)\n"
+            "  --unbatched     Don't use recvmmsg()/sendmmsg()\n"
+            "  --stats         Print packet rates and syscalls per packet every 10s\n"
+            "  --metrics=PATH  Write Prometheus metrics to this file every 10s\n"
+            "  --access-log=PATH  Log all packets to this file (\"-\" is stdout)");
+
+  unsigned n_threads = 1, n_shards = 0;
+  bool batched = true, statistics = false;
+  const char *metrics_path = nullptr, *access_log_path = nullptr;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--threads=")) != nullptr)
+      n_threads = ParsePositive(args, value);
+    else if ((value = StringAfterPrefix(arg, "--shards=")) != nullptr)
+      n_shards = ParsePositive(args, value);
+    else if (StringIsEqual(arg, "--unbatched"))
+      batched = false;
+    else if (StringIsEqual(arg, "--stats"))
+      statistics = true;
+    else if ((value = StringAfterPrefix(arg, "--metrics=")) != nullptr &&
+             *value != 0)
+      metrics_path = value;
+    else if ((value = StringAfterPrefix(arg, "--access-log=")) != nullptr &&
+             *value != 0)
+      access_log_path = value;
+    else
+      args.UsageError();
   }
 
-  const Path db_path(argv[1]);
+  const Path db_path(args.ExpectNext());
+  args.ExpectEnd();
+
+  if (n_shards == 0)
+    n_shards = n_threads;
 
   EventLoop event_loop;
   SignalMonitorInit(event_loop);
   AtScopeExit() { SignalMonitorFinish(); };
 
-  CloudServer server(db_path, event_loop,
-                     IPv4Address(CloudServer::GetDefaultPort()));
+  CloudServer server(db_path, event_loop, n_shards);
 
   try {
     server.Load();
@@ -409,8 +1009,24 @@ try {
     PrintException(e);
   }
 
+  if (access_log_path != nullptr)
+    server.EnableAccessLog(Path(access_log_path));
+
+  /* start with a fresh snapshot and an empty journal */
+  server.Save();
+
+  server.Start(IPv4Address(SkyLinesTracking::Server::GetDefaultPort()),
+               n_threads, batched);
+
+  if (statistics)
+    server.EnableStatistics();
+
+  if (metrics_path != nullptr)
+    server.EnableMetrics(Path(metrics_path));
+
   event_loop.Run();
 
+  server.Stop();
   server.Save();
 
   return EXIT_SUCCESS;
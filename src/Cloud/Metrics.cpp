@@ -0,0 +1,79 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Metrics.hpp"
+
+#include <ostream>
+
+void
+LatencyHistogram::Add(std::chrono::steady_clock::duration d) noexcept
+{
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+
+  unsigned i = 0;
+  while (i < N_BUCKETS && us > (int64_t(1) << i))
+    ++i;
+
+  buckets[i].fetch_add(1, std::memory_order_relaxed);
+  sum_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(),
+                   std::memory_order_relaxed);
+}
+
+void
+LatencyHistogram::Write(std::ostream &os, const char *name,
+                        const char *labels) const
+{
+  /* take one snapshot of all buckets, so the cumulative values
+     are consistent with each other and with "_count" even while
+     other threads keep adding */
+  std::array<uint64_t, N_BUCKETS + 1> snapshot;
+  for (unsigned i = 0; i <= N_BUCKETS; ++i)
+    snapshot[i] = buckets[i].load(std::memory_order_relaxed);
+
+  /* Prometheus buckets are cumulative */
+  uint64_t cumulative = 0;
+  for (unsigned i = 0; i < N_BUCKETS; ++i) {
+    cumulative += snapshot[i];
+    os << name << "_bucket{" << labels << ",le=\""
+       << (1 << i) * 1e-6 << "\"} " << cumulative << '\n';
+  }
+
+  cumulative += snapshot[N_BUCKETS];
+  os << name << "_bucket{" << labels << ",le=\"+Inf\"} "
+     << cumulative << '\n';
+
+  /* the count is the "+Inf" bucket by definition */
+  os << name << "_sum{" << labels << "} "
+     << sum_ns.load(std::memory_order_relaxed) * 1e-9 << '\n'
+     << name << "_count{" << labels << "} "
+     << cumulative << '\n';
+}
+
+void
+WriteMetric(std::ostream &os, const char *name, const char *type,
+            const char *help, uint64_t value)
+{
+  os << "# HELP " << name << ' ' << help << '\n'
+     << "# TYPE " << name << ' ' << type << '\n'
+     << name << ' ' << value << '\n';
+}
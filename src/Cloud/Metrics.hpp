@@ -0,0 +1,93 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_METRICS_HPP
+#define XCSOAR_CLOUD_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * A histogram of durations with exponential buckets from 1 µs to
+ * about one second.  It may be updated from any thread without
+ * locking.
+ */
+class LatencyHistogram {
+  /**
+   * The upper bound of bucket i is 2^i microseconds.  There is one
+   * more bucket for larger values.
+   */
+  static constexpr unsigned N_BUCKETS = 21;
+
+  std::array<std::atomic<uint64_t>, N_BUCKETS + 1> buckets{};
+
+  std::atomic<uint64_t> sum_ns{0};
+
+public:
+  void Add(std::chrono::steady_clock::duration d) noexcept;
+
+  /**
+   * Write the histogram in the Prometheus text format.
+   *
+   * @param name the metric name
+   * @param labels additional labels, e.g. "handler=\"fix\""
+   */
+  void Write(std::ostream &os, const char *name,
+             const char *labels) const;
+};
+
+/**
+ * Measures the time from construction to destruction and adds it to
+ * a #LatencyHistogram.
+ */
+class ScopeLatency {
+  LatencyHistogram &histogram;
+  const std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
+public:
+  explicit ScopeLatency(LatencyHistogram &_histogram) noexcept
+    :histogram(_histogram) {}
+
+  ~ScopeLatency() noexcept {
+    histogram.Add(std::chrono::steady_clock::now() - start);
+  }
+
+  ScopeLatency(const ScopeLatency &) = delete;
+  ScopeLatency &operator=(const ScopeLatency &) = delete;
+};
+
+/**
+ * Write a metric header and one sample in the Prometheus text
+ * format.
+ *
+ * @param type "counter" or "gauge"
+ */
+void
+WriteMetric(std::ostream &os, const char *name, const char *type,
+            const char *help, uint64_t value);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_RTREE_INDEX_HPP
+#define XCSOAR_CLOUD_RTREE_INDEX_HPP
+
+#include "Geo/Boost/GeoPoint.hpp"
+#include "Geo/Boost/RangeBox.hpp"
+
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <memory>
+
+/**
+ * A geospatial index based on boost::geometry::index::rtree.  It has
+ * the same interface as #GeoGridIndex.
+ *
+ * @param T the object type
+ * @param Indexable a function object which returns the #GeoPoint of
+ * a std::shared_ptr<T>
+ */
+template<typename T, typename Indexable>
+class GeoRTreeIndex
+  : public boost::geometry::index::rtree<std::shared_ptr<T>,
+                                         boost::geometry::index::rstar<16>,
+                                         Indexable> {
+  using Tree = boost::geometry::index::rtree<std::shared_ptr<T>,
+                                             boost::geometry::index::rstar<16>,
+                                             Indexable>;
+
+public:
+  using typename Tree::const_query_iterator;
+  using const_query_range = boost::iterator_range<const_query_iterator>;
+
+  [[gnu::pure]]
+  const_query_range QueryWithinRange(GeoPoint location, double range) const {
+    const auto q = boost::geometry::index::intersects(BoostRangeBox(location, range));
+    return {this->qbegin(q), this->qend()};
+  }
+};
+
+#endif
@@ -22,6 +22,9 @@ Copyright_License {
 */
 
 #include "Serialiser.hpp"
+#include "net/AddressInfo.hxx"
+#include "net/Resolver.hxx"
+#include "net/AllocatedSocketAddress.hxx"
 
 #include <algorithm>
 #include <stdexcept>
@@ -47,3 +50,31 @@ Deserialiser::ReadString()
   Consume(length);
   return std::string(data, length);
 }
+
+Serialiser &
+operator<<(Serialiser &s, SocketAddress address)
+{
+  char host[NI_MAXHOST], serv[NI_MAXSERV];
+  int ret = getnameinfo(address.GetAddress(), address.GetSize(),
+                        host, sizeof(host), serv, sizeof(serv),
+                        NI_NUMERICHOST|NI_NUMERICSERV);
+  s.WriteString(ret == 0 ? host : "unkown");
+  s.Write16(address.GetPort());
+  return s;
+}
+
+Deserialiser &
+operator>>(Deserialiser &s, AllocatedSocketAddress &address)
+{
+  static constexpr auto hints =
+    MakeAddrInfo(AI_NUMERICHOST, AF_UNSPEC, SOCK_DGRAM);
+
+  const auto node = s.ReadString();
+  char service[32];
+  snprintf(service, sizeof(service), "%u", s.Read16());
+
+  const auto ai = Resolve(node.c_str(), service, &hints);
+  address = ai.front();
+
+  return s;
+}
@@ -33,6 +33,9 @@ Copyright_License {
 
 #include <stdio.h>
 
+class SocketAddress;
+class AllocatedSocketAddress;
+
 class Serialiser : public BufferedOutputStream {
   const std::chrono::steady_clock::time_point steady_now =
     std::chrono::steady_clock::now();
@@ -186,4 +189,10 @@ public:
   }
 };
 
+Serialiser &
+operator<<(Serialiser &s, SocketAddress address);
+
+Deserialiser &
+operator>>(Deserialiser &s, AllocatedSocketAddress &address);
+
 #endif
@@ -0,0 +1,120 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Shard.hpp"
+#include "Serialiser.hpp"
+
+#include <algorithm>
+
+#include <cassert>
+
+ShardedCloudData::ShardedCloudData(unsigned n_shards)
+{
+  assert(n_shards > 0);
+
+  shards.reserve(n_shards);
+  for (unsigned i = 0; i < n_shards; ++i) {
+    auto &shard = *shards.emplace_back(std::make_unique<CloudShard>());
+    shard.data.clients.SetIdSequence(1 + i, n_shards);
+  }
+}
+
+void
+ShardedCloudData::DumpClients()
+{
+  ForEachLocked([](CloudData &data){
+    data.DumpClients();
+  });
+}
+
+void
+ShardedCloudData::Save(Serialiser &s) const
+{
+  unsigned next_id = 1;
+  ForEachLocked([&next_id](const CloudData &data){
+    next_id = std::max(next_id, data.clients.GetNextId());
+  });
+
+  s.Write32(CloudData::MAGIC);
+  s.Write32(CloudData::VERSION);
+
+  /* see CloudClientContainer::Save() */
+  s.Write32(next_id);
+  ForEachLocked([&s](const CloudData &data){
+    for (const auto &client : data.clients) {
+      s.Write8(1);
+      client.Save(s);
+    }
+  });
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(1);
+
+  /* see CloudThermalContainer::Save() */
+  s.Write8(1);
+  ForEachLocked([&s](const CloudData &data){
+    for (const auto &thermal : data.thermals) {
+      s.Write8(1);
+      thermal.Save(s);
+    }
+  });
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(0);
+}
+
+void
+ShardedCloudData::Load(Deserialiser &s)
+{
+  /* load everything into a temporary container and then move each
+     record to the shard it belongs to */
+  auto tmp = std::make_unique<CloudData>();
+  tmp->Load(s);
+  Distribute(*tmp);
+}
+
+void
+ShardedCloudData::Distribute(CloudData &src)
+{
+  const unsigned n_shards = shards.size();
+
+  /* continue the public id sequence above the highest id in the
+     database, with each shard in its own residue class */
+  const unsigned base = (src.clients.GetNextId() - 1 + n_shards - 1)
+    / n_shards * n_shards;
+
+  for (unsigned i = 0; i < n_shards; ++i) {
+    auto &data = shards[i]->data;
+    data.clients.clear();
+    data.thermals.clear();
+    data.clients.SetIdSequence(base + 1 + i, n_shards);
+  }
+
+  while (auto client = src.clients.PopOldest())
+    GetShard(client->key).data.clients.Insert(*client);
+
+  while (auto thermal = src.thermals.PopOldest())
+    GetShard(thermal->client_key).data.thermals.Insert(*thermal);
+}
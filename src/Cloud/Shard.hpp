@@ -0,0 +1,136 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_SHARD_HPP
+#define XCSOAR_CLOUD_SHARD_HPP
+
+#include "Data.hpp"
+#include "thread/Mutex.hxx"
+
+#include <memory>
+#include <vector>
+
+class Serialiser;
+class Deserialiser;
+
+/**
+ * One partition of the cloud database.  All access to #data must be
+ * protected by #mutex.
+ */
+struct CloudShard {
+  mutable Mutex mutex;
+  CloudData data;
+
+  /**
+   * Clients with a new location which has not yet been sent to
+   * their neighbours.  See #TrafficFanout.
+   */
+  std::vector<CloudClientPtr> dirty_traffic;
+
+  /**
+   * Schedule the client's new location for distribution.
+   */
+  void MarkTrafficDirty(CloudClient &client) {
+    if (!client.traffic_dirty) {
+      client.traffic_dirty = true;
+      dirty_traffic.push_back(client.shared_from_this());
+    }
+  }
+};
+
+/**
+ * The cloud database, partitioned by client key into several
+ * #CloudShard instances, so several receive threads can update it
+ * concurrently.  Thermals live in the shard of the client which
+ * submitted them.
+ *
+ * The on-disk format is the same as the one of #CloudData, and a
+ * database may be loaded with a different number of shards than it
+ * was saved with.
+ */
+class ShardedCloudData {
+  std::vector<std::unique_ptr<CloudShard>> shards;
+
+public:
+  explicit ShardedCloudData(unsigned n_shards);
+
+  unsigned size() const noexcept {
+    return shards.size();
+  }
+
+  CloudShard &operator[](unsigned i) noexcept {
+    return *shards[i];
+  }
+
+  const CloudShard &operator[](unsigned i) const noexcept {
+    return *shards[i];
+  }
+
+  [[gnu::pure]]
+  CloudShard &GetShard(uint64_t client_key) noexcept {
+    return *shards[client_key % shards.size()];
+  }
+
+  /**
+   * Invoke the given function with each shard, while holding its
+   * mutex.
+   */
+  template<typename F>
+  void ForEachLocked(F &&f) {
+    for (auto &shard : shards) {
+      const std::lock_guard<Mutex> lock(shard->mutex);
+      f(shard->data);
+    }
+  }
+
+  template<typename F>
+  void ForEachLocked(F &&f) const {
+    for (const auto &shard : shards) {
+      const std::lock_guard<Mutex> lock(shard->mutex);
+      f(shard->data);
+    }
+  }
+
+  void DumpClients();
+
+  /**
+   * Save all shards.  Each shard is locked only while its own
+   * records are being written.
+   */
+  void Save(Serialiser &s) const;
+
+  /**
+   * Load a database and distribute its records among the shards.
+   * Must be called before the receive threads are started.
+   */
+  void Load(Deserialiser &s);
+
+  /**
+   * Move all records from the given #CloudData to the shards they
+   * belong to, replacing the current contents.  Must be called
+   * before the receive threads are started.
+   */
+  void Distribute(CloudData &src);
+};
+
+#endif
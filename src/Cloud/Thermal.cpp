@@ -23,14 +23,10 @@ Copyright_License {
 
 #include "Thermal.hpp"
 #include "Serialiser.hpp"
-#include "Geo/Boost/RangeBox.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "Tracking/SkyLines/Assemble.hpp"
 #include "Tracking/SkyLines/Import.hpp"
 
-#include <boost/geometry/algorithms/intersection.hpp>
-#include <boost/geometry/strategies/strategies.hpp>
-
 CloudThermalContainer::CloudThermalContainer()
 {
 }
@@ -63,14 +59,14 @@ void
 CloudThermalContainer::Insert(CloudThermal &thermal)
 {
   list.push_front(thermal);
-  rtree.insert(thermal.shared_from_this());
+  index.insert(thermal.shared_from_this());
 }
 
 void
 CloudThermalContainer::Remove(CloudThermal &thermal)
 {
   list.erase(list.iterator_to(thermal));
-  rtree.remove(thermal.shared_from_this());
+  index.remove(thermal.shared_from_this());
 }
 
 void
@@ -80,11 +76,22 @@ CloudThermalContainer::Expire(std::chrono::steady_clock::time_point before)
     Remove(list.back());
 }
 
+CloudThermalPtr
+CloudThermalContainer::PopOldest() noexcept
+{
+  if (list.empty())
+    return nullptr;
+
+  auto &thermal = list.back();
+  auto ptr = thermal.shared_from_this();
+  Remove(thermal);
+  return ptr;
+}
+
 CloudThermalContainer::query_iterator_range
 CloudThermalContainer::QueryWithinRange(GeoPoint location, double range) const
 {
-  const auto q = boost::geometry::index::intersects(BoostRangeBox(location, range));
-  return {rtree.qbegin(q), rtree.qend()};
+  return index.QueryWithinRange(location, range);
 }
 
 SkyLinesTracking::Thermal
@@ -111,7 +118,7 @@ CloudThermal
 CloudThermal::Load(Deserialiser &s)
 {
   s.Read8();
-  const unsigned client_key = s.Read64();
+  const uint64_t client_key = s.Read64();
 
   std::chrono::steady_clock::time_point time;
   s >> time;
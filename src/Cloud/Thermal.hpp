@@ -24,11 +24,9 @@ Copyright_License {
 #ifndef XCSOAR_CLOUD_THERMAL_HPP
 #define XCSOAR_CLOUD_THERMAL_HPP
 
-#include "Geo/Boost/GeoPoint.hpp"
+#include "GridIndex.hpp"
 
 #include <boost/intrusive/list.hpp>
-#include <boost/geometry/index/rtree.hpp>
-#include <boost/range/iterator_range_core.hpp>
 
 #include <memory>
 #include <chrono>
@@ -42,7 +40,8 @@ namespace SkyLinesTracking { struct Thermal; }
  */
 struct CloudThermal
   : std::enable_shared_from_this<CloudThermal>,
-    boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
+    boost::intrusive::list_base_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>,
+    GeoGridHook
 {
   const uint64_t client_key;
 
@@ -75,7 +74,7 @@ struct CloudThermal
 using CloudThermalPtr = std::shared_ptr<CloudThermal>;
 
 /**
- * Helper for boost::geometry::index::rtree.
+ * Helper for #GeoGridIndex and #GeoRTreeIndex.
  */
 struct CloudThermalIndexable {
   typedef GeoPoint result_type;
@@ -87,8 +86,11 @@ struct CloudThermalIndexable {
 };
 
 class CloudThermalContainer {
-  typedef boost::geometry::index::rtree<CloudThermalPtr, boost::geometry::index::rstar<16>,
-                                        CloudThermalIndexable> Tree;
+  /**
+   * The geospatial index implementation.  #GeoRTreeIndex may be
+   * used instead; it is slower for objects which move a lot.
+   */
+  using Index = GeoGridIndex<CloudThermal, CloudThermalIndexable>;
 
   typedef boost::intrusive::list<CloudThermal,
                                  boost::intrusive::constant_time_size<false>> List;
@@ -97,7 +99,7 @@ class CloudThermalContainer {
    * A geospatial container of all thermals, for fast geographic
    * lookups.
    */
-  Tree rtree;
+  Index index;
 
   /**
    * A linked list of thermals, sorted by time, with newer items at
@@ -115,6 +117,10 @@ public:
     return list.empty();
   }
 
+  std::size_t size() const noexcept {
+    return index.size();
+  }
+
   /**
    * For iteration over the list of all clients in unspecified order.
    * The iterators get invalidated by all modifying calls.
@@ -145,8 +151,14 @@ public:
 
   void Expire(std::chrono::steady_clock::time_point before);
 
-  typedef Tree::const_query_iterator query_iterator;
-  typedef boost::iterator_range<query_iterator> query_iterator_range;
+  /**
+   * Remove the oldest thermal and return it.  Returns nullptr if the
+   * container is empty.
+   */
+  CloudThermalPtr PopOldest() noexcept;
+
+  typedef Index::const_query_iterator query_iterator;
+  typedef Index::const_query_range query_iterator_range;
 
   [[gnu::pure]]
   query_iterator_range QueryWithinRange(GeoPoint location, double range) const;
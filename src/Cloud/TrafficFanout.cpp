@@ -0,0 +1,180 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "TrafficFanout.hpp"
+#include "Shard.hpp"
+#include "Sender.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Tracking/SkyLines/Server.hpp"
+#include "net/StaticSocketAddress.hxx"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The maximum number of traffic records sent to one client per tick;
+ * this fits into one TRAFFIC_RESPONSE datagram.
+ */
+static constexpr unsigned MAX_TRAFFIC_PER_TICK = 32;
+
+namespace {
+
+/**
+ * A copy of a dirty client's new position.
+ */
+struct TrafficRecord {
+  uint64_t key;
+  unsigned id;
+  GeoPoint location;
+  int altitude;
+};
+
+/**
+ * The traffic collected for one subscriber during one tick.
+ */
+struct Subscriber {
+  StaticSocketAddress address;
+  GeoPoint location;
+
+  unsigned n = 0;
+
+  struct Item {
+    const TrafficRecord *record;
+    double distance;
+  };
+
+  std::array<Item, MAX_TRAFFIC_PER_TICK> items;
+
+  /**
+   * Add a record; if the list is full, it replaces the farthest one
+   * if it is nearer.
+   */
+  void Add(const TrafficRecord &record) noexcept {
+    const double distance = location.DistanceS(record.location);
+
+    if (n < items.size()) {
+      items[n++] = {&record, distance};
+      return;
+    }
+
+    auto *farthest = &items.front();
+    for (auto &i : items)
+      if (i.distance > farthest->distance)
+        farthest = &i;
+
+    if (distance < farthest->distance)
+      *farthest = {&record, distance};
+  }
+};
+
+} // anonymous namespace
+
+TrafficFanout::TrafficFanout(ShardedCloudData &_data,
+                             SkyLinesTracking::Server &_server,
+                             double _range) noexcept
+  :data(_data), server(_server), range(_range),
+   start_event(server.GetEventLoop(), BIND_THIS_METHOD(OnStart)),
+   timer(server.GetEventLoop(), BIND_THIS_METHOD(OnTimer))
+{
+}
+
+void
+TrafficFanout::OnTimer() noexcept
+{
+  try {
+    Flush();
+  } catch (...) {
+    /* out of memory; try again next tick */
+  }
+
+  timer.Schedule(TICK);
+}
+
+inline void
+TrafficFanout::Flush()
+{
+  std::vector<TrafficRecord> records;
+
+  for (unsigned i = 0; i < data.size(); ++i) {
+    auto &shard = data[i];
+    const std::lock_guard<Mutex> lock(shard.mutex);
+
+    for (const auto &client : shard.dirty_traffic) {
+      client->traffic_dirty = false;
+      records.push_back({client->key, client->id,
+                         client->location, client->altitude});
+    }
+
+    shard.dirty_traffic.clear();
+  }
+
+  if (records.empty())
+    return;
+
+  /* look up the neighbours of each dirty client; the records are
+     collected per subscriber */
+
+  const auto now = std::chrono::steady_clock::now();
+  std::unordered_map<uint64_t, Subscriber> subscribers;
+
+  data.ForEachLocked([&](const CloudData &d){
+    for (const auto &record : records) {
+      for (const auto &i : d.clients.QueryWithinRange(record.location,
+                                                      range)) {
+        if (i->key == record.key)
+          /* ignore this client's own submissions - he knows them
+             already */
+          continue;
+
+        if (now > i->wants_traffic)
+          /* not interested (anymore) */
+          continue;
+
+        auto [it, inserted] = subscribers.try_emplace(i->key);
+        auto &subscriber = it->second;
+        if (inserted) {
+          subscriber.address = i->address;
+          subscriber.location = i->location;
+        }
+
+        subscriber.Add(record);
+      }
+    }
+  });
+
+  server.BeginSendBatch();
+
+  for (const auto &[key, subscriber] : subscribers) {
+    TrafficResponseSender s(server, subscriber.address, key);
+    for (unsigned i = 0; i < subscriber.n; ++i) {
+      const auto &record = *subscriber.items[i].record;
+      s.Add(record.id, 0, //TODO: time?
+            record.location, record.altitude);
+    }
+
+    s.Flush();
+  }
+
+  server.CommitSendBatch();
+}
@@ -0,0 +1,95 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_CLOUD_TRAFFIC_FANOUT_HPP
+#define XCSOAR_CLOUD_TRAFFIC_FANOUT_HPP
+
+#include "event/FineTimerEvent.hxx"
+#include "event/InjectEvent.hxx"
+
+#include <chrono>
+
+class ShardedCloudData;
+namespace SkyLinesTracking { class Server; }
+
+/**
+ * Distributes traffic to all interested clients.  Instead of sending
+ * each incoming fix immediately to every client nearby, the fix
+ * handler only marks the client as "dirty" (see
+ * CloudShard::dirty_traffic).  On every tick, this class collects all
+ * dirty clients, looks up their neighbours once and sends each
+ * subscriber one packet with all updates, capped at a fixed number of
+ * records (the nearest ones win).
+ *
+ * This bounds the number of outgoing packets to one per subscriber
+ * per tick, no matter how many gliders share a thermal.
+ *
+ * All methods must be called from the thread of the given
+ * #SkyLinesTracking::Server, except for Start().
+ */
+class TrafficFanout {
+  static constexpr std::chrono::steady_clock::duration TICK =
+    std::chrono::milliseconds(500);
+
+  ShardedCloudData &data;
+
+  SkyLinesTracking::Server &server;
+
+  const double range;
+
+  InjectEvent start_event;
+  FineTimerEvent timer;
+
+public:
+  /**
+   * @param server the socket used to send the responses; the timer
+   * runs in its #EventLoop
+   * @param range the maximum distance of traffic sent to a client
+   * [m]
+   */
+  TrafficFanout(ShardedCloudData &_data,
+                SkyLinesTracking::Server &_server,
+                double _range) noexcept;
+
+  /**
+   * Start the timer.  This method is thread-safe and may be called
+   * before the #EventLoop runs.
+   */
+  void Start() noexcept {
+    start_event.Schedule();
+  }
+
+private:
+  void OnStart() noexcept {
+    timer.Schedule(TICK);
+  }
+
+  void OnTimer() noexcept;
+
+  /**
+   * Send all pending traffic updates.
+   */
+  void Flush();
+};
+
+#endif
@@ -30,6 +30,10 @@ ContestComputer::ContestComputer(const Trace &trace_full,
   :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
 {
   contest_manager.SetIncremental(true);
+
+  /* don't let the triangle search block the calculation thread; it
+     continues in the next tick */
+  contest_manager.SetTriangleTickBudget(std::chrono::milliseconds(100));
 }
 
 void
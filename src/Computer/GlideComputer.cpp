@@ -28,8 +28,6 @@ Copyright_License {
 #include "GlideComputerInterface.hpp"
 #include "Engine/Waypoint/Waypoints.hpp"
 
-static PeriodClock last_team_code_update;
-
 GlideComputer::GlideComputer(const ComputerSettings &_settings,
                              const Waypoints &_way_points,
                              Airspaces &_airspace_database,
@@ -129,7 +127,8 @@ GlideComputer::ProcessGPS(bool force)
 
   stats_computer.ProcessClimbEvents(calculated);
 
-  cu_computer.Compute(basic, calculated, settings);
+  if (!headless)
+    cu_computer.Compute(basic, calculated, settings);
 
   // Calculate the team code
   CalculateOwnTeamCode();
@@ -137,21 +136,23 @@ GlideComputer::ProcessGPS(bool force)
   // Calculate the bearing and range of the teammate
   CalculateTeammateBearingRange();
 
-  // update basic trace history
-  if (basic.time_available) {
-    const auto dt = trace_history_time.Update(basic.time, 0.5, 30);
-    if (dt > 0)
-      calculated.trace_history.append(basic);
-    else if (dt < 0)
-      /* time warp */
-      calculated.trace_history.clear();
+  if (!headless) {
+    // update basic trace history
+    if (basic.time_available) {
+      const auto dt = trace_history_time.Update(basic.time, 0.5, 30);
+      if (dt > 0)
+        calculated.trace_history.append(basic);
+      else if (dt < 0)
+        /* time warp */
+        calculated.trace_history.clear();
+    }
+
+    CalculateVarioScale();
+
+    // Update the ConditionMonitors
+    ConditionMonitorsUpdate(Basic(), Calculated(), settings);
   }
 
-  CalculateVarioScale();
-
-  // Update the ConditionMonitors
-  ConditionMonitorsUpdate(Basic(), Calculated(), settings);
-
   return idle_clock.CheckUpdate(std::chrono::milliseconds(500));
 }
 
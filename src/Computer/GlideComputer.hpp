@@ -63,6 +63,14 @@ class GlideComputer : public GlideComputerBlackboard
 
   PeriodClock idle_clock;
 
+  PeriodClock last_team_code_update;
+
+  /**
+   * Skip the calculations which only feed the user interface?  See
+   * SetHeadless().
+   */
+  bool headless = false;
+
   /**
    * This object is used to check whether to update
    * DerivedInfo::trace_history.
@@ -82,6 +90,16 @@ public:
     log_computer.SetLogger(logger);
   }
 
+  /**
+   * Skip the calculations whose results are only displayed (gauges,
+   * analysis charts, condition monitor messages).  This is used for
+   * batch analysis, where several instances run in parallel without
+   * a user interface.
+   */
+  void SetHeadless(bool _headless) {
+    headless = _headless;
+  }
+
   /**
    * Resets the GlideComputer data
    * @param full Reset all data?
@@ -68,14 +68,13 @@ GlideRatioCalculator::Initialize(const ComputerSettings &settings)
   totaldistance = 0;
   start = -1;
   size = bsize;
+  errs = 0;
   valid = false;
 }
 
 void
 GlideRatioCalculator::Add(unsigned distance, int altitude)
 {
-  static short errs = 0;
-
   if (distance < 3 || distance > 150) { // just ignore, no need to reset rotary
     if (errs > 2) {
       errs = 0;
@@ -53,6 +53,12 @@ class GlideRatioCalculator {
    */
   unsigned short size;
 
+  /**
+   * The number of consecutive implausible distances passed to
+   * Add().
+   */
+  unsigned short errs;
+
   bool valid;
 
 public:
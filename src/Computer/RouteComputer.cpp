@@ -30,17 +30,20 @@ Copyright_License {
 #include "Navigation/Aircraft.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 /* Workaround for some GCC versions which don't inline the constexpr
    despite being defined so in C++17, see
    http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2016/p0386r2.pdf */
 #if GCC_OLDER_THAN(9,0)
 constexpr std::chrono::steady_clock::duration RouteComputer::PERIOD;
+constexpr std::chrono::steady_clock::duration RouteComputer::REACH_UPDATE_PERIOD;
 #endif
 
 RouteComputer::RouteComputer(const Airspaces &airspace_database,
                              const ProtectedAirspaceWarningManager *warnings)
   :protected_route_planner(route_planner, airspace_database, warnings),
+   reach_update_backoff(0),
    terrain(NULL)
 {}
 
@@ -49,6 +52,8 @@ RouteComputer::ResetFlight()
 {
   route_clock.Reset();
   reach_clock.Reset();
+  reach_update_clock.Reset();
+  reach_update_backoff = 0;
   protected_route_planner.Reset();
 
   last_task_type = TaskType::NONE;
@@ -152,15 +157,53 @@ RouteComputer::Reach(const MoreData &basic, DerivedInfo &calculated,
                                (int)calculated.common_stats.height_max_working));
 
   if (reach_clock.CheckAdvance(basic.time, PERIOD)) {
-    protected_route_planner.SolveReach(start, config, h_ceiling, do_solve);
+    reach_update_clock.Update(basic.time);
+    SolveReach(start, config, h_ceiling, do_solve);
+  } else if (do_solve && IsReachUpdateWorthwhile(start) &&
+             reach_update_clock.CheckAdvance(basic.time, REACH_UPDATE_PERIOD)) {
+    const auto t = std::chrono::steady_clock::now();
+    if (!protected_route_planner.UpdateReach(start, config, h_ceiling)) {
+      /* the previous solution cannot be reused; start over */
+      reach_clock.Update(basic.time);
+      SolveReach(start, config, h_ceiling, do_solve);
+    } else {
+      reach_origin = start;
 
-    if (do_solve) {
-      calculated.terrain_base = route_planner.GetTerrainBase();
-      calculated.terrain_base_valid = true;
+      if ((std::chrono::steady_clock::now() - t) * 4 > reach_solve_duration)
+        /* not worth it, the root fan dominates */
+        reach_update_backoff = REACH_UPDATE_BACKOFF;
     }
+  } else
+    return;
+
+  if (do_solve) {
+    calculated.terrain_base = route_planner.GetTerrainBase();
+    calculated.terrain_base_valid = true;
   }
 }
 
+inline bool
+RouteComputer::IsReachUpdateWorthwhile(const AGeoPoint &origin) const noexcept
+{
+  return reach_update_backoff == 0 &&
+    (std::abs(origin.altitude - reach_origin.altitude) >= REACH_UPDATE_HEIGHT ||
+     origin.Distance(reach_origin) >= REACH_UPDATE_DISTANCE);
+}
+
+inline void
+RouteComputer::SolveReach(const AGeoPoint &origin,
+                          const RoutePlannerConfig &config,
+                          int h_ceiling, bool do_solve)
+{
+  const auto t = std::chrono::steady_clock::now();
+  protected_route_planner.SolveReach(origin, config, h_ceiling, do_solve);
+  reach_solve_duration = std::chrono::steady_clock::now() - t;
+  reach_origin = origin;
+
+  if (reach_update_backoff > 0)
+    --reach_update_backoff;
+}
+
 void
 RouteComputer::set_terrain(const RasterTerrain* _terrain) {
   terrain = _terrain;
@@ -40,11 +40,55 @@ class GlidePolar;
 class RouteComputer {
   static constexpr std::chrono::steady_clock::duration PERIOD = std::chrono::seconds(5);
 
+  /**
+   * Between two full reach solves (every #PERIOD), the reach may be
+   * updated incrementally at this interval (see
+   * RoutePlanner::UpdateReach()).
+   */
+  static constexpr std::chrono::steady_clock::duration REACH_UPDATE_PERIOD = std::chrono::seconds(1);
+
+  /**
+   * An incremental reach update is only attempted after the aircraft
+   * has moved at least this far [m] ...
+   */
+  static constexpr double REACH_UPDATE_DISTANCE = 100;
+
+  /**
+   * ... or has changed its altitude by at least this much [m] since
+   * the last reach calculation.
+   */
+  static constexpr int REACH_UPDATE_HEIGHT = 10;
+
+  /**
+   * After an incremental reach update has taken more than a quarter
+   * of the time of a full solve, no more updates are attempted for
+   * this number of full solves.  Over flat terrain, an update is
+   * hardly cheaper than a full solve.
+   */
+  static constexpr unsigned REACH_UPDATE_BACKOFF = 12;
+
   RoutePlannerGlue route_planner;
   ProtectedRoutePlanner protected_route_planner;
 
   GPSClock route_clock;
   GPSClock reach_clock;
+  GPSClock reach_update_clock;
+
+  /**
+   * The origin of the last reach calculation.
+   */
+  AGeoPoint reach_origin;
+
+  /**
+   * The (wall clock) duration of the last full reach solve.
+   */
+  std::chrono::steady_clock::duration reach_solve_duration;
+
+  /**
+   * The number of full reach solves until incremental updates may be
+   * attempted again; see #REACH_UPDATE_BACKOFF.
+   */
+  unsigned reach_update_backoff;
 
   const RasterTerrain *terrain;
 
@@ -91,6 +135,15 @@ private:
 
   void Reach(const MoreData &basic, DerivedInfo &calculated,
              const RoutePlannerConfig &config);
+
+  /**
+   * Is an incremental reach update from this origin worth trying?
+   */
+  [[gnu::pure]]
+  bool IsReachUpdateWorthwhile(const AGeoPoint &origin) const noexcept;
+
+  void SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
+                  int h_ceiling, bool do_solve);
 };
 
 #endif
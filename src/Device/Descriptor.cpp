@@ -255,7 +255,7 @@ DeviceDescriptor::OpenOnPort(std::unique_ptr<DumpPort> &&_port, OperationEnviron
 
   {
     const std::lock_guard<Mutex> lock(device_blackboard->mutex);
-    device_blackboard->SetRealState(index).Reset();
+    parsed_data = device_blackboard->ResetRealState(index);
     device_blackboard->ScheduleMerge();
   }
 
@@ -606,7 +606,7 @@ DeviceDescriptor::Close()
 
   {
     const std::lock_guard<Mutex> lock(device_blackboard->mutex);
-    device_blackboard->SetRealState(index).Reset();
+    parsed_data = device_blackboard->ResetRealState(index);
     device_blackboard->ScheduleMerge();
   }
 
@@ -766,6 +766,8 @@ DeviceDescriptor::ParseNMEA(const char *line, NMEAInfo &info)
        sent to the device */
     const ExternalSettings old_received = settings_received;
     settings_received = info.settings;
+
+    const std::lock_guard<Mutex> lock(mutex);
     info.settings.EliminateRedundant(settings_sent, old_received);
 
     return true;
@@ -842,6 +844,7 @@ DeviceDescriptor::PutMacCready(double value, OperationEnvironment &env)
 
   std::lock_guard<Mutex> lock(device_blackboard->mutex);
   NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const std::lock_guard<Mutex> settings_lock(mutex);
   settings_sent.mac_cready = value;
   settings_sent.mac_cready_available.Update(basic.clock);
 
@@ -867,6 +870,7 @@ DeviceDescriptor::PutBugs(double value, OperationEnvironment &env)
 
   std::lock_guard<Mutex> lock(device_blackboard->mutex);
   NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const std::lock_guard<Mutex> settings_lock(mutex);
   settings_sent.bugs = value;
   settings_sent.bugs_available.Update(basic.clock);
 
@@ -894,6 +898,7 @@ DeviceDescriptor::PutBallast(double fraction, double overload,
 
   std::lock_guard<Mutex> lock(device_blackboard->mutex);
   NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const std::lock_guard<Mutex> settings_lock(mutex);
   settings_sent.ballast_fraction = fraction;
   settings_sent.ballast_fraction_available.Update(basic.clock);
   settings_sent.ballast_overload = overload;
@@ -974,6 +979,7 @@ DeviceDescriptor::PutQNH(const AtmosphericPressure &value,
 
   std::lock_guard<Mutex> lock(device_blackboard->mutex);
   NMEAInfo &basic = device_blackboard->SetRealState(index);
+  const std::lock_guard<Mutex> settings_lock(mutex);
   settings_sent.qnh = value;
   settings_sent.qnh_available.Update(basic.clock);
 
@@ -1162,10 +1168,21 @@ DeviceDescriptor::OnCalculatedUpdate(const MoreData &basic,
 bool
 DeviceDescriptor::ParseLine(const char *line)
 {
-  std::lock_guard<Mutex> lock(device_blackboard->mutex);
-  NMEAInfo &basic = device_blackboard->SetRealState(index);
-  basic.UpdateClock();
-  return ParseNMEA(line, basic);
+  /* apply the same expiry as DeviceBlackboard::Merge() and
+     DeviceBlackboard::ExpireWallClock() do on its copy, for the
+     parser's decisions which depend on it, and so the snapshot does
+     not revive an expired device */
+  parsed_data.ExpireWallClock();
+  parsed_data.UpdateClock();
+  parsed_data.Expire();
+
+  device_blackboard->ApplyPendingChanges(index, parsed_data);
+
+  if (!ParseNMEA(line, parsed_data))
+    return false;
+
+  device_blackboard->StageDeviceData(index, parsed_data);
+  return true;
 }
 
 void
@@ -1252,8 +1269,7 @@ DeviceDescriptor::LineReceived(const char *line) noexcept
   if (dispatcher != nullptr)
     dispatcher->LineReceived(line);
 
-  if (ParseLine(line))
-    device_blackboard->ScheduleMerge();
+  ParseLine(line);
 
   return true;
 }
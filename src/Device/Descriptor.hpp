@@ -32,6 +32,7 @@ Copyright_License {
 #include "Device/Parser.hpp"
 #include "RadioFrequency.hpp"
 #include "NMEA/ExternalSettings.hpp"
+#include "NMEA/Info.hpp"
 #include "time/PeriodClock.hpp"
 #include "Job/Async.hpp"
 #include "ui/event/Notify.hpp"
@@ -50,7 +51,6 @@ Copyright_License {
 
 namespace Cares { class Channel; }
 class EventLoop;
-struct NMEAInfo;
 struct MoreData;
 struct DerivedInfo;
 struct Declaration;
@@ -85,9 +85,9 @@ class DeviceDescriptor final : PortListener, PortLineSplitter {
   UI::Notify job_finished_notify{[this]{ OnJobFinished(); }};
 
   /**
-   * This mutex protects modifications of the attribute "device".  If
-   * you use the attribute "device" from a thread other than the main
-   * thread, you must hold this mutex.
+   * This mutex protects modifications of the attributes "device" and
+   * "settings_sent".  If you use the attribute "device" from a thread
+   * other than the main thread, you must hold this mutex.
    */
   mutable Mutex mutex;
 
@@ -189,6 +189,15 @@ class DeviceDescriptor final : PortListener, PortLineSplitter {
    */
   NMEAParser parser;
 
+  /**
+   * The data parsed from this device's NMEA input by ParseLine().  It
+   * is owned by the thread which receives the input, and copies are
+   * passed to the DeviceBlackboard with
+   * DeviceBlackboard::StageDeviceData(), so the DeviceBlackboard
+   * mutex is not needed for parsing.
+   */
+  NMEAInfo parsed_data;
+
   /**
    * The settings that were sent to the device.  This is used to check
    * if the device is sending back the new configuration; then the
@@ -25,6 +25,7 @@ Copyright_License {
 #include "Message.hpp"
 #include "NMEA/Info.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "util/Compiler.h"
 
 #include <tchar.h>
@@ -215,6 +216,21 @@ PDTSM(NMEAInputLine &line, gcc_unused NMEAInfo &info)
   return true;
 }
 
+enum class VegaSentence : uint8_t {
+  PDSWC, PDAAV, PDVSC, PDVDV, PDVDS, PDVVT, PDVSD, PDTSM,
+};
+
+static constexpr NMEASentenceTable<VegaSentence, 8> sentences{{
+  {"PDSWC", VegaSentence::PDSWC},
+  {"PDAAV", VegaSentence::PDAAV},
+  {"PDVSC", VegaSentence::PDVSC},
+  {"PDVDV", VegaSentence::PDVDV},
+  {"PDVDS", VegaSentence::PDVDS},
+  {"PDVVT", VegaSentence::PDVVT},
+  {"PDVSD", VegaSentence::PDVSD},
+  {"PDTSM", VegaSentence::PDTSM},
+}};
+
 bool
 VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
 {
@@ -225,26 +241,43 @@ VegaDevice::ParseNMEA(const char *String, NMEAInfo &info)
   if (memcmp(type, "$PD", 3) == 0)
     detected = true;
 
-  if (StringIsEqual(type, "$PDSWC"))
+  if (type[0] != '$')
+    return false;
+
+  const auto *sentence = sentences.Find(type + 1);
+  if (sentence == nullptr)
+    return false;
+
+  switch (*sentence) {
+  case VegaSentence::PDSWC:
     return PDSWC(line, info, volatile_data);
-  else if (StringIsEqual(type, "$PDAAV"))
+
+  case VegaSentence::PDAAV:
     return PDAAV(line, info);
-  else if (StringIsEqual(type, "$PDVSC"))
+
+  case VegaSentence::PDVSC:
     return PDVSC(line, info);
-  else if (StringIsEqual(type, "$PDVDV"))
+
+  case VegaSentence::PDVDV:
     return PDVDV(line, info);
-  else if (StringIsEqual(type, "$PDVDS"))
+
+  case VegaSentence::PDVDS:
     return PDVDS(line, info);
-  else if (StringIsEqual(type, "$PDVVT"))
+
+  case VegaSentence::PDVVT:
     return PDVVT(line, info);
-  else if (StringIsEqual(type, "$PDVSD")) {
+
+  case VegaSentence::PDVSD: {
     const auto message = line.Rest();
     StaticString<256> buffer;
     buffer.SetASCII(message.begin(), message.end());
     Message::AddMessage(buffer);
     return true;
-  } else if (StringIsEqual(type, "$PDTSM"))
+  }
+
+  case VegaSentence::PDTSM:
     return PDTSM(line, info);
-  else
-    return false;
+  }
+
+  return false;
 }
@@ -28,10 +28,37 @@ Copyright_License {
 #include "NMEA/Info.hpp"
 #include "NMEA/Checksum.hpp"
 #include "NMEA/InputLine.hpp"
+#include "NMEA/SentenceTable.hpp"
 #include "Units/System.hpp"
 #include "Driver/FLARM/StaticParser.hpp"
 #include "util/CharUtil.hxx"
 
+enum class StandardSentence : uint8_t {
+  GSA, GLL, RMC, GGA, HDM, MWV,
+};
+
+static constexpr NMEASentenceTable<StandardSentence, 6> standard_sentences{{
+  {"GSA", StandardSentence::GSA},
+  {"GLL", StandardSentence::GLL},
+  {"RMC", StandardSentence::RMC},
+  {"GGA", StandardSentence::GGA},
+  {"HDM", StandardSentence::HDM},
+  {"MWV", StandardSentence::MWV},
+}};
+
+enum class ProprietarySentence : uint8_t {
+  PTAS1, PFLAE, PFLAV, PFLAA, PFLAU, PGRMZ,
+};
+
+static constexpr NMEASentenceTable<ProprietarySentence, 6> proprietary_sentences{{
+  {"PTAS1", ProprietarySentence::PTAS1},
+  {"PFLAE", ProprietarySentence::PFLAE},
+  {"PFLAV", ProprietarySentence::PFLAV},
+  {"PFLAA", ProprietarySentence::PFLAA},
+  {"PFLAU", ProprietarySentence::PFLAU},
+  {"PGRMZ", ProprietarySentence::PGRMZ},
+}};
+
 NMEAParser::NMEAParser()
 {
   Reset();
@@ -62,57 +89,63 @@ NMEAParser::ParseLine(const char *string, NMEAInfo &info)
   line.Read(type, 16);
 
   if (IsAlphaASCII(type[1]) && IsAlphaASCII(type[2])) {
-    if (StringIsEqual(type + 3, "GSA"))
-      return GSA(line, info);
+    /* standard sentence: the first two letters are the talker id */
+    const auto *sentence = standard_sentences.Find(type + 3);
+    if (sentence != nullptr) {
+      switch (*sentence) {
+      case StandardSentence::GSA:
+        return GSA(line, info);
 
-    if (StringIsEqual(type + 3, "GLL"))
-      return GLL(line, info);
+      case StandardSentence::GLL:
+        return GLL(line, info);
 
-    if (StringIsEqual(type + 3, "RMC"))
-      return RMC(line, info);
+      case StandardSentence::RMC:
+        return RMC(line, info);
 
-    if (StringIsEqual(type + 3, "GGA"))
-      return GGA(line, info);
+      case StandardSentence::GGA:
+        return GGA(line, info);
 
-    if (StringIsEqual(type + 3, "HDM"))
-      return HDM(line, info);
+      case StandardSentence::HDM:
+        return HDM(line, info);
 
-    if (StringIsEqual(type + 3, "MWV"))
-      return MWV(line, info);
+      case StandardSentence::MWV:
+        return MWV(line, info);
+      }
+    }
   }
 
   // if (proprietary sentence) ...
   if (type[1] == 'P') {
+    const auto *sentence = proprietary_sentences.Find(type + 1);
+    if (sentence == nullptr)
+      return false;
+
+    switch (*sentence) {
     // Airspeed and vario sentence
-    if (StringIsEqual(type + 1, "PTAS1"))
+    case ProprietarySentence::PTAS1:
       return PTAS1(line, info);
 
     // FLARM sentences
-    if (StringIsEqual(type + 1, "PFLAE")) {
+    case ProprietarySentence::PFLAE:
       ParsePFLAE(line, info.flarm.error, info.clock);
       return true;
-    }
 
-    if (StringIsEqual(type + 1, "PFLAV")) {
+    case ProprietarySentence::PFLAV:
       ParsePFLAV(line, info.flarm.version, info.clock);
       return true;
-    }
 
-    if (StringIsEqual(type + 1, "PFLAA")) {
+    case ProprietarySentence::PFLAA:
       ParsePFLAA(line, info.flarm.traffic, info.clock);
       return true;
-    }
 
-    if (StringIsEqual(type + 1, "PFLAU")) {
+    case ProprietarySentence::PFLAU:
       ParsePFLAU(line, info.flarm.status, info.clock);
       return true;
-    }
 
     // Garmin altitude sentence
-    if (StringIsEqual(type + 1, "PGRMZ"))
+    case ProprietarySentence::PGRMZ:
       return RMZ(line, info);
-
-    return false;
+    }
   }
 
   return false;
@@ -62,6 +62,12 @@ public:
   Airspace(AbstractAirspace &airspace,
            const FlatProjection &projection);
 
+  /**
+   * Constructor for an airspace whose bounding box is already known.
+   */
+  Airspace(AbstractAirspace &_airspace, const FlatBoundingBox &box) noexcept
+    :FlatBoundingBox(box), airspace(&_airspace) {}
+
   /**
    * Checks whether an aircraft is inside the airspace.
    *
@@ -48,6 +48,13 @@ public:
    */
   AirspaceCircle(const GeoPoint &loc, const double _radius);
 
+  /**
+   * Constructor with a precalculated (and projected) border, e.g.
+   * loaded from a cache file.
+   */
+  AirspaceCircle(const GeoPoint &loc, const double _radius,
+                 SearchPointVector &&border) noexcept;
+
   /* virtual methods from class AbstractAirspace */
   const GeoPoint GetReferenceLocation() const override {
     return m_center;
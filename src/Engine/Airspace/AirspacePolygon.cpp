@@ -51,6 +51,21 @@ AirspacePolygon::AirspacePolygon(const std::vector<GeoPoint> &pts,
   } else {
     is_convex = TriState::UNKNOWN;
   }
+
+  arrays.SetLocations(m_border);
+}
+
+AirspacePolygon::AirspacePolygon(SearchPointVector &&border) noexcept
+  :AbstractAirspace(Shape::POLYGON)
+{
+  assert(border.size() >= 3);
+  assert(border.front().GetLocation() == border.back().GetLocation());
+
+  m_border = std::move(border);
+  is_convex = TriState::UNKNOWN;
+
+  arrays.SetLocations(m_border);
+  arrays.SetFlatLocations(m_border);
 }
 
 const GeoPoint
@@ -82,6 +97,9 @@ AirspacePolygon::GetCenter() const
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const
 {
+  if (arrays.IsDefined())
+    return arrays.IsInside(loc);
+
   return m_border.IsInside(loc);
 }
 
@@ -94,6 +112,13 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
 
   AirspaceIntersectSort sorter(start, *this);
 
+  if (arrays.IsProjected()) {
+    arrays.VisitIntersections(ray, [&](double t){
+      sorter.add(t, projection.Unproject(ray.Parametric(t)));
+    });
+    return sorter.all();
+  }
+
   for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
 
     const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
@@ -110,6 +135,15 @@ AirspacePolygon::ClosestPoint(const GeoPoint &loc,
                               const FlatProjection &projection) const
 {
   const auto p = projection.ProjectInteger(loc);
-  const auto pb = m_border.NearestPoint(p);
+  const auto pb = arrays.IsProjected()
+    ? arrays.NearestPoint(p)
+    : m_border.NearestPoint(p);
   return projection.Unproject(pb);
 }
+
+void
+AirspacePolygon::Project(const FlatProjection &tp)
+{
+  AbstractAirspace::Project(tp);
+  arrays.SetFlatLocations(m_border);
+}
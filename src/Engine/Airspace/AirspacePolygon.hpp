@@ -24,6 +24,8 @@
 #define AIRSPACEPOLYGON_HPP
 
 #include "AbstractAirspace.hpp"
+#include "Geo/SearchPointArrays.hpp"
+
 #include <vector>
 
 #ifdef DO_PRINT
@@ -32,6 +34,12 @@
 
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * A copy of #m_border for the vectorised kernels; undefined for
+   * small polygons, which use the scalar #SearchPointVector code.
+   */
+  SearchPointArrays arrays;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -44,6 +52,12 @@ public:
    */
   AirspacePolygon(const std::vector<GeoPoint> &pts, const bool prune = false);
 
+  /**
+   * Constructor for a border which has already been closed and
+   * projected, e.g. loaded from a cache file.
+   */
+  explicit AirspacePolygon(SearchPointVector &&border) noexcept;
+
   /* virtual methods from class AbstractAirspace */
   const GeoPoint GetReferenceLocation() const override;
   const GeoPoint GetCenter() const override;
@@ -54,6 +68,9 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const override;
 
+protected:
+  void Project(const FlatProjection &tp) override;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
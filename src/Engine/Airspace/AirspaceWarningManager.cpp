@@ -28,6 +28,8 @@
 #include "AirspaceAircraftPerformance.hpp"
 #include "Task/Stats/TaskStats.hpp"
 
+#include <algorithm>
+
 #define CRUISE_FILTER_FACT 0.5
 
 AirspaceWarningManager::AirspaceWarningManager(const AirspaceWarningConfig &_config,
@@ -61,10 +63,19 @@ AirspaceWarningManager::SetConfig(const AirspaceWarningConfig &_config)
 }
 
 void
-AirspaceWarningManager::Reset(const AircraftState &state)
+AirspaceWarningManager::clear()
 {
   ++serial;
-  warnings.clear();
+  pool.clear();
+  free_slots.clear();
+  index.clear();
+  order.clear();
+}
+
+void
+AirspaceWarningManager::Reset(const AircraftState &state)
+{
+  clear();
   cruise_filter.Reset(state);
   circling_filter.Reset(state);
 }
@@ -92,28 +103,48 @@ AirspaceWarningManager::GetWarning(const AbstractAirspace &airspace)
     return *warning;
 
   // not found, create new entry
-  ++serial;
-  warnings.emplace_back(airspace);
-  return warnings.back();
+  return *GetNewWarningPtr(airspace);
 }
 
 
 AirspaceWarning* 
 AirspaceWarningManager::GetWarningPtr(const AbstractAirspace &airspace)
 {
-  for (auto &w : warnings)
-    if (&(w.GetAirspace()) == &airspace)
-      return &w;
+  const auto i = index.find(&airspace);
+  if (i == index.end())
+    return nullptr;
 
-  return nullptr;
+  return &*pool[i->second];
 }
 
 AirspaceWarning*
 AirspaceWarningManager::GetNewWarningPtr(const AbstractAirspace &airspace)
 {
   ++serial;
-  warnings.emplace_back(airspace);
-  return &warnings.back();
+
+  unsigned slot;
+  if (free_slots.empty()) {
+    slot = pool.size();
+    pool.emplace_back(std::in_place, airspace);
+  } else {
+    slot = free_slots.back();
+    free_slots.pop_back();
+    pool[slot].emplace(airspace);
+  }
+
+  index.emplace(&airspace, slot);
+  order.push_back(slot);
+  return &*pool[slot];
+}
+
+void
+AirspaceWarningManager::SortWarnings() noexcept
+{
+  /* stable, just like the std::list::sort() which was used before */
+  std::stable_sort(order.begin(), order.end(),
+                   [this](unsigned a, unsigned b){
+                     return *pool[a] < *pool[b];
+                   });
 }
 
 bool 
@@ -128,13 +159,13 @@ AirspaceWarningManager::Update(const AircraftState& state,
   // update warning states
   if (airspaces.IsEmpty()) {
     // no airspaces, no warnings possible
-    assert(warnings.empty());
+    assert(order.empty());
     return false;
   }
 
   // save old state
-  for (auto &w : warnings)
-    w.SaveState();
+  for (const unsigned slot : order)
+    pool[slot]->SaveState();
 
   // check from strongest to weakest alerts
   UpdateInside(state, glide_polar);
@@ -143,20 +174,26 @@ AirspaceWarningManager::Update(const AircraftState& state,
   UpdateTask(state, glide_polar, task_stats);
 
   // action changes
-  for (auto it = warnings.begin(), end = warnings.end(); it != end;) {
-    if (it->WarningLive(config.acknowledgement_time, dt)) {
-      if (it->ChangedState())
+  auto live_end = order.begin();
+  for (const unsigned slot : order) {
+    AirspaceWarning &w = *pool[slot];
+    if (w.WarningLive(config.acknowledgement_time, dt)) {
+      if (w.ChangedState())
         changed = true;
 
-      it++;
+      *live_end++ = slot;
     } else {
       ++serial;
-      it = warnings.erase(it);
+      index.erase(&w.GetAirspace());
+      pool[slot].reset();
+      free_slots.push_back(slot);
     }
   }
 
+  order.erase(live_end, order.end());
+
   // sort by importance, most severe top
-  warnings.sort();
+  SortWarnings();
 
   return changed;
 }
@@ -470,8 +507,8 @@ AirspaceWarningManager::IsActive(const AbstractAirspace &airspace) const
 void 
 AirspaceWarningManager::AcknowledgeAll()
 {
-  for (auto &w : warnings) {
-    w.AcknowledgeWarning(true);
-    w.AcknowledgeInside(true);
+  for (const unsigned slot : order) {
+    pool[slot]->AcknowledgeWarning(true);
+    pool[slot]->AcknowledgeInside(true);
   }
 }
@@ -25,8 +25,11 @@
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
 #include "Util/AircraftStateFilter.hpp"
+#include "util/FlatHashMap.hpp"
 
-#include <list>
+#include <iterator>
+#include <optional>
+#include <vector>
 
 class TaskStats;
 class GlidePolar;
@@ -56,9 +59,27 @@ class AirspaceWarningManager {
   AircraftStateFilter cruise_filter;
   AircraftStateFilter circling_filter;
 
-  typedef std::list<AirspaceWarning> AirspaceWarningList;
+  /**
+   * All warnings.  The slots of removed warnings are recycled (see
+   * #free_slots), so the table does not allocate memory once it has
+   * grown to the usual number of warnings.
+   */
+  std::vector<std::optional<AirspaceWarning>> pool;
 
-  AirspaceWarningList warnings;
+  /**
+   * Unused slots in #pool.
+   */
+  std::vector<unsigned> free_slots;
+
+  /**
+   * Maps each airspace to its slot in #pool.
+   */
+  FlatHashMap<const AbstractAirspace *, unsigned> index;
+
+  /**
+   * The slots of all warnings, most severe first.
+   */
+  std::vector<unsigned> order;
 
   /**
    * This number is incremented each time this object is modified.
@@ -66,7 +87,47 @@ class AirspaceWarningManager {
   unsigned serial;
 
 public:
-  typedef AirspaceWarningList::const_iterator const_iterator;
+  /**
+   * Iterates over all warnings, most severe first.
+   */
+  class const_iterator {
+    friend class AirspaceWarningManager;
+
+    const std::optional<AirspaceWarning> *pool;
+    std::vector<unsigned>::const_iterator i;
+
+    const_iterator(const std::optional<AirspaceWarning> *_pool,
+                   std::vector<unsigned>::const_iterator _i) noexcept
+      :pool(_pool), i(_i) {}
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef AirspaceWarning value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const AirspaceWarning &reference;
+    typedef const AirspaceWarning *pointer;
+
+    reference operator*() const noexcept {
+      return *pool[*i];
+    }
+
+    pointer operator->() const noexcept {
+      return &*pool[*i];
+    }
+
+    const_iterator &operator++() noexcept {
+      ++i;
+      return *this;
+    }
+
+    bool operator==(const const_iterator &other) const noexcept {
+      return i == other.i;
+    }
+
+    bool operator!=(const const_iterator &other) const noexcept {
+      return i != other.i;
+    }
+  };
 
   /** 
    * Default constructor
@@ -110,6 +171,10 @@ public:
    * predictor not used, since a long term prediction is not valid
    * if in cruise mode.
    *
+   * The cost is linear in the number of warnings: each of them is
+   * found again by the intersection search, its acknowledgement
+   * timers count down, and the list is sorted again.
+   *
    * @param state Current aircraft state
    * @param circling Whether aircraft is circling
    * @param dt Time step since last update
@@ -172,16 +237,13 @@ public:
    */
   [[gnu::pure]]
   bool empty() const {
-    return warnings.empty();
+    return order.empty();
   }
 
   /**
    * Clear all warnings
    */
-  void clear() {
-    ++serial;
-    warnings.clear();
-  }
+  void clear();
 
   /**
    * Acknowledge all active warnings
@@ -193,18 +255,18 @@ public:
    *
    * @return Number of items in warning list
    */
-  AirspaceWarningList::size_type size() const {
-    return warnings.size();
+  std::size_t size() const {
+    return order.size();
   }
 
   [[gnu::pure]]
   const_iterator begin() const {
-    return warnings.begin();
+    return {pool.data(), order.begin()};
   }
 
   [[gnu::pure]]
   const_iterator end() const {
-    return warnings.end();
+    return {pool.data(), order.end()};
   }
 
   /**
@@ -260,6 +322,11 @@ public:
   bool IsActive(const AbstractAirspace &airspace) const;
 
 private:
+  /**
+   * Sort #order by severity.
+   */
+  void SortWarnings() noexcept;
+
   bool UpdateTask(const AircraftState &state, const GlidePolar &glide_polar,
                   const TaskStats &task_stats);
   bool UpdateFilter(const AircraftState& state, const bool circling);
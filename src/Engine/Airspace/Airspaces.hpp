@@ -86,7 +86,8 @@ public:
   /**
    * Add airspace to the internal airspace tree.
    * The airspace is not copied; ownership is transferred to this class if
-   * m_owner is true
+   * m_owner is true.  It is only queued; the tree is rebuilt by the
+   * next Optimise() call.
    *
    * @param asp New airspace to be added.
    */
@@ -96,9 +97,20 @@ public:
    * Re-organise the internal airspace tree after inserting/deleting.
    * Should be called after inserting/deleting airspaces prior to performing
    * any searches, but can be done once after a batch insert/delete.
+   * The tree is bulk-loaded (packed) from all airspaces.
    */
   void Optimise();
 
+  /**
+   * Replace the contents of this (owning) container with airspaces
+   * whose borders have already been projected with the given
+   * projection, e.g. loaded from a cache file which was written
+   * after Optimise().  The search tree is bulk-loaded from the
+   * envelopes, without projecting or inserting them one by one.
+   * Takes ownership of the #AbstractAirspace objects.
+   */
+  void Restore(const TaskProjection &projection, AirspaceVector &&items);
+
   /**
    * Clear the airspace store, deleting airspace objects if m_owner is true
    */
@@ -209,6 +221,10 @@ public:
     return task_projection;
   }
 
+  const TaskProjection &GetTaskProjection() const {
+    return task_projection;
+  }
+
   /**
    * Empty clearance polygons of all airspaces in this database
    */
@@ -22,6 +22,9 @@
 
 #include "ContestManager.hpp"
 
+#include <algorithm>
+#include <thread>
+
 ContestManager::ContestManager(const Contest _contest,
                                const Trace &trace_full,
                                const Trace &trace_triangle,
@@ -41,7 +44,9 @@ ContestManager::ContestManager(const Contest _contest,
    net_coupe(trace_full),
    weglide_distance(trace_full),
    weglide_fai(trace_triangle, predict_triangle),
-   weglide_or(trace_full)
+   weglide_or(trace_full),
+   n_solver_threads(std::clamp(std::thread::hardware_concurrency(),
+                               1u, MAX_PARALLEL) - 1)
 {
   Reset();
 }
@@ -102,16 +107,22 @@ ContestManager::SetHandicap(unsigned handicap) noexcept
   weglide_or.SetHandicap(handicap);
 }
 
+/**
+ * Copy the solution of a solver which has returned #r.
+ */
 static bool
-RunContest(AbstractContest &_contest,
-           ContestResult &result, ContestTraceVector &solution,
-           bool exhaustive) noexcept
+CollectContest(const AbstractContest &_contest, SolverResult r,
+               ContestResult &result, ContestTraceVector &solution) noexcept
 {
-  // run solver, return immediately if further processing is required
-  // by subsequent calls
-  SolverResult r = _contest.Solve(exhaustive);
-  if (r != SolverResult::VALID)
+  // return immediately if further processing is required by
+  // subsequent calls
+  if (r != SolverResult::VALID) {
+    // but report the progress of anytime solvers
+    const ContestResult &best = _contest.GetBestResult();
+    result.progress = best.progress;
+    result.gap = best.gap;
     return false;
+  }
 
   // if no improved solution was found, must have finished processing
   // with invalid data
@@ -125,6 +136,46 @@ RunContest(AbstractContest &_contest,
   return true;
 }
 
+static bool
+RunContest(AbstractContest &_contest,
+           ContestResult &result, ContestTraceVector &solution,
+           bool exhaustive) noexcept
+{
+  return CollectContest(_contest, _contest.Solve(exhaustive),
+                        result, solution);
+}
+
+bool
+ContestManager::RunParallel(std::initializer_list<SolverJob> jobs,
+                            bool exhaustive) noexcept
+{
+  assert(jobs.size() > 0);
+  assert(jobs.size() <= MAX_PARALLEL);
+
+  /* the solvers share only the (read-only) Trace objects, so all but
+     the first one can be moved to other threads */
+  const unsigned n_threads =
+    std::min<unsigned>(jobs.size() - 1, n_solver_threads);
+  for (unsigned i = 0; i < n_threads; ++i)
+    solver_threads[i].Start(jobs.begin()[i + 1].contest, exhaustive);
+
+  std::array<SolverResult, MAX_PARALLEL> r;
+  r[0] = jobs.begin()->contest.Solve(exhaustive);
+  for (unsigned i = n_threads + 1; i < jobs.size(); ++i)
+    r[i] = jobs.begin()[i].contest.Solve(exhaustive);
+
+  for (unsigned i = 0; i < n_threads; ++i)
+    r[i + 1] = solver_threads[i].Wait();
+
+  bool retval = false;
+  for (unsigned i = 0; i < jobs.size(); ++i) {
+    const auto &job = jobs.begin()[i];
+    retval |= CollectContest(job.contest, r[i], job.result, job.solution);
+  }
+
+  return retval;
+}
+
 bool
 ContestManager::UpdateIdle(bool exhaustive) noexcept
 {
@@ -160,11 +211,10 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::OLC_PLUS:
-    retval = RunContest(olc_classic, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(olc_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunParallel({
+        {olc_classic, stats.result[0], stats.solution[0]},
+        {olc_fai, stats.result[1], stats.solution[1]},
+      }, exhaustive);
 
     if (retval) {
       olc_plus.Feed(stats.result[0], stats.solution[0],
@@ -182,17 +232,17 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::XCONTEST:
-    retval = RunContest(xcontest_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(xcontest_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunParallel({
+        {xcontest_free, stats.result[0], stats.solution[0]},
+        {xcontest_triangle, stats.result[1], stats.solution[1]},
+      }, exhaustive);
     break;
 
   case Contest::DHV_XC:
-    retval = RunContest(dhv_xc_free, stats.result[0],
-                        stats.solution[0], exhaustive);
-    retval |= RunContest(dhv_xc_triangle, stats.result[1],
-                         stats.solution[1], exhaustive);
+    retval = RunParallel({
+        {dhv_xc_free, stats.result[0], stats.solution[0]},
+        {dhv_xc_triangle, stats.result[1], stats.solution[1]},
+      }, exhaustive);
     break;
 
   case Contest::SIS_AT:
@@ -206,14 +256,11 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
     break;
 
   case Contest::WEGLIDE_FREE:
-    retval = RunContest(weglide_distance, stats.result[0],
-                        stats.solution[0], exhaustive);
-
-    retval |= RunContest(weglide_fai, stats.result[1],
-                         stats.solution[1], exhaustive);
-
-    retval |= RunContest(weglide_or, stats.result[2],
-                         stats.solution[2], exhaustive);
+    retval = RunParallel({
+        {weglide_distance, stats.result[0], stats.solution[0]},
+        {weglide_fai, stats.result[1], stats.solution[1]},
+        {weglide_or, stats.result[2], stats.solution[2]},
+      }, exhaustive);
 
     if (retval) {
       weglide_free.Feed(stats.result[0], stats.solution[0],
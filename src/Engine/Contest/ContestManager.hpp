@@ -39,6 +39,10 @@
 #include "Solvers/WeglideFAI.hpp"
 #include "Solvers/WeglideOR.hpp"
 #include "ContestStatistics.hpp"
+#include "SolverThread.hpp"
+
+#include <array>
+#include <initializer_list>
 
 class Trace;
 
@@ -70,6 +74,25 @@ class ContestManager
   WeglideFAI weglide_fai;
   WeglideOR weglide_or;
 
+  /**
+   * The largest number of solvers which do not depend on each other
+   * (the three parts of WeGlide Free).
+   */
+  static constexpr unsigned MAX_PARALLEL = 3;
+
+  /**
+   * Threads for solvers which do not depend on each other (e.g. the
+   * OLC Classic and FAI parts of OLC Plus).  The calling thread
+   * always runs one of them itself.
+   */
+  std::array<ContestSolverThread, MAX_PARALLEL - 1> solver_threads;
+
+  /**
+   * The number of #solver_threads which may be used, limited by the
+   * number of CPU cores.
+   */
+  unsigned n_solver_threads;
+
 public:
   /**
    * Base constructor.
@@ -133,11 +156,42 @@ public:
     return SolveExhaustive();
   }
 
+  /**
+   * Limit the wall-clock time which the triangle solvers may use in
+   * each UpdateIdle() call.
+   *
+   * @see TriangleContest::SetTickBudget()
+   */
+  void SetTriangleTickBudget(std::chrono::steady_clock::duration budget) noexcept {
+    olc_fai.SetTickBudget(budget);
+    xcontest_triangle.SetTickBudget(budget);
+    dhv_xc_triangle.SetTickBudget(budget);
+    weglide_fai.SetTickBudget(budget);
+  }
+
   /**
    * Reset the task (as if never flown)
    */
   void Reset() noexcept;
 
+private:
+  struct SolverJob {
+    AbstractContest &contest;
+    ContestResult &result;
+    ContestTraceVector &solution;
+  };
+
+  /**
+   * Run the given solvers concurrently (as far as #solver_threads
+   * allow) and copy their results.
+   *
+   * @return true if at least one of them has found a new solution
+   */
+  bool RunParallel(std::initializer_list<SolverJob> jobs,
+                   bool exhaustive) noexcept;
+
+public:
+
   const ContestStatistics &GetStats() const noexcept {
     return stats;
   }
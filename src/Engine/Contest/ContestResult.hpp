@@ -34,10 +34,32 @@ struct ContestResult
   /** Time (s) of optimised OLC path */
   double time;
 
+  /**
+   * Progress of the solver (0..1).  Anytime solvers which are
+   * suspended between ticks report values below 1; all others report
+   * 1 once they have a result.
+   *
+   * This is an estimate, and it is not monotonic: it drops when a
+   * new search is started because the trace has changed, and it may
+   * also drop during a search when the solver discovers more work
+   * (e.g. TriangleContest's "close look" ranges).  Use #gap to see
+   * how far the result may still improve.
+   */
+  double progress;
+
+  /**
+   * Upper bound of the relative improvement which the solver may
+   * still find: (upper_bound - distance) / upper_bound.  Zero means
+   * the result is known to be optimal.
+   */
+  double gap;
+
   constexpr void Reset() noexcept {
     score = 0;
     distance = 0;
     time = 0;
+    progress = 0;
+    gap = 0;
   }
 
   constexpr bool IsDefined() const noexcept {
@@ -0,0 +1,80 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "SolverThread.hpp"
+#include "Solvers/AbstractContest.hpp"
+
+ContestSolverThread::ContestSolverThread() noexcept
+  :StandbyThread("ContestSolver") {}
+
+ContestSolverThread::~ContestSolverThread() noexcept
+{
+  LockStop();
+}
+
+void
+ContestSolverThread::Start(AbstractContest &_contest,
+                           bool _exhaustive) noexcept
+{
+  const std::lock_guard<Mutex> lock(mutex);
+
+  contest = &_contest;
+  exhaustive = _exhaustive;
+  done = false;
+  Trigger();
+}
+
+SolverResult
+ContestSolverThread::Wait() noexcept
+{
+  assert(contest != nullptr);
+
+  {
+    std::unique_lock<Mutex> lock(mutex);
+    WaitDone(lock);
+
+    if (done)
+      return result;
+  }
+
+  /* the thread is not running; do it here */
+  return contest->Solve(exhaustive);
+}
+
+void
+ContestSolverThread::Tick() noexcept
+{
+  AbstractContest &c = *contest;
+  const bool e = exhaustive;
+
+  SolverResult r;
+
+  {
+    const ScopeUnlock unlock(mutex);
+    r = c.Solve(e);
+  }
+
+  result = r;
+  done = true;
+}
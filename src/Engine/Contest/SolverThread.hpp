@@ -0,0 +1,75 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_CONTEST_SOLVER_THREAD_HPP
+#define XCSOAR_CONTEST_SOLVER_THREAD_HPP
+
+#include "thread/StandbyThread.hpp"
+#include "PathSolvers/SolverResult.hpp"
+
+class AbstractContest;
+
+/**
+ * A thread which runs one contest solver in background.  This allows
+ * #ContestManager to run solvers which do not depend on each other
+ * concurrently.  The thread is launched on the first Start() call
+ * and stays alive until this object is destructed.
+ */
+class ContestSolverThread final : StandbyThread {
+  AbstractContest *contest = nullptr;
+  bool exhaustive;
+
+  /**
+   * Has Tick() finished the current job?
+   */
+  bool done;
+
+  SolverResult result;
+
+public:
+  ContestSolverThread() noexcept;
+  ~ContestSolverThread() noexcept;
+
+  /**
+   * Begin solving the given contest in background.  Must not be
+   * called while the previous job is still running, i.e. before
+   * Wait().
+   */
+  void Start(AbstractContest &_contest, bool _exhaustive) noexcept;
+
+  /**
+   * Wait until the job started with Start() is finished.  If the
+   * thread could not be launched, the job is run in the calling
+   * thread instead.
+   *
+   * @return the return value of AbstractContest::Solve()
+   */
+  SolverResult Wait() noexcept;
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override;
+};
+
+#endif
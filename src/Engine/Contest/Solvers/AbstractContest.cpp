@@ -48,8 +48,13 @@ AbstractContest::SaveSolution() noexcept
   ContestResult result = CalculateResult();
   const bool improved = result.score > best_result.score;
 
-  if (!improved)
+  if (!improved) {
+    /* the solver may have made progress even if the score has not
+       improved */
+    best_result.progress = result.progress;
+    best_result.gap = result.gap;
     return false;
+  }
 
   best_result = result;
   CopySolution(best_solution);
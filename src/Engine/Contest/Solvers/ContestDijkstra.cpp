@@ -179,6 +179,8 @@ ContestDijkstra::CalculateResult(const ContestTraceVector &solution) const noexc
   ContestResult result;
   result.time = solution[num_stages - 1].DeltaTime(solution[0]);
   result.distance = result.score = 0;
+  result.progress = 1;
+  result.gap = 0;
 
   GeoPoint previous = solution[0].GetLocation();
   for (unsigned i = 1; i < num_stages; ++i) {
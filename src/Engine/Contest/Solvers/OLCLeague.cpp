@@ -101,5 +101,7 @@ OLCLeague::CalculateResult() const noexcept
   for (unsigned i = 0; i < 4; ++i)
     result.distance += solution[i].DistanceTo(solution[i + 1].GetLocation());
   result.score = ApplyShiftedHandicap(result.distance / 2500);
+  result.progress = 1;
+  result.gap = 0;
   return result;
 }
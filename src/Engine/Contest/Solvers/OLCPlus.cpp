@@ -22,6 +22,8 @@
 
 #include "OLCPlus.hpp"
 
+#include <algorithm>
+
 OLCPlus::OLCPlus() noexcept
   :AbstractContest(0)
 {
@@ -57,5 +59,7 @@ OLCPlus::CalculateResult() const noexcept
   ContestResult result = result_classic;
   result.score = ApplyHandicap((result_classic.distance +
                                 0.3 * result_fai.distance) / 1000);
+  result.progress = std::min(result_classic.progress, result_fai.progress);
+  result.gap = std::max(result_classic.gap, result_fai.gap);
   return result;
 }
@@ -23,6 +23,7 @@
 #include "TriangleContest.hpp"
 #include "Cast.hpp"
 #include "Trace/Trace.hpp"
+#include "time/TimeoutClock.hpp"
 #include "util/QuadTree.hxx"
 
 /*
@@ -87,6 +88,14 @@ TriangleContest::ResetBranchAndBound() noexcept
 {
   running = false;
   branch_and_bound.clear();
+
+  search_ranges.clear();
+  search_position = 0;
+  range_started = false;
+  close_look_started = false;
+  close_look.Clear();
+  close_look_bound = 0;
+  abandoned_bound = 0;
 }
 
 gcc_pure
@@ -170,136 +179,189 @@ TriangleContest::Solve(bool exhaustive) noexcept
 }
 
 void
-TriangleContest::SolveTriangle(bool exhaustive) noexcept
+TriangleContest::StartSearch() noexcept
 {
-  unsigned tp1 = 0,
-           tp2 = 0,
-           tp3 = 0,
-           start = 0,
-           finish = 0;
+  ClosingPairs relaxed_pairs;
 
-  if (exhaustive || !predict) {
-    ClosingPairs relaxed_pairs;
+  unsigned relax = n_points * 0.03;
 
-    unsigned relax = n_points * 0.03;
+  // for all closed trace loops
+  for (auto closing_pair = closing_pairs.closing_pairs.begin();
+       closing_pair != closing_pairs.closing_pairs.end();
+       ++closing_pair) {
 
-    // for all closed trace loops
-    for (auto closing_pair = closing_pairs.closing_pairs.begin();
-         closing_pair != closing_pairs.closing_pairs.end();
-         ++closing_pair) {
+    auto already_relaxed = relaxed_pairs.FindRange(*closing_pair);
+    if (already_relaxed.first != 0 || already_relaxed.second != 0)
+      // this pair is already relaxed... continue with next
+      continue;
 
-      auto already_relaxed = relaxed_pairs.FindRange(*closing_pair);
-      if (already_relaxed.first != 0 || already_relaxed.second != 0)
-        // this pair is already relaxed... continue with next
-        continue;
+    unsigned relax_first = closing_pair->first;
+    unsigned relax_last = closing_pair->second;
 
-      unsigned relax_first = closing_pair->first;
-      unsigned relax_last = closing_pair->second;
+    const unsigned max_first = closing_pair->first + relax;
+    const unsigned max_last = closing_pair->second + relax;
 
-      const unsigned max_first = closing_pair->first + relax;
-      const unsigned max_last = closing_pair->second + relax;
+    for (auto relaxed = std::next(closing_pair);
+         relaxed != closing_pairs.closing_pairs.end() &&
+         relaxed->first <= max_first && relaxed->second <= max_last;
+         ++relaxed)
+      relax_last = std::max(relax_last, relaxed->second);
 
-      for (auto relaxed = std::next(closing_pair);
-           relaxed != closing_pairs.closing_pairs.end() &&
-           relaxed->first <= max_first && relaxed->second <= max_last;
-           ++relaxed)
-        relax_last = std::max(relax_last, relaxed->second);
+    relaxed_pairs.Insert(ClosingPair(relax_first, relax_last));
+  }
 
-      relaxed_pairs.Insert(ClosingPair(relax_first, relax_last));
-    }
+  // TODO: reverse sort relaxed pairs according to number of contained points
 
-    // TODO: reverse sort relaxed pairs according to number of contained points
-
-    ClosingPairs close_look;
-
-    for (const auto relaxed_pair : relaxed_pairs.closing_pairs) {
-
-      const auto triangle = RunBranchAndBound(relaxed_pair.first,
-                                              relaxed_pair.second,
-                                              best_d, exhaustive);
-
-      if (std::get<3>(triangle) > best_d) {
-        // solution is better than best_d
-        // only if triangle is inside a unrelaxed pair...
-
-        auto unrelaxed = closing_pairs.FindRange(ClosingPair(std::get<0>(triangle), std::get<2>(triangle)));
-        if (unrelaxed.first != 0 || unrelaxed.second != 0) {
-          // fortunately it is inside a unrelaxed closing pair :-)
-          start = unrelaxed.first;
-          tp1 = std::get<0>(triangle);
-          tp2 = std::get<1>(triangle);
-          tp3 = std::get<2>(triangle);
-          finish = unrelaxed.second;
-
-          best_d = std::get<3>(triangle);
-        } else {
-          // otherwise we should solve the triangle again for every unrelaxed pair
-          // contained inside the current relaxed pair. *damn!*
-          for (const auto closing_pair : closing_pairs.closing_pairs) {
-            if (closing_pair.first >= relaxed_pair.first &&
-                closing_pair.second <= relaxed_pair.second)
-              close_look.Insert(closing_pair);
-         }
-       }
-      }
+  ResetBranchAndBound();
+
+  for (const auto &relaxed_pair : relaxed_pairs.closing_pairs)
+    search_ranges.push_back({relaxed_pair, GetRangeBound(relaxed_pair)});
+
+  running = true;
+}
+
+void
+TriangleContest::AbandonRange() noexcept
+{
+  if (!branch_and_bound.empty())
+    abandoned_bound = std::max(abandoned_bound,
+                               branch_and_bound.rbegin()->first);
+
+  branch_and_bound.clear();
+  range_started = false;
+}
+
+void
+TriangleContest::CheckTriangle(const ClosingPair &range,
+                               const std::tuple<unsigned, unsigned,
+                                                unsigned, unsigned> &triangle) noexcept
+{
+  if (std::get<3>(triangle) <= best_d)
+    return;
+
+  // solution is better than best_d
+
+  ClosingPair closing_pair = range;
+
+  if (!close_look_started) {
+    // only if triangle is inside a unrelaxed pair...
+    closing_pair = closing_pairs.FindRange(ClosingPair(std::get<0>(triangle),
+                                                       std::get<2>(triangle)));
+    if (closing_pair.first == 0 && closing_pair.second == 0) {
+      // otherwise we should solve the triangle again for every unrelaxed pair
+      // contained inside the current relaxed pair. *damn!*
+      for (const auto &i : closing_pairs.closing_pairs)
+        if (i.first >= range.first && i.second <= range.second)
+          close_look.Insert(i);
+
+      close_look_bound = std::max(close_look_bound, std::get<3>(triangle));
+      return;
     }
+  }
 
-    for (const auto &close_look_pair : close_look.closing_pairs) {
-      const auto triangle = RunBranchAndBound(close_look_pair.first,
-                                              close_look_pair.second,
-                                              best_d, exhaustive);
+  best_d = std::get<3>(triangle);
 
-      if (std::get<3>(triangle) > best_d) {
-        // solution is better than best_d
+  solution.resize(5);
 
-        start = close_look_pair.first;
-        tp1 = std::get<0>(triangle);
-        tp2 = std::get<1>(triangle);
-        tp3 = std::get<2>(triangle);
-        finish = close_look_pair.second;
+  solution[0] = TraceManager::GetPoint(closing_pair.first);
+  solution[1] = TraceManager::GetPoint(std::get<0>(triangle));
+  solution[2] = TraceManager::GetPoint(std::get<1>(triangle));
+  solution[3] = TraceManager::GetPoint(std::get<2>(triangle));
+  solution[4] = TraceManager::GetPoint(closing_pair.second);
+}
 
-        best_d = std::get<3>(triangle);
+void
+TriangleContest::SolveTriangle(bool exhaustive) noexcept
+{
+  if (!running)
+    StartSearch();
+
+  /* non-exhaustive runs are limited by tick_iterations and
+     tick_budget; the search is resumed by the next call */
+  const TimeoutClock timeout(tick_budget);
+  const TimeoutClock *const timeout_ptr =
+    !exhaustive && tick_budget > tick_budget.zero()
+    ? &timeout
+    : nullptr;
+
+  unsigned budget = exhaustive ? max_iterations : tick_iterations;
+
+  while (true) {
+    if (search_position == search_ranges.size()) {
+      if (close_look_started || close_look.closing_pairs.empty()) {
+        // the search is complete
+        running = false;
+        break;
       }
-    }
 
-  } else {
-    /**
-     * We're currently running in predictive, non-exhaustive mode, so we use
-     * one closing pair only (0 -> n_points-1) which allows us to suspend the
-     * solver...
-     */
-    const auto triangle = RunBranchAndBound(0, n_points - 1, best_d, false);
+      // now search the unrelaxed pairs which need a close look
+      for (const auto &close_look_pair : close_look.closing_pairs)
+        search_ranges.push_back({close_look_pair,
+                                 GetRangeBound(close_look_pair)});
 
-    if (std::get<3>(triangle) > best_d) {
-      // solution is better than best_d
+      close_look_started = true;
+      close_look_bound = 0;
+      continue;
+    }
 
-      start = 0;
-      tp1 = std::get<0>(triangle);
-      tp2 = std::get<1>(triangle);
-      tp3 = std::get<2>(triangle);
-      finish = n_points - 1;
+    const ClosingPair range = search_ranges[search_position].pair;
+    CheckTriangle(range,
+                  RunBranchAndBound(range.first, range.second,
+                                    best_d, budget, timeout_ptr));
 
-      best_d = std::get<3>(triangle);
+    if (range_started) {
+      if (!exhaustive)
+        // the budget is used up; suspend until the next tick
+        break;
+
+      // exhaustive runs cannot be suspended; give up on this range
+      AbandonRange();
     }
-  }
 
-  if (best_d > 0) {
-    solution.resize(5);
+    ++search_position;
 
-    solution[0] = TraceManager::GetPoint(start);
-    solution[1] = TraceManager::GetPoint(tp1);
-    solution[2] = TraceManager::GetPoint(tp2);
-    solution[3] = TraceManager::GetPoint(tp3);
-    solution[4] = TraceManager::GetPoint(finish);
+    if (exhaustive)
+      // in exhaustive mode, max_iterations applies to each range
+      budget = max_iterations;
+  }
 
+  if (best_d > 0)
     is_complete = true;
-  }
 }
 
+unsigned
+TriangleContest::GetRangeBound(const ClosingPair &pair) const noexcept
+{
+  return CandidateSet(*this, pair.first, pair.second + 1).df_max;
+}
+
+unsigned
+TriangleContest::GetUpperBound() const noexcept
+{
+  unsigned bound = std::max(best_d, abandoned_bound);
+
+  if (!running)
+    return bound;
+
+  if (!close_look_started)
+    bound = std::max(bound, close_look_bound);
+
+  for (unsigned i = search_position; i < search_ranges.size(); ++i) {
+    if (i == search_position && range_started)
+      /* the tree is sorted by df_max; its last node bounds the rest
+         of the current range */
+      bound = std::max(bound, branch_and_bound.rbegin()->first);
+    else
+      bound = std::max(bound, search_ranges[i].bound);
+  }
+
+  return bound;
+}
 
 std::tuple<unsigned, unsigned, unsigned, unsigned>
 TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
-                                   bool exhaustive) noexcept
+                                   unsigned &budget,
+                                   const TimeoutClock *timeout) noexcept
 {
   /* Some general information about the branch and bound method can be found here:
    * http://eaton.math.rpi.edu/faculty/Mitchell/papers/leeejem.html
@@ -308,14 +370,16 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
    * http://www.penguin.cz/~ondrap/algorithm.pdf
    */
 
-  // Return early if this tp-range can't beat the current best_d...
-  // Assume a maximum speed of 100 m/s
-  const unsigned fastskiprange = GetPoint(to).DeltaTime(GetPoint(from)) * 100;
-  const unsigned fastskiprange_flat =
-    trace_master.ProjectRange(GetPoint(from).GetLocation(), fastskiprange);
+  if (!range_started) {
+    // Return early if this tp-range can't beat the current best_d...
+    // Assume a maximum speed of 100 m/s
+    const unsigned fastskiprange = GetPoint(to).DeltaTime(GetPoint(from)) * 100;
+    const unsigned fastskiprange_flat =
+      trace_master.ProjectRange(GetPoint(from).GetLocation(), fastskiprange);
 
-  if (fastskiprange_flat < worst_d)
-    return {0, 0, 0, 0};
+    if (fastskiprange_flat < worst_d)
+      return {0, 0, 0, 0};
+  }
 
   bool integral_feasible = false;
   unsigned best_d = 0,
@@ -330,22 +394,21 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
     OLCTriangleRules::MakeValidator(trace_master.GetProjection(),
                                     GetPoint(from).GetLocation());
 
-  if (!running) {
+  if (!range_started) {
     // initiate algorithm. otherwise continue unfinished run
-    running = true;
+    range_started = true;
+    range_worst_d = worst_d;
 
     // initialize bound-and-branch tree with root node (note: Candidate set interval is [min, max))
     CandidateSet root_candidates(*this, from, to + 1);
     if (root_candidates.IsFeasible(validator) &&
         root_candidates.df_max >= worst_d)
       branch_and_bound.emplace(root_candidates.df_max, root_candidates);
+  } else {
+    // continue pruning with the best triangle of the previous calls
+    worst_d = std::max(worst_d, range_worst_d);
   }
 
-  // set max_iterations only if non-exhaustive and predictive solving is enabled.
-  // otherwise use predefined value.
-  if (!exhaustive && predict)
-    max_iterations = tick_iterations;
-
   while (!branch_and_bound.empty()) {
     /* now loop over the tree, branching each found candidate set, adding the branch if it's feasible.
      * remove all candidate sets with d_max smaller than d_min of the largest integral candidate set
@@ -354,10 +417,19 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
 
     iterations++;
 
-    // break loop if max_iterations or max_tree_size exceeded
-    if (iterations > max_iterations || branch_and_bound.size() > max_tree_size)
+    // suspend if the budget is used up; the next call continues here
+    if (budget == 0 ||
+        (timeout != nullptr && iterations % 64 == 0 && timeout->HasExpired()))
       break;
 
+    --budget;
+
+    // give up if max_tree_size is exceeded
+    if (branch_and_bound.size() > max_tree_size) {
+      AbandonRange();
+      break;
+    }
+
     // first clean up tree, removeing all nodes with d_max < worst_d
     branch_and_bound.erase(branch_and_bound.begin(), branch_and_bound.lower_bound(worst_d));
 
@@ -451,7 +523,9 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
 
 
   if (branch_and_bound.empty())
-    running = false;
+    range_started = false;
+  else
+    range_worst_d = worst_d;
 
   if (integral_feasible) {
     if (tp1 > tp2) std::swap(tp1, tp2);
@@ -475,6 +549,18 @@ TriangleContest::CalculateResult() const noexcept
     ? CalcLegDistance(solution, 0) + CalcLegDistance(solution, 1) + CalcLegDistance(solution, 2)
     : 0.;
   result.score = ApplyHandicap(result.distance * 0.001);
+
+  /* this drops when the "close look" ranges are appended to
+     search_ranges; see ContestResult::progress */
+  result.progress = running
+    ? double(search_position) / search_ranges.size()
+    : 1.;
+
+  const unsigned upper_bound = GetUpperBound();
+  result.gap = upper_bound > best_d
+    ? double(upper_bound - best_d) / upper_bound
+    : 0.;
+
   return result;
 }
 
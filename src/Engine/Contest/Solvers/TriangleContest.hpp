@@ -29,7 +29,11 @@
 #include "Trace/Point.hpp"
 #include "Geo/Flat/FlatBoundingBox.hpp"
 
+#include <chrono>
 #include <map>
+#include <vector>
+
+class TimeoutClock;
 
 /**
  * Specialisation of AbstractContest for OLC Triangle (triangle) rules
@@ -74,16 +78,23 @@ private:
   bool is_complete = false;
 
   /**
-   * True if the branch and bound algorithm is running
+   * True if a search is in progress.  A non-exhaustive Solve() call
+   * may suspend it when its budget is used up; the next call resumes
+   * it.
    */
   bool running;
 
   /**
-   * Number of iterations per tick (only for non-exhaustive,
-   * predictive runs)
+   * Number of iterations per tick (only for non-exhaustive runs)
    */
   unsigned tick_iterations;
 
+  /**
+   * Maximum wall-clock time of one non-exhaustive Solve() call.  Zero
+   * means there is no limit besides #tick_iterations.
+   */
+  std::chrono::steady_clock::duration tick_budget{};
+
   /**
    * Hard limits for number of iterations and tree size.
    */
@@ -139,6 +150,70 @@ private:
 
   ClosingPairs closing_pairs;
 
+  /**
+   * A closing pair which is (or will be) searched by the branch and
+   * bound algorithm.
+   */
+  struct SearchRange {
+    ClosingPair pair;
+
+    /**
+     * Upper bound for the flat distance of triangles inside this
+     * range.
+     */
+    unsigned bound;
+  };
+
+  /**
+   * The ranges of the current search: first the relaxed closing
+   * pairs, then (after all of them have been searched) the pairs
+   * from #close_look.
+   */
+  std::vector<SearchRange> search_ranges;
+
+  /**
+   * Index of the range in #search_ranges which is being searched.
+   */
+  unsigned search_position;
+
+  /**
+   * Has the root of the current range been inserted into the branch
+   * and bound tree?
+   */
+  bool range_started;
+
+  /**
+   * Have the pairs from #close_look been appended to
+   * #search_ranges?
+   */
+  bool close_look_started;
+
+  /**
+   * Unrelaxed closing pairs which need to be searched again, because
+   * the best triangle in the surrounding relaxed pair did not fit in
+   * an unrelaxed one.
+   */
+  ClosingPairs close_look;
+
+  /**
+   * Upper bound for the triangles in #close_look, i.e. the largest
+   * triangle which was rejected for this reason.
+   */
+  unsigned close_look_bound;
+
+  /**
+   * Upper bound for the triangles in ranges which were abandoned
+   * because a hard limit was exceeded.  These may contain a better
+   * triangle than the one we found.
+   */
+  unsigned abandoned_bound;
+
+  /**
+   * The largest triangle found so far in the current range; the
+   * branch and bound tree is pruned with it.
+   */
+  unsigned range_worst_d;
+
   /**
    * A bounding box around a range of trace points.
    */
@@ -275,14 +350,65 @@ protected:
   bool FindClosingPairs(unsigned old_size) noexcept;
   void SolveTriangle(bool exhaustive) noexcept;
 
+  /**
+   * Run the branch and bound algorithm on the trace points [from,
+   * to], continuing the tree of the previous call if #range_started
+   * is set.  #range_started is cleared when the range has been
+   * searched completely; it remains set when #iterations or the
+   * #timeout have been used up.
+   *
+   * @param iterations the number of iterations which may be used;
+   * it is decremented by the number of iterations done
+   * @param timeout suspend the search when this expires; nullptr
+   * means no time limit
+   * @return the best triangle (tp1, tp2, tp3, flat distance) found
+   * by this call, or all zeroes
+   */
   std::tuple<unsigned, unsigned, unsigned, unsigned>
   RunBranchAndBound(unsigned from, unsigned to, unsigned best_d,
-                    bool exhaustive) noexcept;
+                    unsigned &iterations,
+                    const TimeoutClock *timeout) noexcept;
 
   void UpdateTrace(bool force) noexcept override;
   void ResetBranchAndBound() noexcept;
 
 private:
+  /**
+   * Build the list of closing pairs to be searched and start a new
+   * search.
+   */
+  void StartSearch() noexcept;
+
+  /**
+   * Give up searching the current range, remembering its upper
+   * bound.
+   */
+  void AbandonRange() noexcept;
+
+  /**
+   * Evaluate a triangle found inside the given search range, and
+   * make it the new solution if it is better and inside an unrelaxed
+   * closing pair.
+   */
+  void CheckTriangle(const ClosingPair &range,
+                     const std::tuple<unsigned, unsigned,
+                                      unsigned, unsigned> &triangle) noexcept;
+
+  /**
+   * Calculate an upper bound for the flat distance of the best
+   * triangle, considering all ranges which have not been searched
+   * completely yet.
+   */
+  [[gnu::pure]]
+  unsigned GetUpperBound() const noexcept;
+
+  /**
+   * Calculate an upper bound for the flat distance of triangles
+   * inside the given closing pair.
+   */
+  [[gnu::pure]]
+  unsigned GetRangeBound(const ClosingPair &pair) const noexcept;
+
   void CheckAddCandidate(unsigned worst_d,
                          const OLCTriangleValidator &validator,
                          CandidateSet candidate_set) noexcept {
@@ -300,6 +426,18 @@ public:
     max_tree_size = _max_tree_size;
   };
 
+  /**
+   * Limit the wall-clock time of each non-exhaustive Solve() call.
+   * The search is suspended when it expires, keeping the best
+   * triangle found so far, and resumed by the next call.
+   *
+   * @param _tick_budget the maximum duration; zero disables the
+   * limit
+   */
+  void SetTickBudget(std::chrono::steady_clock::duration _tick_budget) noexcept {
+    tick_budget = _tick_budget;
+  }
+
   /* virtual methods from AbstractContest */
   void Reset() noexcept override;
   SolverResult Solve(bool exhaustive) noexcept override;
@@ -22,6 +22,8 @@
 
 #include "WeglideFree.hpp"
 
+#include <algorithm>
+
 WeglideFree::WeglideFree() noexcept
   :AbstractContest(0)
 {
@@ -65,6 +67,10 @@ WeglideFree::CalculateResult() const noexcept
 
   result.score = ApplyHandicap((result_distance.distance + area_score) 
                                 / 1000);
+  result.progress = std::min({result_distance.progress,
+                              result_fai.progress, result_or.progress});
+  result.gap = std::max({result_distance.gap,
+                         result_fai.gap, result_or.gap});
 
   return result;
 }
@@ -223,21 +223,18 @@ private:
    */
   bool Push(const Node node, const Node parent,
             unsigned edge_value = 0) noexcept {
-    // Try to find the given node n in the EdgeMap
-    edge_iterator it = edges.find(node);
-    if (it == edges.end())
-      // first entry
-      // If the node wasn't found
-      // -> Insert a new node
-      it = edges.insert(std::make_pair(node, Edge(parent, edge_value))).first;
-    else if (it->second.value > edge_value)
+    // Try to insert the given node n into the EdgeMap
+    auto [it, inserted] = edges.emplace(node, parent, edge_value);
+    if (!inserted) {
+      if (it->second.value <= edge_value)
+        // If the node was found but the new value is higher or equal
+        // -> Don't use this new leg
+        return false;
+
       // If the node was found and the new value is smaller
       // -> Replace the value with the new one
       it->second = Edge(parent, edge_value);
-    else
-      // If the node was found but the new value is higher or equal
-      // -> Don't use this new leg
-      return false;
+    }
 
     q.push(Value(edge_value, it));
     return true;
@@ -27,8 +27,8 @@ Copyright_License {
 #include "Dijkstra.hpp"
 #include "ScanTaskPoint.hpp"
 #include "SolverResult.hpp"
+#include "util/FlatHashMap.hpp"
 
-#include <unordered_map>
 #include <cassert>
 
 /**
@@ -58,8 +58,7 @@ protected:
     };
 
     template<typename Value>
-    struct Bind : public std::unordered_map<ScanTaskPoint, Value,
-                                            Hash, Equal> {
+    struct Bind : public FlatHashMap<ScanTaskPoint, Value, Hash, Equal> {
     };
   };
 
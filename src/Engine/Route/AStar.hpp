@@ -25,8 +25,7 @@ Copyright_License {
 #define ASTAR_HPP
 
 #include "util/ReservablePriorityQueue.hpp"
-
-#include <unordered_map>
+#include "util/FlatHashMap.hpp"
 
 struct AStarPriorityValue
 {
@@ -74,15 +73,24 @@ template <class Node, class Hash=std::hash<Node>,
           bool m_min=true>
 class AStar
 {
-  typedef std::unordered_map<Node, AStarPriorityValue, Hash, KeyEqual> node_value_map;
+  /**
+   * The best known value of a node and the predecessor it was
+   * reached from.
+   */
+  struct NodeState {
+    AStarPriorityValue value;
 
-  typedef typename node_value_map::iterator node_value_iterator;
-  typedef typename node_value_map::const_iterator node_value_const_iterator;
+    Node parent;
 
-  typedef std::unordered_map<Node, Node, Hash, KeyEqual> node_parent_map;
+    constexpr NodeState(const AStarPriorityValue &_value,
+                        const Node &_parent) noexcept
+      :value(_value), parent(_parent) {}
+  };
 
-  typedef typename node_parent_map::iterator node_parent_iterator;
-  typedef typename node_parent_map::const_iterator node_parent_const_iterator;
+  typedef FlatHashMap<Node, NodeState, Hash, KeyEqual> node_value_map;
+
+  typedef typename node_value_map::iterator node_value_iterator;
+  typedef typename node_value_map::const_iterator node_value_const_iterator;
 
   struct NodeValue {
     AStarPriorityValue priority;
@@ -104,17 +112,12 @@ class AStar
   };
 
   /**
-   * Stores the value of each node.  It is updated by push(), if a
-   * value lower than the current one is found.
+   * Stores the value and the predecessor of each node.  It is
+   * updated by push(), if a value lower than the current one is
+   * found.
    */
   node_value_map node_values;
 
-  /**
-   * Stores the predecessor of each node.  It is maintained by
-   * set_predecessor().
-   */
-  node_parent_map node_parents;
-
   /**
    * A sorted list of all possible node paths, lowest distance first.
    */
@@ -163,8 +166,6 @@ public:
     // Clear the search queue
     q.clear();
 
-    // Clear the node_parent_map
-    node_parents.clear();
     // Clear the node_value_map
     node_values.clear();
   }
@@ -194,12 +195,12 @@ public:
    *
    * @return Node for processing
    */
-  const Node &Pop() noexcept {
+  Node Pop() noexcept {
     cur = q.top().iterator;
 
     do { // remove this item
       q.pop();
-    } while (!q.empty() && (q.top().priority > q.top().iterator->second));
+    } while (!q.empty() && (q.top().priority > q.top().iterator->second.value));
     // and all lower rank than this
 
     return cur->first;
@@ -227,9 +228,9 @@ public:
    */
   [[gnu::pure]]
   Node GetPredecessor(const Node &node) const noexcept {
-    // Try to find the given node in the node_parent_map
-    node_parent_const_iterator it = node_parents.find(node);
-    if (it == node_parents.end())
+    // Try to find the given node in the node_value_map
+    node_value_const_iterator it = node_values.find(node);
+    if (it == node_values.end())
       // first entry
       // If the node wasn't found
       // -> Return the given node itself
@@ -237,7 +238,7 @@ public:
 
     // If the node was found
     // -> Return the parent node
-    return it->second;
+    return it->second.parent;
   }
 
   /** Reserve queue size (if available) */
@@ -251,14 +252,14 @@ public:
    */
   [[gnu::pure]]
   AStarPriorityValue GetNodeValue(const Node &node) const noexcept {
-    node_value_const_iterator it = node_values.find(node);
     if (cur->first == node)
-      return cur->second;
+      return cur->second.value;
 
+    node_value_const_iterator it = node_values.find(node);
     if (it == node_values.end())
       return AStarPriorityValue(0);
 
-    return it->second;
+    return it->second.value;
   }
 
 private:
@@ -271,40 +272,21 @@ private:
    */
   void Push(const Node &node, const Node &parent,
             const AStarPriorityValue &edge_value) noexcept {
-    // Try to find the given node n in the node_value_map
-    node_value_iterator it = node_values.find(node);
-    if (it == node_values.end()) {
-      // first entry
-      // If the node wasn't found
-      // -> Insert a new node into the node_value_map
-      it = node_values.insert(std::make_pair(node, edge_value)).first;
+    // Try to insert the given node n into the node_value_map
+    auto [it, inserted] = node_values.emplace(node, edge_value, parent);
+    if (!inserted) {
+      if (!(it->second.value > edge_value))
+        // If the node was found but the value is higher or equal
+        // -> Don't use this new leg
+        return;
 
-      // Remember the parent node
-      SetPredecessor(node, parent);
-    } else if (it->second > edge_value) {
       // If the node was found and the new value is smaller
-      // -> Replace the value with the new one
-      it->second = edge_value;
-      // replace, it's bigger
-
-      // Remember the new parent node
-      SetPredecessor(node, parent);
-    } else
-      // If the node was found but the value is higher or equal
-      // -> Don't use this new leg
-      return;
+      // -> Replace the value and the parent with the new ones
+      it->second = NodeState(edge_value, parent);
+    }
 
     q.push(NodeValue(edge_value, it));
   }
-
-  void SetPredecessor(const Node &node, const Node &parent) noexcept {
-    // Try to find the given node in the node_parent_map
-    auto result = node_parents.insert(std::make_pair(node, parent));
-    if (!result.second)
-      // If the node was found
-      // -> Replace the according parent node with the new one
-      result.first->second = parent;
-  }
 };
 
 #endif
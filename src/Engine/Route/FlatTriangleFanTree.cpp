@@ -24,9 +24,12 @@
 #include "RouteLink.hpp"
 #include "Terrain/RasterMap.hpp"
 #include "ReachFanParms.hpp"
-#include "util/GlobalSliceAllocator.hxx"
+#include "ReachWorkerPool.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 
+#include <iterator>
+#include <optional>
+
 #define REACH_BUFFER 1
 #define REACH_SWEEP (ROUTEPOLAR_Q1-REACH_BUFFER)
 
@@ -34,6 +37,24 @@
 #define REACH_MIN_STEP 25
 #define REACH_MAX_VERTICES 2000
 
+/**
+ * A gap between two edges of a fan, which may be filled with a child
+ * fan.
+ */
+struct FlatTriangleFanTree::Gap {
+  FlatTriangleFanTree &parent;
+  RouteLink e_1, e_2;
+
+  /**
+   * The child fan found by CheckGap().
+   */
+  std::optional<FlatTriangleFanTree> child;
+
+  Gap(FlatTriangleFanTree &_parent,
+      const RouteLink &_e_1, const RouteLink &_e_2) noexcept
+    :parent(_parent), e_1(_e_1), e_2(_e_2) {}
+};
+
 static bool
 AlmostTheSame(const FlatGeoPoint p1, const FlatGeoPoint p2) noexcept
 {
@@ -81,6 +102,31 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin,
   CalcBB();
 }
 
+void
+FlatTriangleFanTree::UpdateReach(const AFlatGeoPoint &origin,
+                                 const ReachFanParms &parms) noexcept
+{
+  assert(IsRoot());
+
+  LeafVector old_children;
+  old_children.swap(children);
+  Clear();
+
+  FillReach(origin, 0, ROUTEPOLAR_POINTS, parms);
+
+  for (auto i = old_children.begin(), end = old_children.end(); i != end;) {
+    const auto next = std::next(i);
+    const AFlatGeoPoint child_origin = i->GetOrigin();
+    if (IsInside(child_origin) &&
+        parms.rpolars.CalcGlideArrival(origin, child_origin,
+                                       parms.projection) >= child_origin.altitude)
+      children.splice(children.end(), old_children, i);
+    i = next;
+  }
+
+  CalcBB();
+}
+
 void
 FlatTriangleFanTree::DummyReach(const AFlatGeoPoint &ao) noexcept
 {
@@ -90,26 +136,65 @@ FlatTriangleFanTree::DummyReach(const AFlatGeoPoint &ao) noexcept
   CalcBB();
 }
 
+void
+FlatTriangleFanTree::CollectDepth(unsigned char set_depth,
+                                  std::vector<FlatTriangleFanTree *> &fans) noexcept
+{
+  if (depth == set_depth)
+    fans.push_back(this);
+  else if (depth < set_depth)
+    for (auto &child : children)
+      child.CollectDepth(set_depth, fans);
+}
+
 bool
 FlatTriangleFanTree::FillDepth(const AFlatGeoPoint &origin,
                                ReachFanParms &parms) noexcept
 {
-  if (depth == parms.set_depth) {
-    if (gaps_filled)
-      return true;
-    gaps_filled = true;
+  std::vector<FlatTriangleFanTree *> fans;
+  CollectDepth(parms.set_depth, fans);
+
+  std::vector<Gap> gaps;
+  for (auto *fan : fans)
+    if (!fan->gaps_filled)
+      fan->FindGaps(origin, parms, gaps);
+
+  /* fill the gaps of all fans at this depth, possibly concurrently;
+     this is speculative, because the budget check below may discard
+     the children of the last fans */
+  const auto check = [&origin, &parms, &gaps](std::size_t i){
+    Gap &gap = gaps[i];
+    gap.parent.CheckGap(origin, gap, parms);
+  };
+
+  if (parms.workers != nullptr)
+    parms.workers->Run(gaps.size(), check);
+  else
+    for (std::size_t i = 0; i < gaps.size(); ++i)
+      check(i);
+
+  /* add the children one fan after the other, checking the budget
+     before each fan, just like a depth-first traversal would */
+  auto gap = gaps.begin();
+  for (auto *fan : fans) {
+    if (fan->gaps_filled)
+      continue;
+    fan->gaps_filled = true;
 
     if (parms.vertex_counter > REACH_MAX_VERTICES)
       return false;
     if (parms.fan_counter > REACH_MAX_FANS)
       return false;
 
-    FillGaps(origin, parms);
-  } else if (depth < parms.set_depth) {
-    for (auto &child : children)
-      if (!child.FillDepth(origin, parms))
-        return false; // stop searching
+    for (; gap != gaps.end() && &gap->parent == fan; ++gap) {
+      if (gap->child) {
+        parms.vertex_counter += gap->child->vs.size();
+        parms.fan_counter++;
+        fan->children.emplace_back(std::move(*gap->child));
+      }
+    }
   }
+
   return true;
 }
 
@@ -147,8 +232,9 @@ FlatTriangleFanTree::FillReach(const AFlatGeoPoint &origin, const int index_low,
 }
 
 void
-FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin,
-                              ReachFanParms &parms) noexcept
+FlatTriangleFanTree::FindGaps(const AFlatGeoPoint &origin,
+                              const ReachFanParms &parms,
+                              std::vector<Gap> &gaps) noexcept
 {
   // worth checking for gaps?
   if (vs.size() > 2 && parms.rpolars.IsTurningReachEnabled()) {
@@ -163,7 +249,7 @@ FlatTriangleFanTree::FillGaps(const AFlatGeoPoint &origin,
 
       const RouteLink e(RoutePoint(*x, 0), origin, parms.projection);
       // check if children need to be added
-      CheckGap(origin, e_last, e, parms);
+      gaps.emplace_back(*this, e_last, e);
 
       e_last = e;
     }
@@ -197,22 +283,19 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
     parms.terrain_base /= parms.terrain_counter;
 }
 
-bool
-FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                              const RouteLink &e_2,
-                              ReachFanParms &parms) noexcept
+void
+FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, Gap &gap,
+                              const ReachFanParms &parms) const noexcept
 {
+  const RouteLink &e_1 = gap.e_1, &e_2 = gap.e_2;
   const bool side = (e_1.d > e_2.d);
   const RouteLink &e_long = (side ? e_1 : e_2);
   const RouteLink &e_short = (side ? e_2 : e_1);
   if (e_short.d >= e_long.d)
-    return false;
+    return;
 
   const FlatGeoPoint &p_long = e_long.first;
 
-  // return true if this gap was caught (applicable) whether or not it generated
-  // a change
-
   const auto f0 = e_short.d * e_long.inv_d;
   const int h_loss =
     parms.rpolars.CalcGlideArrival(n, p_long, parms.projection) - n.altitude;
@@ -240,14 +323,10 @@ FlatTriangleFanTree::CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
 
     FlatTriangleFanTree child(depth + 1);
     if (child.FillReach(x, index_left, index_right, parms)) {
-      parms.vertex_counter += child.vs.size();
-      parms.fan_counter++;
-      children.emplace_back(std::move(child));
-      return true;
+      gap.child.emplace(std::move(child));
+      return;
     }
   }
-
-  return false;
 }
 
 int
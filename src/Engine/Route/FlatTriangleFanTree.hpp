@@ -24,10 +24,10 @@
 #define FLAT_TRIANGLE_FAN_TREE_HPP
 
 #include "Geo/Flat/FlatBoundingBox.hpp"
-#include "util/SliceAllocator.hxx"
 #include "FlatTriangleFan.hpp"
 
 #include <list>
+#include <vector>
 
 class FlatProjection;
 struct GeoPoint;
@@ -48,8 +48,11 @@ public:
   static constexpr unsigned REACH_MAX_FANS = 300;
 
 private:
-  typedef std::list<FlatTriangleFanTree,
-                    GlobalSliceAllocator<FlatTriangleFanTree, 128u> > LeafVector;
+  /* this uses the standard allocator, because the reach fans to
+     terrain and to working height are built concurrently */
+  typedef std::list<FlatTriangleFanTree> LeafVector;
+
+  struct Gap;
 
   FlatBoundingBox bb_children;
   LeafVector children;
@@ -81,6 +84,19 @@ public:
   void FillReach(const AFlatGeoPoint &origin, ReachFanParms &parms) noexcept;
   void DummyReach(const AFlatGeoPoint &origin) noexcept;
 
+  /**
+   * Refill this root fan from a new origin (close to the previous
+   * one), but instead of searching the gaps again, keep those
+   * children whose origins can still be reached from the new origin
+   * in straight glide, arriving at or above the child's height.
+   * Children which cannot be reached anymore are dropped with their
+   * subtrees.  The result may therefore be smaller than what
+   * FillReach() would find, but it never claims more than can be
+   * reached.
+   */
+  void UpdateReach(const AFlatGeoPoint &origin,
+                   const ReachFanParms &parms) noexcept;
+
   /**
    * Basic check for a state created by DummyReach().  If this method
    * returns true, then calls to FindPositiveArrival() are supposed to
@@ -99,11 +115,30 @@ public:
                  const int index_low, const int index_high,
                  const ReachFanParms &parms) noexcept;
 
+  /**
+   * Add children to all fans at depth #ReachFanParms::set_depth, with
+   * the help of #ReachFanParms::workers (if set).  Must be called on
+   * the root.
+   *
+   * @return false if the vertex or fan budget is exhausted
+   */
   bool FillDepth(const AFlatGeoPoint &origin, ReachFanParms &parms) noexcept;
-  void FillGaps(const AFlatGeoPoint &origin, ReachFanParms &parms) noexcept;
 
-  bool CheckGap(const AFlatGeoPoint &n, const RouteLink &e_1,
-                const RouteLink &e_2, ReachFanParms &parms) noexcept;
+private:
+  void CollectDepth(unsigned char set_depth,
+                    std::vector<FlatTriangleFanTree *> &fans) noexcept;
+
+  void FindGaps(const AFlatGeoPoint &origin, const ReachFanParms &parms,
+                std::vector<Gap> &gaps) noexcept;
+
+  /**
+   * Try to fill the given gap of this fan with a child fan.  This
+   * method may be called concurrently for different gaps.
+   */
+  void CheckGap(const AFlatGeoPoint &n, Gap &gap,
+                const ReachFanParms &parms) const noexcept;
+
+public:
 
   bool FindPositiveArrival(FlatGeoPoint n,
                            const ReachFanParms &parms,
@@ -36,7 +36,8 @@ ReachFan::Reset()
 
 bool
 ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-                const RasterMap* terrain, const bool do_solve)
+                const RasterMap* terrain, const bool do_solve,
+                ReachWorkerPool *workers)
 {
   Reset();
 
@@ -49,13 +50,14 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
   const int h2 = h.GetValueOr0();
 
   ReachFanParms parms(rpolars, projection, terrain_base, terrain);
+  parms.workers = workers;
   const AFlatGeoPoint ao(projection.ProjectInteger(origin), origin.altitude);
 
+  solve_altitude = origin.altitude;
+
   // immediate exit if starting below terrain, or starting below floor
   // with some clearance (not worth scanning if too close)
-  if ((!h.IsInvalid() &&
-      (origin.altitude <= h2 + rpolars.GetSafetyHeight()))
-      || (origin.altitude < MIN_FLOOR_CLEARANCE + rpolars.GetFloor() + rpolars.GetSafetyHeight())) {
+  if (IsTooLow(origin, h, rpolars)) {
     terrain_base = h2;
     root.DummyReach(ao);
     return false;
@@ -66,8 +68,51 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
   else
     root.DummyReach(ao);
 
+  UpdateTerrainBase(ao, h, parms);
+  return true;
+}
+
+bool
+ReachFan::Update(const AGeoPoint origin, const RoutePolars &rpolars,
+                 const RasterMap *terrain)
+{
+  if (root.IsEmpty() || root.IsDummy() ||
+      origin.altitude > solve_altitude + MAX_UPDATE_CLIMB ||
+      origin.Distance(projection.GetCenter()) > MAX_UPDATE_DISTANCE)
+    return false;
+
+  const auto h = terrain
+    ? terrain->GetHeight(origin)
+    : TerrainHeight::Invalid();
+
+  if (IsTooLow(origin, h, rpolars))
+    return false;
+
+  /* keep the projection of the last Solve() call, because the child
+     fans were projected with it */
+  ReachFanParms parms(rpolars, projection, terrain_base, terrain);
+  const AFlatGeoPoint ao(projection.ProjectInteger(origin), origin.altitude);
+
+  root.UpdateReach(ao, parms);
+  UpdateTerrainBase(ao, h, parms);
+  return true;
+}
+
+inline bool
+ReachFan::IsTooLow(const AGeoPoint origin, const TerrainHeight h,
+                   const RoutePolars &rpolars) noexcept
+{
+  return (!h.IsInvalid() &&
+          origin.altitude <= h.GetValueOr0() + rpolars.GetSafetyHeight()) ||
+    origin.altitude < MIN_FLOOR_CLEARANCE + rpolars.GetFloor() + rpolars.GetSafetyHeight();
+}
+
+void
+ReachFan::UpdateTerrainBase(const AFlatGeoPoint &ao, const TerrainHeight h,
+                            ReachFanParms &parms) noexcept
+{
   if (!h.IsInvalid()) {
-    parms.terrain_base = h2;
+    parms.terrain_base = h.GetValueOr0();
     parms.terrain_counter = 1;
   } else {
     parms.terrain_base = 0;
@@ -78,7 +123,6 @@ ReachFan::Solve(const AGeoPoint origin, const RoutePolars &rpolars,
     root.UpdateTerrainBase(ao, parms);
 
   terrain_base = parms.terrain_base;
-  return true;
 }
 
 bool
@@ -25,20 +25,42 @@
 
 #include "Geo/Flat/FlatProjection.hpp"
 #include "FlatTriangleFanTree.hpp"
+#include "Terrain/Height.hpp"
 
 class RoutePolars;
 class RasterMap;
 class GeoBounds;
+class ReachWorkerPool;
 struct ReachResult;
 
 class ReachFan
 {
+  /**
+   * Update() falls back to a full Solve() if the aircraft has moved
+   * farther than this [m] from the origin of the last Solve() call.
+   * This also limits the error of reusing the #projection.
+   */
+  static constexpr double MAX_UPDATE_DISTANCE = 1000;
+
+  /**
+   * Update() falls back to a full Solve() if the aircraft has
+   * climbed more than this [m] since the last Solve() call, because
+   * the reach would have grown beyond the previous solution.
+   */
+  static constexpr int MAX_UPDATE_CLIMB = 50;
+
   FlatProjection projection;
   FlatTriangleFanTree root;
   int terrain_base;
 
+  /**
+   * The altitude of the origin passed to the last Solve() call.  Its
+   * location is the center of #projection.
+   */
+  int solve_altitude;
+
 public:
-  ReachFan():terrain_base(0) {}
+  ReachFan():terrain_base(0), solve_altitude(0) {}
 
   friend class PrintHelper;
 
@@ -52,8 +74,31 @@ public:
 
   void Reset();
 
+  /**
+   * @param workers if not nullptr, these threads help filling the
+   * fan tree
+   */
   bool Solve(const AGeoPoint origin, const RoutePolars &rpolars,
-             const RasterMap *terrain, const bool do_solve = true);
+             const RasterMap *terrain, const bool do_solve = true,
+             ReachWorkerPool *workers = nullptr);
+
+  /**
+   * An alternative to Solve() for an aircraft which has moved only
+   * a little since the last Solve() call: only the root fan is
+   * rebuilt, and the previous child fans which are still reachable
+   * are kept (see FlatTriangleFanTree::UpdateReach()).  This saves
+   * time only if a good part of the reach lies in child fans, e.g. in
+   * mountainous terrain; over flat terrain, the root fan costs as
+   * much as a full Solve().  The result is conservative, i.e. it may
+   * miss some of the reach until the next Solve() call, but it never
+   * overestimates it.
+   *
+   * @return false if the previous solution cannot be reused (no
+   * terrain reach, moved or climbed too much, or now below terrain);
+   * the caller should call Solve() then
+   */
+  bool Update(const AGeoPoint origin, const RoutePolars &rpolars,
+              const RasterMap *terrain);
 
   bool FindPositiveArrival(const AGeoPoint dest, const RoutePolars &rpolars,
                            ReachResult &result_r) const;
@@ -64,6 +109,18 @@ public:
   int GetTerrainBase() const {
     return terrain_base;
   }
+
+private:
+  /**
+   * Is the origin too close to (or below) the terrain or the floor
+   * for a reach search?
+   */
+  [[gnu::pure]]
+  static bool IsTooLow(const AGeoPoint origin, TerrainHeight h,
+                       const RoutePolars &rpolars) noexcept;
+
+  void UpdateTerrainBase(const AFlatGeoPoint &ao, TerrainHeight h,
+                         ReachFanParms &parms) noexcept;
 };
 
 #endif
@@ -27,6 +27,7 @@
 
 class FlatProjection;
 class RasterMap;
+class ReachWorkerPool;
 
 struct ReachFanParms {
   const RoutePolars &rpolars;
@@ -38,6 +39,11 @@ struct ReachFanParms {
   unsigned vertex_counter = 0;
   unsigned char set_depth = 0;
 
+  /**
+   * If set, these threads help filling the gaps of a fan tree level.
+   */
+  ReachWorkerPool *workers = nullptr;
+
   ReachFanParms(const RoutePolars& _rpolars,
                 const FlatProjection &_projection,
                 const short _terrain_base,
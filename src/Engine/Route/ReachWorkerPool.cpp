@@ -0,0 +1,74 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "ReachWorkerPool.hpp"
+
+#include <algorithm>
+
+ReachWorkerPool::Worker::Worker() noexcept
+  :StandbyThread("ReachWorker") {}
+
+ReachWorkerPool::Worker::~Worker() noexcept
+{
+  LockStop();
+}
+
+void
+ReachWorkerPool::Worker::Start(Batch &_batch) noexcept
+{
+  const std::lock_guard<Mutex> lock(mutex);
+
+  batch = &_batch;
+  Trigger();
+}
+
+void
+ReachWorkerPool::Worker::Tick() noexcept
+{
+  Batch &b = *batch;
+
+  const ScopeUnlock unlock(mutex);
+  b.Work();
+}
+
+ReachWorkerPool::ReachWorkerPool(unsigned _n_workers) noexcept
+  :n_workers(std::min(_n_workers, MAX_WORKERS)) {}
+
+void
+ReachWorkerPool::Run(std::size_t n, const Function &f) noexcept
+{
+  const unsigned n_threads = std::min<std::size_t>(n_workers,
+                                                   n > 0 ? n - 1 : 0);
+
+  Batch batch(n, f);
+
+  for (unsigned i = 0; i < n_threads; ++i)
+    workers[i].Start(batch);
+
+  /* the calling thread works, too; it also picks up the jobs of
+     threads which could not be launched */
+  batch.Work();
+
+  for (unsigned i = 0; i < n_threads; ++i)
+    workers[i].Wait();
+}
@@ -0,0 +1,120 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_REACH_WORKER_POOL_HPP
+#define XCSOAR_REACH_WORKER_POOL_HPP
+
+#include "thread/StandbyThread.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+/**
+ * A small pool of threads which help the calling thread to run a
+ * batch of independent jobs, see Run().  The jobs are claimed one at
+ * a time from a shared counter, so a thread which is done with a
+ * cheap job immediately takes over the next one, and the load is
+ * balanced even if the cost of the jobs varies a lot.
+ *
+ * The threads are launched on the first Run() call and stay alive
+ * until this object is destructed.
+ */
+class ReachWorkerPool {
+public:
+  static constexpr unsigned MAX_WORKERS = 3;
+
+  typedef std::function<void(std::size_t)> Function;
+
+private:
+  /**
+   * One batch of jobs, shared by all threads.
+   */
+  struct Batch {
+    std::atomic<std::size_t> next{0};
+    const std::size_t n;
+    const Function &f;
+
+    Batch(std::size_t _n, const Function &_f) noexcept
+      :n(_n), f(_f) {}
+
+    void Work() noexcept {
+      std::size_t i;
+      while ((i = next.fetch_add(1, std::memory_order_relaxed)) < n)
+        f(i);
+    }
+  };
+
+  class Worker final : StandbyThread {
+    Batch *batch;
+
+  public:
+    Worker() noexcept;
+    ~Worker() noexcept;
+
+    /**
+     * Begin working on the given batch in background.
+     */
+    void Start(Batch &_batch) noexcept;
+
+    /**
+     * Wait until this thread does not touch the batch anymore.  If
+     * the thread could not be launched, this returns immediately,
+     * and the calling thread has done its share of the work.
+     */
+    void Wait() noexcept {
+      LockWaitDone();
+    }
+
+  private:
+    /* virtual methods from class StandbyThread */
+    void Tick() noexcept override;
+  };
+
+  std::array<Worker, MAX_WORKERS> workers;
+
+  /**
+   * The number of #workers which may be used.
+   */
+  const unsigned n_workers;
+
+public:
+  /**
+   * @param _n_workers the number of threads in addition to the
+   * calling one; 0 runs all jobs in the calling thread
+   */
+  explicit ReachWorkerPool(unsigned _n_workers) noexcept;
+
+  ReachWorkerPool(const ReachWorkerPool &) = delete;
+  ReachWorkerPool &operator=(const ReachWorkerPool &) = delete;
+
+  /**
+   * Invoke f(i) for each i in [0, n), in no particular order and
+   * possibly concurrently.  Returns when all jobs are done.  Must
+   * not be called concurrently, and not from within a job.
+   */
+  void Run(std::size_t n, const Function &f) noexcept;
+};
+
+#endif
@@ -24,9 +24,25 @@
 #include "Terrain/RasterMap.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 
+#include <thread>
+
+/**
+ * The number of threads which help filling one reach fan.  Both fans
+ * are solved concurrently, each by one thread plus this many.
+ */
+static unsigned
+GetReachFanWorkers() noexcept
+{
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  return n_cpus > 2 ? (n_cpus - 2) / 2 : 0;
+}
+
 RoutePlanner::RoutePlanner()
   :terrain(NULL), planner(0),
    unique_links(50000),
+   reach_fan_workers(std::thread::hardware_concurrency() > 1 ? 1 : 0),
+   reach_terrain_workers(GetReachFanWorkers()),
+   reach_working_workers(GetReachFanWorkers()),
    reach_polar_mode(RoutePlannerConfig::Polar::TASK)
 {
   Reset();
@@ -62,7 +78,8 @@ RoutePlanner::SolveReachTerrain(const AGeoPoint &origin,
   rpolars_reach.SetConfig(config, origin.altitude, h_ceiling);
   reach_polar_mode = config.reach_polar_mode;
 
-  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve);
+  return reach_terrain.Solve(origin, rpolars_reach, terrain, do_solve,
+                             &reach_terrain_workers);
 }
 
 bool
@@ -73,7 +90,43 @@ RoutePlanner::SolveReachWorking(const AGeoPoint &origin,
   rpolars_reach_working.SetConfig(config, origin.altitude, h_ceiling);
   // reach_polar_mode previously set by SolveReachTerrain
 
-  return reach_working.Solve(origin, rpolars_reach_working, terrain, do_solve);
+  return reach_working.Solve(origin, rpolars_reach_working, terrain, do_solve,
+                             &reach_working_workers);
+}
+
+void
+RoutePlanner::SolveReach(const AGeoPoint &origin,
+                         const RoutePlannerConfig &config,
+                         const int h_ceiling, const bool do_solve)
+{
+  reach_fan_workers.Run(2, [&](std::size_t i){
+    if (i == 0)
+      SolveReachTerrain(origin, config, h_ceiling, do_solve);
+    else
+      SolveReachWorking(origin, config, h_ceiling, do_solve);
+  });
+}
+
+bool
+RoutePlanner::UpdateReach(const AGeoPoint &origin,
+                          const RoutePlannerConfig &config,
+                          const int h_ceiling)
+{
+  if (config.reach_polar_mode != reach_polar_mode)
+    return false;
+
+  rpolars_reach.SetConfig(config, origin.altitude, h_ceiling);
+  rpolars_reach_working.SetConfig(config, origin.altitude, h_ceiling);
+
+  bool result[2];
+  reach_fan_workers.Run(2, [&](std::size_t i){
+    if (i == 0)
+      result[i] = reach_terrain.Update(origin, rpolars_reach, terrain);
+    else
+      result[i] = reach_working.Update(origin, rpolars_reach_working, terrain);
+  });
+
+  return result[0] && result[1];
 }
 
 bool
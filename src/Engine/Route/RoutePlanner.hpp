@@ -30,6 +30,7 @@
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/SearchPointVector.hpp"
 #include "ReachFan.hpp"
+#include "ReachWorkerPool.hpp"
 
 #include <utility>
 #include <unordered_set>
@@ -146,6 +147,13 @@ private:
   ReachFan reach_terrain;
   ReachFan reach_working;
 
+  /** Solves #reach_terrain and #reach_working concurrently */
+  ReachWorkerPool reach_fan_workers;
+  /** Help filling #reach_terrain */
+  ReachWorkerPool reach_terrain_workers;
+  /** Help filling #reach_working */
+  ReachWorkerPool reach_working_workers;
+
   RoutePlannerConfig::Polar reach_polar_mode;
 
   mutable unsigned long count_dij;
@@ -222,6 +230,32 @@ public:
   bool SolveReachWorking(const AGeoPoint &origin, const RoutePlannerConfig &config,
                          int h_ceiling, bool do_solve=true);
 
+  /**
+   * Solve both reach footprints, to terrain and to working height.
+   * They are independent of each other, and are solved concurrently.
+   *
+   * @param origin The start of the search (current aircraft location)
+   * @param do_solve actually solve or just perform minimal calculations
+   */
+  void SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
+                  int h_ceiling, bool do_solve=true);
+
+  /**
+   * Update both reach footprints after the aircraft has moved a
+   * little since the last SolveReach() call, reusing the previous
+   * solution (see ReachFan::Update()).  The two fans are updated
+   * concurrently, just like in SolveReach().  The result is
+   * conservative; call SolveReach() regularly to find the complete
+   * reach again.
+   *
+   * @param origin The new aircraft location
+   *
+   * @return false if the previous solution cannot be reused; call
+   * SolveReach() then
+   */
+  bool UpdateReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
+                   int h_ceiling);
+
   const FlatProjection &GetTerrainReachProjection() const {
     return reach_terrain.GetProjection();
   }
@@ -0,0 +1,254 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "SearchPointArrays.hpp"
+#include "SearchPointVector.hpp"
+#include "Math/Line2D.hpp"
+#include "Math/Point2D.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+typedef double DoubleVector
+  __attribute__((vector_size(SearchPointArrays::DOUBLE_SIZE * sizeof(double))));
+typedef int64_t LongVector
+  __attribute__((vector_size(SearchPointArrays::DOUBLE_SIZE * sizeof(int64_t))));
+gcc_always_inline
+static inline DoubleVector
+LoadDouble(const double *p) noexcept
+{
+  DoubleVector v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+typedef SearchPointArrays::Vector Vector;
+
+gcc_always_inline
+static inline Vector
+Min(Vector a, Vector b) noexcept
+{
+  return a < b ? a : b;
+}
+
+gcc_always_inline
+static inline Vector
+Max(Vector a, Vector b) noexcept
+{
+  return a > b ? a : b;
+}
+
+gcc_always_inline
+static inline bool
+Any(LongVector mask) noexcept
+{
+  int64_t result = 0;
+  for (unsigned i = 0; i < SearchPointArrays::DOUBLE_SIZE; ++i)
+    result |= mask[i];
+  return result != 0;
+}
+
+/**
+ * The number of array elements for the given number of points: a
+ * whole number of blocks plus the end of the last segment.
+ */
+static constexpr std::size_t
+PaddedSize(unsigned n_points) noexcept
+{
+  return (n_points + SearchPointArrays::SIZE - 1)
+    / SearchPointArrays::SIZE * SearchPointArrays::SIZE + 1;
+}
+
+void
+SearchPointArrays::SetLocations(const SearchPointVector &border) noexcept
+{
+  x.clear();
+  y.clear();
+
+  if (border.size() < MIN_POINTS ||
+      border.front().GetLocation() != border.back().GetLocation()) {
+    n_points = 0;
+    longitude.clear();
+    latitude.clear();
+    return;
+  }
+
+  n_points = border.size();
+
+  const GeoPoint first = border.front().GetLocation();
+  longitude.assign(PaddedSize(n_points), first.longitude.Native());
+  latitude.assign(PaddedSize(n_points), first.latitude.Native());
+
+  for (unsigned i = 0; i < n_points; ++i) {
+    const GeoPoint &p = border[i].GetLocation();
+    longitude[i] = p.longitude.Native();
+    latitude[i] = p.latitude.Native();
+  }
+}
+
+void
+SearchPointArrays::SetFlatLocations(const SearchPointVector &border) noexcept
+{
+  if (!IsDefined())
+    return;
+
+  assert(border.size() == n_points);
+
+  const FlatGeoPoint first = border.front().GetFlatLocation();
+  x.assign(PaddedSize(n_points), first.x);
+  y.assign(PaddedSize(n_points), first.y);
+
+  for (unsigned i = 0; i < n_points; ++i) {
+    const FlatGeoPoint &p = border[i].GetFlatLocation();
+    x[i] = p.x;
+    y[i] = p.y;
+  }
+}
+
+bool
+SearchPointArrays::IsInside(const GeoPoint &p) const noexcept
+{
+  assert(IsDefined());
+
+  const double py = p.latitude.Native();
+  const Point2D<double> pt(p.longitude.Native(), py);
+
+  /* the winding number test of PolygonInterior(); the vector code
+     only finds the edges which cross the point's latitude (the
+     degenerate wrap-around and padding edges never do), and these
+     few are evaluated like the scalar code does */
+  int wn = 0;
+
+  for (unsigned i = 0; i < n_points - 1; i += SIZE) {
+    LongVector crossing[SIZE / DOUBLE_SIZE];
+    LongVector any{};
+    for (unsigned j = 0; j < SIZE / DOUBLE_SIZE; ++j) {
+      const unsigned k = i + j * DOUBLE_SIZE;
+      crossing[j] = (LoadDouble(&latitude[k]) <= py) ^
+        (LoadDouble(&latitude[k + 1]) <= py);
+      any |= crossing[j];
+    }
+
+    if (!Any(any))
+      continue;
+
+    for (unsigned j = 0; j < SIZE; ++j) {
+      if (!crossing[j / DOUBLE_SIZE][j % DOUBLE_SIZE])
+        continue;
+
+      const unsigned k = i + j;
+      const Point2D<double> a(longitude[k], latitude[k]);
+      const Point2D<double> b(longitude[k + 1], latitude[k + 1]);
+      const double is_left = Line2D<Point2D<double>>(a, b).LocatePoint(pt);
+
+      if (a.y <= py) {
+        /* an upward crossing */
+        if (is_left > 0)
+          ++wn;
+      } else {
+        /* a downward crossing */
+        if (is_left < 0)
+          --wn;
+      }
+    }
+  }
+
+  return wn != 0;
+}
+
+inline int32_t
+SearchPointArrays::InitialLimit(const FlatGeoPoint &p) const noexcept
+{
+  /* the Chebyshev distance to the nearest vertex, multiplied by
+     sqrt(2), is an upper bound of the distance to the nearest
+     segment; allow for rounding the result twice */
+  Vector nearest = Vector{} + INT32_MAX;
+  for (unsigned i = 0; i < n_points; i += SIZE) {
+    Vector dx = Load(&x[i]) - p.x, dy = Load(&y[i]) - p.y;
+    dx = Max(dx, -dx);
+    dy = Max(dy, -dy);
+    nearest = Min(nearest, Max(dx, dy));
+  }
+
+  int32_t result = nearest[0];
+  for (unsigned i = 1; i < SIZE; ++i)
+    result = std::min(result, nearest[i]);
+
+  const double l = result * M_SQRT2 + 3;
+  return l < INT32_MAX ? int32_t(l) + 1 : INT32_MAX;
+}
+
+FlatGeoPoint
+SearchPointArrays::NearestPoint(const FlatGeoPoint &p) const noexcept
+{
+  assert(IsProjected());
+
+  /* the Chebyshev distance between the point and a segment's
+     bounding box is a lower bound of the distance to the segment;
+     rounding SearchPointVector::NearestPointOnSegment() moves the
+     result by less than two units, so a segment whose lower bound
+     exceeds the square root of the best distance so far plus two
+     cannot be strictly better, and is skipped; the remaining ones
+     are evaluated exactly, in the same order as
+     SearchPointVector::NearestPoint() */
+  uint64_t distance_min = UINT64_MAX;
+  int32_t limit = InitialLimit(p);
+  FlatGeoPoint point_best;
+
+  for (unsigned i = 0; i < n_points; i += SIZE) {
+    const Vector x0 = Load(&x[i]), y0 = Load(&y[i]);
+    const Vector x1 = Load(&x[i + 1]), y1 = Load(&y[i + 1]);
+
+    const Vector dx = Max(Min(x0, x1) - p.x, p.x - Max(x0, x1));
+    const Vector dy = Max(Min(y0, y1) - p.y, p.y - Max(y0, y1));
+    const Vector candidate = Max(dx, dy) <= limit;
+
+    unsigned mask = 0;
+    for (unsigned j = 0; j < SIZE; ++j)
+      mask |= (candidate[j] & 1u) << j;
+
+    while (mask != 0) {
+      const unsigned k = i + __builtin_ctz(mask);
+      mask &= mask - 1;
+
+      if (k >= n_points)
+        break;
+
+      const FlatGeoPoint pa =
+        SearchPointVector::NearestPointOnSegment({x[k], y[k]},
+                                                 {x[k + 1], y[k + 1]}, p);
+      const uint64_t d = SearchPointVector::DistanceSquared(p, pa);
+      if (d < distance_min) {
+        distance_min = d;
+        point_best = pa;
+
+        const double l = std::sqrt(double(d)) + 2;
+        limit = l < INT32_MAX ? int32_t(l) + 1 : INT32_MAX;
+      }
+    }
+  }
+
+  return point_best;
+}
@@ -0,0 +1,196 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_SEARCH_POINT_ARRAYS_HPP
+#define XCSOAR_SEARCH_POINT_ARRAYS_HPP
+
+#include "Flat/FlatRay.hpp"
+#include "util/Compiler.h"
+
+#include <cstdint>
+#include <vector>
+
+#include <string.h>
+
+struct GeoPoint;
+struct FlatGeoPoint;
+class SearchPointVector;
+
+/**
+ * A structure-of-arrays copy of a polygon border, for vectorised
+ * versions of the hot #SearchPointVector loops.  The kernels use
+ * GCC's generic vector types, which the compiler maps to SSE2/AVX2
+ * or NEON instructions, and they return exactly the same results as
+ * the scalar code.
+ *
+ * Segment i connects point i with point i+1; the last one wraps
+ * around to the first point.  The arrays are padded with copies of
+ * the first point to a whole number of blocks, plus one point for
+ * the end of the last segment.  Since the border is closed, the
+ * wrap-around segment and the padding segments are degenerate, and
+ * the kernels need no special case for them.
+ */
+class SearchPointArrays {
+public:
+  /**
+   * The number of 32 bit lanes per block: one 256 bit register with
+   * AVX2, one 128 bit register everywhere else (SSE2, NEON).
+   */
+#ifdef __AVX2__
+  static constexpr unsigned SIZE = 8;
+#else
+  static constexpr unsigned SIZE = 4;
+#endif
+
+  /**
+   * The number of 64 bit lanes per (half) block.
+   */
+  static constexpr unsigned DOUBLE_SIZE = SIZE / 2;
+
+  typedef int32_t Vector __attribute__((vector_size(SIZE * sizeof(int32_t))));
+
+  /**
+   * Borders with fewer points are not worth the setup; callers use
+   * the scalar #SearchPointVector methods for them.
+   */
+  static constexpr unsigned MIN_POINTS = 2 * SIZE;
+
+private:
+  std::vector<double> longitude, latitude;
+  std::vector<int32_t> x, y;
+
+  /**
+   * The number of points (= segments) of the original border; 0 if
+   * not defined.
+   */
+  unsigned n_points = 0;
+
+public:
+  bool IsDefined() const noexcept {
+    return n_points > 0;
+  }
+
+  /**
+   * Have the flat locations been copied with SetFlatLocations()?
+   */
+  bool IsProjected() const noexcept {
+    return !x.empty();
+  }
+
+  /**
+   * Copy the geographic locations of the given border.  Borders with
+   * fewer than #MIN_POINTS points and borders which are not closed
+   * (i.e. the last point differs from the first one) clear this
+   * object.
+   */
+  void SetLocations(const SearchPointVector &border) noexcept;
+
+  /**
+   * Copy the flat locations of the given (projected) border, which
+   * must be the one passed to SetLocations().
+   */
+  void SetFlatLocations(const SearchPointVector &border) noexcept;
+
+  /**
+   * Same as SearchPointVector::IsInside(const GeoPoint &).
+   */
+  [[gnu::pure]]
+  bool IsInside(const GeoPoint &p) const noexcept;
+
+  /**
+   * Same as SearchPointVector::NearestPoint().  Requires
+   * IsProjected().
+   */
+  [[gnu::pure]]
+  FlatGeoPoint NearestPoint(const FlatGeoPoint &p) const noexcept;
+
+  /**
+   * Invoke f(t) with FlatRay::DistinctIntersection() of the given
+   * ray and every segment (except the wrap-around one) for which it
+   * is not negative, in order.  Requires IsProjected().
+   */
+  template<typename F>
+  void VisitIntersections(const FlatRay &ray, F &&f) const {
+    for (unsigned i = 0; i < n_points - 1; i += SIZE) {
+      unsigned mask = IntersectionMask(ray, i);
+      while (mask != 0) {
+        const unsigned j = i + __builtin_ctz(mask);
+        mask &= mask - 1;
+
+        const FlatRay segment({x[j], y[j]}, {x[j + 1], y[j + 1]});
+        f(ray.DistinctIntersection(segment));
+      }
+    }
+  }
+
+private:
+  [[gnu::pure]]
+  int32_t InitialLimit(const FlatGeoPoint &p) const noexcept;
+
+  gcc_always_inline
+  static Vector Load(const int32_t *p) noexcept {
+    Vector v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+  }
+
+  /**
+   * Determine which of the #SIZE segments beginning at #first
+   * intersect the ray, with the same criteria as
+   * FlatRay::DistinctIntersection().  Bit n of the return value
+   * refers to segment #first+n.
+   */
+  gcc_always_inline
+  unsigned IntersectionMask(const FlatRay &ray, unsigned first) const noexcept {
+    const Vector x0 = Load(&x[first]), y0 = Load(&y[first]);
+    const Vector vx = Load(&x[first + 1]) - x0;
+    const Vector vy = Load(&y[first + 1]) - y0;
+    const Vector dx = x0 - ray.point.x, dy = y0 - ray.point.y;
+
+    /* see FlatRay::IntersectsRatio(); the comparison results are 0
+       or -1 */
+    const Vector denominator = ray.vector.x * vy - vx * ray.vector.y;
+    const Vector ua = dx * vy - vx * dy;
+    const Vector ub = dx * ray.vector.y - ray.vector.x * dy;
+
+    const Vector negative = denominator < 0;
+    const Vector abs_denominator = (denominator ^ negative) - negative;
+    const Vector signed_ua = (ua ^ negative) - negative;
+    const Vector abs_ua = (ua ^ (ua >> 31)) - (ua >> 31);
+    const Vector abs_ub = (ub ^ (ub >> 31)) - (ub >> 31);
+
+    /* the degenerate wrap-around and padding segments never hit,
+       because their denominator is 0 */
+    const Vector hit = (denominator != 0) &
+      (signed_ua > 0) & (abs_ua < abs_denominator) &
+      ((ub < 0) == negative) & (abs_ub <= abs_denominator);
+
+    unsigned mask = 0;
+    for (unsigned i = 0; i < SIZE; ++i)
+      mask |= (hit[i] & 1u) << i;
+    return mask;
+  }
+};
+
+#endif
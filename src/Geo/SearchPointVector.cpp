@@ -55,18 +55,20 @@ SearchPointVector::Project(const FlatProjection &tp)
     i.Project(tp);
 }
 
-[[gnu::pure]]
-static FlatGeoPoint
-NearestPoint(const FlatGeoPoint &p1, const FlatGeoPoint &p2,
-              const FlatGeoPoint &p3)
+FlatGeoPoint
+SearchPointVector::NearestPointOnSegment(const FlatGeoPoint &p1,
+                                         const FlatGeoPoint &p2,
+                                         const FlatGeoPoint &p3)
 {
+  /* calculate the products in double precision; the int ones may
+     overflow for long segments */
   const FlatGeoPoint p12 = p2-p1;
-  const double rsq(p12.DotProduct(p12));
+  const double rsq = DotProduct<FlatGeoPoint, double>(p12, p12);
   if (rsq <= 0)
     return p1;
 
   const FlatGeoPoint p13 = p3-p1;
-  const double numerator(p13.DotProduct(p12));
+  const double numerator = DotProduct<FlatGeoPoint, double>(p13, p12);
   
   if (numerator <= 0) {
     return p1;
@@ -85,13 +87,13 @@ SegmentNearestPoint(const SearchPointVector& spv,
                       const FlatGeoPoint &p3)
 {
   if (i1+1 == spv.end()) {
-    return NearestPoint(i1->GetFlatLocation(),
-                        spv.begin()->GetFlatLocation(),
-                        p3);
+    return SearchPointVector::NearestPointOnSegment(i1->GetFlatLocation(),
+                                                    spv.begin()->GetFlatLocation(),
+                                                    p3);
   } else {
-    return NearestPoint(i1->GetFlatLocation(),
-                        (i1 + 1)->GetFlatLocation(),
-                        p3);
+    return SearchPointVector::NearestPointOnSegment(i1->GetFlatLocation(),
+                                                    (i1 + 1)->GetFlatLocation(),
+                                                    p3);
   }
 }
 
@@ -99,13 +101,13 @@ SegmentNearestPoint(const SearchPointVector& spv,
 static FlatGeoPoint
 NearestPointNonConvex(const SearchPointVector& spv, const FlatGeoPoint &p3)
 {
-  unsigned distance_min = 0-1;
+  uint64_t distance_min = UINT64_MAX;
   FlatGeoPoint point_best;
 
   for (auto i = spv.begin(); i!= spv.end(); ++i) {
 
     FlatGeoPoint pa = SegmentNearestPoint(spv,i,p3);
-    unsigned d_this = p3.DistanceSquared(pa);
+    uint64_t d_this = SearchPointVector::DistanceSquared(p3, pa);
     if (d_this<distance_min) {
       distance_min = d_this;
       point_best = pa;
@@ -25,6 +25,7 @@
 
 #include "SearchPoint.hpp"
 
+#include <cstdint>
 #include <vector>
 
 class FlatRay;
@@ -49,6 +50,25 @@ public:
 
   void Project(const FlatProjection &tp);
 
+  /**
+   * Like FlatGeoPoint::DistanceSquared(), but without overflowing for
+   * distant points.
+   */
+  [[gnu::pure]]
+  static uint64_t DistanceSquared(const FlatGeoPoint &a,
+                                  const FlatGeoPoint &b) noexcept {
+    const FlatGeoPoint delta = a - b;
+    return DotProduct<FlatGeoPoint, int64_t>(delta, delta);
+  }
+
+  /**
+   * Find the point on the segment a-b which is nearest to p.
+   */
+  [[gnu::pure]]
+  static FlatGeoPoint NearestPointOnSegment(const FlatGeoPoint &a,
+                                            const FlatGeoPoint &b,
+                                            const FlatGeoPoint &p);
+
   [[gnu::pure]]
   FlatGeoPoint NearestPoint(const FlatGeoPoint &p) const;
 
@@ -0,0 +1,401 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGCBulkParser.hpp"
+#include "IGCParser.hpp"
+#include "IGCFix.hpp"
+#include "IGCExtensions.hpp"
+#include "system/FileMapping.hpp"
+#include "system/Path.hpp"
+#include "util/CharUtil.hxx"
+#include "util/StringAPI.hxx"
+
+#include <array>
+#include <string>
+
+#include <string.h>
+
+/**
+ * The length of the fixed part of a B record:
+ * "B" HHMMSS DDMMmmm[NS] DDDMMmmm[EW] [AV] PPPPP GGGGG
+ */
+static constexpr std::size_t B_RECORD_LENGTH = 35;
+
+struct ExtensionColumn {
+  const char *code;
+  std::vector<int16_t> IGCFixColumns::*column;
+  int16_t IGCFix::*field;
+
+  /**
+   * If non-zero, only this many characters are parsed; see
+   * ParseExtensionValueN() in IGCParser.cpp.
+   */
+  unsigned n;
+};
+
+static constexpr std::array<ExtensionColumn, 10> extension_columns{{
+  {"ENL", &IGCFixColumns::enl, &IGCFix::enl, 0},
+  {"RPM", &IGCFixColumns::rpm, &IGCFix::rpm, 0},
+  {"HDM", &IGCFixColumns::hdm, &IGCFix::hdm, 0},
+  {"HDT", &IGCFixColumns::hdt, &IGCFix::hdt, 0},
+  {"TRM", &IGCFixColumns::trm, &IGCFix::trm, 0},
+  {"TRT", &IGCFixColumns::trt, &IGCFix::trt, 0},
+  {"GSP", &IGCFixColumns::gsp, &IGCFix::gsp, 3},
+  {"IAS", &IGCFixColumns::ias, &IGCFix::ias, 3},
+  {"TAS", &IGCFixColumns::tas, &IGCFix::tas, 3},
+  {"SIU", &IGCFixColumns::siu, &IGCFix::siu, 0},
+}};
+
+void
+IGCFixColumns::clear() noexcept
+{
+  date = BrokenDate::Invalid();
+  time.clear();
+  latitude.clear();
+  longitude.clear();
+  gps_valid.clear();
+  gps_altitude.clear();
+  pressure_altitude.clear();
+
+  for (const auto &i : extension_columns)
+    (this->*i.column).clear();
+}
+
+void
+IGCFixColumns::Get(std::size_t i, IGCFix &fix) const noexcept
+{
+  fix.time = BrokenTime::FromSecondOfDay(time[i]);
+  fix.location = GeoPoint(longitude[i], latitude[i]);
+  fix.gps_valid = gps_valid[i];
+  fix.gps_altitude = gps_altitude[i];
+  fix.pressure_altitude = pressure_altitude[i];
+
+  fix.ClearExtensions();
+  for (const auto &e : extension_columns) {
+    const auto &column = this->*e.column;
+    if (!column.empty())
+      fix.*e.field = column[i];
+  }
+}
+
+/**
+ * Parse exactly #n decimal digits.
+ *
+ * @return false if one of the characters is not a digit
+ */
+static inline bool
+ParseDigits(const char *p, unsigned n, unsigned &value_r) noexcept
+{
+  unsigned value = 0;
+  for (unsigned i = 0; i < n; ++i) {
+    const unsigned digit = unsigned(p[i]) - '0';
+    if (digit > 9)
+      return false;
+
+    value = value * 10 + digit;
+  }
+
+  value_r = value;
+  return true;
+}
+
+/**
+ * Parse a 5 character altitude, which is either 5 digits or a minus
+ * sign followed by 4 digits.
+ */
+static inline bool
+ParseAltitude(const char *p, int32_t &value_r) noexcept
+{
+  unsigned value;
+  if (*p == '-') {
+    if (!ParseDigits(p + 1, 4, value))
+      return false;
+
+    value_r = -int32_t(value);
+  } else {
+    if (!ParseDigits(p, 5, value))
+      return false;
+
+    value_r = value;
+  }
+
+  return true;
+}
+
+/**
+ * See ParseUnsigned() in IGCParser.cpp.
+ */
+static int
+ParseExtensionValue(const char *p, const char *end) noexcept
+{
+  unsigned value = 0;
+
+  for (; p < end; ++p) {
+    if (!IsDigitASCII(*p))
+      return -1;
+
+    value = value * 10 + (*p - '0');
+  }
+
+  return value;
+}
+
+namespace {
+
+/**
+ * The state of IGCParseFixes() while it walks through the file.
+ */
+class BulkParser {
+  IGCFixColumns &columns;
+
+  /**
+   * The extensions declared by the "I" record, for the fallback to
+   * IGCParseFix().
+   */
+  IGCExtensions extensions;
+
+  struct Extension {
+    /**
+     * Zero-based offsets within the line.
+     */
+    unsigned start, finish;
+
+    /**
+     * Index into #extension_columns.
+     */
+    unsigned column;
+  };
+
+  /**
+   * The known extensions of #extensions.
+   */
+  std::vector<Extension> decoders;
+
+  /**
+   * Which of #extension_columns are being filled?
+   */
+  std::array<bool, extension_columns.size()> active;
+
+  /**
+   * A null-terminated copy of the current line for the IGCParser.hpp
+   * functions.
+   */
+  std::string buffer;
+
+public:
+  explicit BulkParser(IGCFixColumns &_columns) noexcept
+    :columns(_columns) {
+    extensions.clear();
+
+    for (std::size_t i = 0; i < extension_columns.size(); ++i)
+      active[i] = !(columns.*extension_columns[i].column).empty();
+  }
+
+  void ParseLine(const char *line, std::size_t length) {
+    switch (line[0]) {
+    case 'B':
+      if (!ParseFixFast(line, length))
+        ParseFixSlow(line, length);
+      break;
+
+    case 'I':
+      ParseExtensions(line, length);
+      break;
+
+    case 'H':
+      if (!columns.date.IsPlausible() && length >= 5 &&
+          memcmp(line, "HFDTE", 5) == 0)
+        IGCParseDateRecord(Terminate(line, length), columns.date);
+      break;
+    }
+  }
+
+private:
+  const char *Terminate(const char *line, std::size_t length) {
+    buffer.assign(line, length);
+    return buffer.c_str();
+  }
+
+  void ParseExtensions(const char *line, std::size_t length) {
+    if (!IGCParseExtensions(Terminate(line, length), extensions)) {
+      extensions.clear();
+      decoders.clear();
+      return;
+    }
+
+    decoders.clear();
+    for (const auto &x : extensions) {
+      for (std::size_t i = 0; i < extension_columns.size(); ++i) {
+        if (!StringIsEqual(x.code, extension_columns[i].code))
+          continue;
+
+        decoders.push_back({x.start - 1u, x.finish, unsigned(i)});
+
+        if (!active[i]) {
+          /* new column: fill the rows parsed so far */
+          (columns.*extension_columns[i].column).assign(columns.size(), -1);
+          active[i] = true;
+        }
+      }
+    }
+  }
+
+  /**
+   * Decode a B record with the standard layout in place.
+   *
+   * @return false if the line does not have the standard layout
+   * (it may still be valid for IGCParseFix())
+   */
+  bool ParseFixFast(const char *line, std::size_t length) {
+    if (length < B_RECORD_LENGTH)
+      return false;
+
+    unsigned hour, minute, second;
+    if (!ParseDigits(line + 1, 2, hour) ||
+        !ParseDigits(line + 3, 2, minute) ||
+        !ParseDigits(line + 5, 2, second) ||
+        hour >= 24 || minute >= 60 || second >= 60)
+      return false;
+
+    unsigned lat_degrees, lat_minutes, lon_degrees, lon_minutes;
+    if (!ParseDigits(line + 7, 2, lat_degrees) ||
+        !ParseDigits(line + 9, 5, lat_minutes) ||
+        !ParseDigits(line + 15, 3, lon_degrees) ||
+        !ParseDigits(line + 18, 5, lon_minutes) ||
+        lat_degrees >= 90 || lat_minutes >= 60000 ||
+        lon_degrees >= 180 || lon_minutes >= 60000)
+      return false;
+
+    const char lat_char = line[14], lon_char = line[23];
+    if ((lat_char != 'N' && lat_char != 'S') ||
+        (lon_char != 'E' && lon_char != 'W'))
+      return false;
+
+    const char valid_char = line[24];
+    if (valid_char != 'A' && valid_char != 'V')
+      return false;
+
+    int32_t pressure_altitude, gps_altitude;
+    if (!ParseAltitude(line + 25, pressure_altitude) ||
+        !ParseAltitude(line + 30, gps_altitude))
+      return false;
+
+    /* same calculation as in IGCParseLocation() */
+    Angle latitude = Angle::Degrees(lat_degrees + lat_minutes / 60000.);
+    if (lat_char == 'S')
+      latitude.Flip();
+
+    Angle longitude = Angle::Degrees(lon_degrees + lon_minutes / 60000.);
+    if (lon_char == 'W')
+      longitude.Flip();
+
+    columns.time.push_back(hour * 3600 + minute * 60 + second);
+    columns.latitude.push_back(latitude);
+    columns.longitude.push_back(longitude);
+    columns.gps_valid.push_back(valid_char == 'A');
+    columns.pressure_altitude.push_back(pressure_altitude);
+    columns.gps_altitude.push_back(gps_altitude);
+
+    std::array<int16_t, extension_columns.size()> values;
+    values.fill(-1);
+
+    for (const auto &d : decoders) {
+      if (d.finish > length)
+        /* exceeds the input line length */
+        continue;
+
+      const char *start = line + d.start;
+      const unsigned n = extension_columns[d.column].n;
+      const char *finish = n > 0
+        ? start + n
+        : line + d.finish;
+
+      if (finish > line + length)
+        /* IGCParseFix() would hit the null terminator */
+        continue;
+
+      const int value = ParseExtensionValue(start, finish);
+      if (value >= 0)
+        values[d.column] = value;
+    }
+
+    PushExtensions(values);
+    return true;
+  }
+
+  void ParseFixSlow(const char *line, std::size_t length) {
+    IGCFix fix;
+    if (!IGCParseFix(Terminate(line, length), extensions, fix))
+      return;
+
+    columns.time.push_back(fix.time.GetSecondOfDay());
+    columns.latitude.push_back(fix.location.latitude);
+    columns.longitude.push_back(fix.location.longitude);
+    columns.gps_valid.push_back(fix.gps_valid);
+    columns.pressure_altitude.push_back(fix.pressure_altitude);
+    columns.gps_altitude.push_back(fix.gps_altitude);
+
+    std::array<int16_t, extension_columns.size()> values;
+    for (std::size_t i = 0; i < extension_columns.size(); ++i)
+      values[i] = fix.*extension_columns[i].field;
+
+    PushExtensions(values);
+  }
+
+  void PushExtensions(const std::array<int16_t,
+                                       extension_columns.size()> &values) {
+    for (std::size_t i = 0; i < extension_columns.size(); ++i)
+      if (active[i])
+        (columns.*extension_columns[i].column).push_back(values[i]);
+  }
+};
+
+} // anonymous namespace
+
+void
+IGCParseFixes(const char *begin, const char *end, IGCFixColumns &columns)
+{
+  BulkParser parser(columns);
+
+  while (begin < end) {
+    const char *eol = (const char *)memchr(begin, '\n', end - begin);
+    const char *next = eol != nullptr ? eol + 1 : end;
+    const char *line_end = eol != nullptr ? eol : end;
+    if (line_end > begin && line_end[-1] == '\r')
+      --line_end;
+
+    if (line_end > begin)
+      parser.ParseLine(begin, line_end - begin);
+
+    begin = next;
+  }
+}
+
+void
+IGCParseFixes(Path path, IGCFixColumns &columns)
+{
+  /* an empty file has no fixes */
+  const FileMapping mapping(path, true);
+  const char *data = (const char *)mapping.data();
+  IGCParseFixes(data, data + mapping.size(), columns);
+}
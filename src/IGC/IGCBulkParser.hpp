@@ -0,0 +1,109 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_IGC_BULK_PARSER_HPP
+#define XCSOAR_IGC_BULK_PARSER_HPP
+
+#include "Math/Angle.hpp"
+#include "time/BrokenDate.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct IGCFix;
+class Path;
+
+/**
+ * All "B" records of an IGC file, stored column by column: one array
+ * per field.  Analysis code which looks at just a few fields (e.g.
+ * time and location) walks through compact arrays instead of large
+ * #IGCFix structs.
+ *
+ * The extension columns are only filled if the extension was
+ * declared in the "I" record; otherwise they are empty.
+ */
+struct IGCFixColumns {
+  /**
+   * The date from the "HFDTE" record (or invalid).
+   */
+  BrokenDate date = BrokenDate::Invalid();
+
+  /**
+   * Second of day [0..86399] (UTC).
+   */
+  std::vector<uint32_t> time;
+
+  std::vector<Angle> latitude, longitude;
+
+  /**
+   * 1 if this is a 3D fix ("A"), 0 if not ("V").
+   */
+  std::vector<uint8_t> gps_valid;
+
+  std::vector<int32_t> gps_altitude, pressure_altitude;
+
+  /* extensions; see #IGCFix for the meaning of each column */
+  std::vector<int16_t> enl, rpm, hdm, hdt, trm, trt, gsp, ias, tas, siu;
+
+  std::size_t size() const noexcept {
+    return time.size();
+  }
+
+  bool empty() const noexcept {
+    return time.empty();
+  }
+
+  void clear() noexcept;
+
+  /**
+   * Copy one row into an #IGCFix.
+   */
+  void Get(std::size_t i, IGCFix &fix) const noexcept;
+};
+
+/**
+ * Parse all "B" records (and the "I" and "HFDTE" records which
+ * describe them) from a buffer containing a whole IGC file, and
+ * append them to #columns.  The input does not need to be
+ * null-terminated, and it is not copied.
+ *
+ * Each B record is decoded with a fast path which checks the fixed
+ * width fields in place; lines which fail it are passed to
+ * IGCParseFix(), so the result is the same as parsing line by line.
+ * Lines which are not valid B records are skipped.
+ */
+void
+IGCParseFixes(const char *begin, const char *end, IGCFixColumns &columns);
+
+/**
+ * Map the specified IGC file into memory and parse it with
+ * IGCParseFixes().  An empty file adds no fixes.
+ *
+ * Throws on error (e.g. if the file does not exist or if it is too
+ * large to be mapped).
+ */
+void
+IGCParseFixes(Path path, IGCFixColumns &columns);
+
+#endif
@@ -35,7 +35,8 @@ IGCWriter::IGCWriter(Path path)
         /* we use CREATE_VISIBLE here so the user can recover partial
            IGC files after a crash/battery failure/etc. */
         FileOutputStream::Mode::CREATE_VISIBLE),
-   buffered(file)
+   async(file),
+   buffered(async)
 {
   fix.Clear();
 
@@ -48,6 +49,10 @@ IGCWriter::CommitLine(char *line)
   buffered.Write(line);
   buffered.Write('\n');
 
+  /* pass the line to the AsyncFileOutputStream right away, which
+     writes it within its sync interval */
+  buffered.Flush();
+
   grecord.AppendRecordToBuffer(line);
 }
 
@@ -212,8 +217,9 @@ IGCWriter::LogPoint(const IGCFix &fix, int epe, int satellites)
           NormalizeIGCAltitude(fix.gps_altitude),
           epe, satellites);
 
+  /* CommitLine() hands the line to the writer thread; don't wait
+     for it here, the periodic sync makes it durable */
   WriteLine(b_record);
-  Flush();
 }
 
 void
@@ -283,4 +289,5 @@ IGCWriter::Sign()
 {
   grecord.FinalizeBuffer();
   grecord.WriteTo(buffered);
+  Flush();
 }
@@ -27,6 +27,7 @@ Copyright_License {
 #include "Logger/GRecord.hpp"
 #include "IGCFix.hpp"
 #include "io/FileOutputStream.hxx"
+#include "io/AsyncFileOutputStream.hpp"
 #include "io/BufferedOutputStream.hxx"
 
 #include <tchar.h>
@@ -43,6 +44,13 @@ class IGCWriter {
   };
 
   FileOutputStream file;
+
+  /**
+   * Writes to #file in a separate thread, so slow storage does not
+   * stall the calculation thread.
+   */
+  AsyncFileOutputStream async;
+
   BufferedOutputStream buffered;
 
   GRecord grecord;
@@ -57,8 +65,15 @@ public:
    */
   explicit IGCWriter(Path path);
 
+  /**
+   * Wait until all lines have been written to the file and synced
+   * to the storage device.  This blocks on the writer thread, so it
+   * is only meant to be called when the log is finished, not for
+   * each fix.
+   */
   void Flush() {
     buffered.Flush();
+    async.Flush();
   }
 
   void Sign();
@@ -22,17 +22,41 @@ Copyright_License {
 */
 
 #include "Logger/NMEALogger.hpp"
-#include "io/TextWriter.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/AsyncFileOutputStream.hpp"
 #include "LocalPath.hpp"
+#include "LogFile.hpp"
 #include "time/BrokenDateTime.hpp"
 #include "thread/Mutex.hxx"
 #include "system/Path.hpp"
 #include "util/StaticString.hxx"
 
+#include <string.h>
+
 namespace NMEALogger
 {
+  /**
+   * Lines longer than this are truncated; NMEA sentences are limited
+   * to 82 characters, but some devices exceed that.
+   */
+  static constexpr std::size_t MAX_LINE = 256;
+
+  struct NMEALogFile {
+    FileOutputStream file;
+
+    /**
+     * Writes to #file in a separate thread.  Log() never blocks on
+     * it; if the storage device is too slow, lines are dropped.
+     */
+    AsyncFileOutputStream async;
+
+    explicit NMEALogFile(Path path)
+      :file(path, FileOutputStream::Mode::CREATE_VISIBLE),
+       async(file) {}
+  };
+
   static Mutex mutex;
-  static TextWriter *writer;
+  static NMEALogFile *writer;
 
   bool enabled = false;
 
@@ -56,13 +80,9 @@ NMEALogger::Start()
   const auto logs_path = MakeLocalPath(_T("logs"));
 
   const auto path = AllocatedPath::Build(logs_path, name);
-  writer = new TextWriter(path, false);
-  if (writer == nullptr)
-    return false;
-
-  if (!writer->IsOpen()) {
-    delete writer;
-    writer = nullptr;
+  try {
+    writer = new NMEALogFile(path);
+  } catch (...) {
     return false;
   }
 
@@ -72,7 +92,15 @@ NMEALogger::Start()
 void
 NMEALogger::Shutdown()
 {
+  if (writer == nullptr)
+    return;
+
+  const std::size_t dropped = writer->async.GetDroppedBytes();
+  if (dropped > 0)
+    LogFormat("NMEA logger dropped %zu bytes", dropped);
+
   delete writer;
+  writer = nullptr;
 }
 
 void
@@ -81,7 +109,17 @@ NMEALogger::Log(const char *text)
   if (!enabled)
     return;
 
+  /* append the line terminator here so the line is submitted in one
+     piece */
+  char buffer[MAX_LINE + 2];
+  std::size_t length = std::min(strlen(text), MAX_LINE);
+  memcpy(buffer, text, length);
+#ifndef HAVE_POSIX
+  buffer[length++] = '\r';
+#endif
+  buffer[length++] = '\n';
+
   std::lock_guard<Mutex> lock(mutex);
   if (Start())
-    writer->WriteLine(text);
+    writer->async.TryWrite(buffer, length);
 }
@@ -0,0 +1,161 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_NMEA_SENTENCE_TABLE_HPP
+#define XCSOAR_NMEA_SENTENCE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * A hash table which maps NMEA sentence names (e.g. "RMC" or "PFLAU")
+ * to a value, usually an enum which is then dispatched with a
+ * "switch".  It is meant to be built at compile time ("static
+ * constexpr"): the constructor searches for a hash function which
+ * is perfect for the given set of names, so Find() needs just one
+ * hash calculation and one integer comparison, no matter how many
+ * sentences are known.
+ *
+ * Names are packed into a 64 bit integer, therefore they may have
+ * at most 8 characters.
+ */
+template<typename T, std::size_t N>
+class NMEASentenceTable {
+  static constexpr std::size_t MAX_NAME = 8;
+
+  static constexpr unsigned CalcBits() noexcept {
+    /* at least four times as many slots as names, which makes
+       finding a perfect multiplier quick */
+    unsigned bits = 2;
+    while ((std::size_t(1) << bits) < 4 * N)
+      ++bits;
+    return bits;
+  }
+
+  static constexpr unsigned BITS = CalcBits();
+  static constexpr std::size_t SIZE = std::size_t(1) << BITS;
+
+  struct Slot {
+    /**
+     * The packed name; 0 means this slot is empty.
+     */
+    uint64_t key = 0;
+
+    T value{};
+  };
+
+  uint64_t multiplier = 0;
+
+  Slot slots[SIZE]{};
+
+public:
+  struct Entry {
+    const char *name;
+    T value;
+  };
+
+  constexpr NMEASentenceTable(const Entry (&entries)[N]) {
+    /* try pseudo-random odd multipliers (from a linear
+       congruential generator) until one is collision-free */
+    uint64_t m = 0x9e3779b97f4a7c15;
+    for (unsigned i = 0; i < 4096; ++i) {
+      if (TryMultiplier(entries, m)) {
+        multiplier = m;
+        return;
+      }
+
+      m = (m * 6364136223846793005 + 1442695040888963407) | 1;
+    }
+
+    throw std::logic_error("No perfect hash found");
+  }
+
+  /**
+   * Look up a sentence name.
+   *
+   * @param name the null-terminated sentence name without the
+   * leading "$"
+   * @return a pointer to the value or nullptr if the name is not
+   * known
+   */
+  [[gnu::pure]]
+  const T *Find(const char *name) const noexcept {
+    uint64_t key = 0;
+    for (std::size_t i = 0; name[i] != 0; ++i) {
+      if (i == MAX_NAME)
+        return nullptr;
+
+      key |= uint64_t(uint8_t(name[i])) << (8 * i);
+    }
+
+    const Slot &slot = slots[Hash(key, multiplier)];
+    return slot.key == key && key != 0
+      ? &slot.value
+      : nullptr;
+  }
+
+private:
+  static constexpr uint64_t Pack(const char *name) {
+    uint64_t key = 0;
+    std::size_t i = 0;
+    for (; name[i] != 0; ++i) {
+      if (i == MAX_NAME)
+        throw std::logic_error("Sentence name too long");
+
+      key |= uint64_t(uint8_t(name[i])) << (8 * i);
+    }
+
+    if (i == 0)
+      throw std::logic_error("Empty sentence name");
+
+    return key;
+  }
+
+  static constexpr std::size_t Hash(uint64_t key,
+                                    uint64_t multiplier) noexcept {
+    return (key * multiplier) >> (64 - BITS);
+  }
+
+  constexpr bool TryMultiplier(const Entry (&entries)[N], uint64_t m) {
+    for (auto &slot : slots)
+      slot = Slot{};
+
+    for (const auto &entry : entries) {
+      const uint64_t key = Pack(entry.name);
+      Slot &slot = slots[Hash(key, m)];
+      if (slot.key == key)
+        throw std::logic_error("Duplicate sentence name");
+
+      if (slot.key != 0)
+        return false;
+
+      slot.key = key;
+      slot.value = entry.value;
+    }
+
+    return true;
+  }
+};
+
+#endif
@@ -87,6 +87,7 @@ const char AcknowledgementTime[] = "AcknowledgementTime";
 const char AirfieldFile[] = "AirfieldFile"; // pL
 const char AirspaceFile[] = "AirspaceFile"; // pL
 const char AdditionalAirspaceFile[] = "AdditionalAirspaceFile"; // pL
+const char AirspaceCache[] = "AirspaceCache";
 const char FlarmFile[] = "FlarmFile";
 const char PolarFile[] = "PolarFile"; // pL
 const char WaypointFile[] = "WPFile"; // pL
@@ -204,6 +205,8 @@ const char DisableAutoLogger[] = "DisableAutoLogger";
 const char EnableFlightLogger[] = "EnableFlightLogger";
 const char EnableNMEALogger[] = "EnableNMEALogger";
 const char MapFile[] = "MapFile"; // pL
+const char TerrainTileMemory[] = "TerrainTileMemory";
+const char TerrainTileStore[] = "TerrainTileStore";
 const char BallastSecsToEmpty[] = "BallastSecsToEmpty";
 const char DialogFont[] = "DialogFont";
 const char FontInfoWindowFont[] = "InfoWindowFont";
@@ -62,6 +62,7 @@ extern const char AdditionalWaypointFile[];
 extern const char WatchedWaypointFile[];
 extern const char AirspaceFile[];
 extern const char AdditionalAirspaceFile[];
+extern const char AirspaceCache[];
 extern const char FlarmFile[];
 extern const char AirfieldFile[];
 extern const char PolarFile[];
@@ -200,6 +201,8 @@ extern const char DisableAutoLogger[];
 extern const char EnableFlightLogger[];
 extern const char EnableNMEALogger[];
 extern const char MapFile[];
+extern const char TerrainTileMemory[];
+extern const char TerrainTileStore[];
 extern const char BallastSecsToEmpty[];
 extern const char AccelerometerZero[];
 extern const char DialogFont[];
@@ -364,8 +364,8 @@ Startup()
   rasp->ScanAll();
 
   // Reads the airspace files
-  ReadAirspace(airspace_database, terrain, computer_settings.pressure,
-               operation);
+  ReadAirspace(airspace_database, file_cache, terrain,
+               computer_settings.pressure, operation);
 
   {
     const AircraftState aircraft_state =
@@ -72,6 +72,15 @@ ProtectedRoutePlanner::SolveReach(const AGeoPoint &origin,
   lease->SolveReach(origin, config, h_ceiling, do_solve);
 }
 
+bool
+ProtectedRoutePlanner::UpdateReach(const AGeoPoint &origin,
+                                   const RoutePlannerConfig &config,
+                                   const int h_ceiling)
+{
+  ExclusiveLease lease(*this);
+  return lease->UpdateReach(origin, config, h_ceiling);
+}
+
 const FlatProjection
 ProtectedRoutePlanner::GetTerrainReachProjection() const
 {
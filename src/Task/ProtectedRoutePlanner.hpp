@@ -83,6 +83,9 @@ public:
   void SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
                   int h_ceiling, bool do_solve);
 
+  bool UpdateReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
+                   int h_ceiling);
+
   [[gnu::pure]]
   const FlatProjection GetTerrainReachProjection() const;
 };
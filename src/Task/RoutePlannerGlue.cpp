@@ -69,11 +69,22 @@ RoutePlannerGlue::SolveReach(const AGeoPoint &origin,
 {
   if (terrain) {
     RasterTerrain::Lease lease(*terrain);
-    planner.SolveReachTerrain(origin, config, h_ceiling, do_solve);
-    planner.SolveReachWorking(origin, config, h_ceiling, do_solve);
+    planner.SolveReach(origin, config, h_ceiling, do_solve);
   } else {
-    planner.SolveReachTerrain(origin, config, h_ceiling, do_solve);
-    planner.SolveReachWorking(origin, config, h_ceiling, do_solve);
+    planner.SolveReach(origin, config, h_ceiling, do_solve);
+  }
+}
+
+bool
+RoutePlannerGlue::UpdateReach(const AGeoPoint &origin,
+                              const RoutePlannerConfig &config,
+                              const int h_ceiling)
+{
+  if (terrain) {
+    RasterTerrain::Lease lease(*terrain);
+    return planner.UpdateReach(origin, config, h_ceiling);
+  } else {
+    return planner.UpdateReach(origin, config, h_ceiling);
   }
 }
 
@@ -76,6 +76,9 @@ public:
   void SolveReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
                   int h_ceiling, bool do_solve);
 
+  bool UpdateReach(const AGeoPoint &origin, const RoutePlannerConfig &config,
+                   int h_ceiling);
+
   bool FindPositiveArrival(const AGeoPoint &dest, ReachResult &result_r) const;
 
   const FlatProjection &GetTerrainReachProjection() const {
@@ -231,8 +231,10 @@ RasterTileCache::GetFieldDirect(RasterLocation p) const noexcept
   assert(p.y < size.y);
 
   const RasterTile &tile = tiles.Get(p.x / tile_size.x, p.y / tile_size.y);
-  if (tile.IsEnabled())
+  if (tile.IsEnabled()) {
+    tile.MarkUsed(generation);
     return std::make_pair(tile.GetHeight(p), true);
+  }
 
   // still not found, so go to overview
 
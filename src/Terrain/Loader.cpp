@@ -26,8 +26,10 @@ Copyright_License {
 #include "RasterProjection.hpp"
 #include "ZzipStream.hpp"
 #include "WorldFile.hpp"
+#include "TileStore.hpp"
 #include "Operation/Operation.hpp"
 #include "system/ConvertPathName.hpp"
+#include "thread/Thread.hpp"
 
 extern "C" {
 #include "jasper/jp2/jp2_cod.h"
@@ -35,8 +37,27 @@ extern "C" {
 #include "jasper/jpc/jpc_t1cod.h"
 }
 
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <vector>
+
 #include <string.h>
 
+/**
+ * The maximum number of threads decoding tiles in parallel.  It is
+ * limited by the number of tiles requested in one iteration, see
+ * RasterTileCache::PollTiles().
+ */
+static constexpr unsigned MAX_WORKERS = 16;
+
+inline bool
+TerrainLoader::IsTileWanted(unsigned index) const noexcept
+{
+  return raster_tile_cache.tiles.GetLinear(index).IsRequested() &&
+    (tile_workers == nullptr || tile_workers[index] == worker);
+}
+
 long
 TerrainLoader::SkipMarkerSegment(long file_offset) const
 {
@@ -57,7 +78,7 @@ TerrainLoader::SkipMarkerSegment(long file_offset) const
 
   long skip_to = segment->file_offset;
   while (segment->IsTileSegment() &&
-         !raster_tile_cache.tiles.GetLinear(segment->tile).IsRequested()) {
+         !IsTileWanted(segment->tile)) {
     ++segment;
     if (segment >= raster_tile_cache.segments.end())
       /* last segment is hidden; shouldn't happen either, because we
@@ -173,10 +194,14 @@ TerrainLoader::PutTileData(unsigned index,
                            RasterLocation start, RasterLocation end,
                            const struct jas_matrix &m)
 {
-  if (scan_overview)
+  if (scan_overview) {
     raster_tile_cache.PutOverviewTile(index, start, end, m);
 
-  if (scan_tiles) {
+    if (store_writer != nullptr)
+      store_writer->Put(index, end - start, m);
+  }
+
+  if (scan_tiles && IsTileWanted(index)) {
     const std::lock_guard<SharedMutex> lock(mutex);
     raster_tile_cache.PutTileData(index, m);
   }
@@ -227,7 +252,12 @@ LoadJPG2000(jas_stream_t *in, void *loader)
   /* allow really large maps, but specify a reasonable limit */
   opts.max_samples = size_t(1) << 31;
 
-  jpc_initluts();
+  /* initialise jasper's global lookup tables only once, because
+     several threads may be decoding at the same time; this can't be
+     a function-local static, because we build with
+     -fno-threadsafe-statics */
+  static std::once_flag luts_once;
+  std::call_once(luts_once, jpc_initluts);
 
   const auto dec = jpc_dec_create(&opts, in);
   if (dec == nullptr)
@@ -240,7 +270,7 @@ LoadJPG2000(jas_stream_t *in, void *loader)
   return success;
 }
 
-inline bool
+bool
 TerrainLoader::LoadJPG2000(struct zzip_dir *dir, const char *path)
 {
   const auto in = OpenJasperZzipStream(dir, path);
@@ -307,43 +337,169 @@ LoadTerrainOverview(struct zzip_dir *dir,
   return loader.LoadOverview(dir, path, world_file);
 }
 
+bool
+LoadTerrainOverview(struct zzip_dir *dir,
+                    RasterTileCache &raster_tile_cache,
+                    RasterTileStoreWriter &store_writer,
+                    OperationEnvironment &env)
+{
+  SharedMutex mutex;
+
+  TerrainLoader loader(mutex, raster_tile_cache, true, false, env);
+  loader.SetStoreWriter(&store_writer);
+  return loader.LoadOverview(dir, "terrain.jp2", "terrain.j2w");
+}
+
+/**
+ * A thread which decodes a subset of the requested tiles, see
+ * TerrainLoader::SetWorker().
+ */
+class TerrainDecodeThread final : public Thread {
+  TerrainLoader loader;
+
+  struct zzip_dir *const dir;
+  const char *const path;
+
+  bool success = false;
+
+public:
+  TerrainDecodeThread(SharedMutex &mutex, RasterTileCache &raster_tile_cache,
+                      OperationEnvironment &env,
+                      const uint8_t *tile_workers, uint8_t worker,
+                      struct zzip_dir *_dir, const char *_path) noexcept
+    :Thread("TerrainDecode"),
+     loader(mutex, raster_tile_cache, false, true, env),
+     dir(_dir), path(_path) {
+    loader.SetWorker(tile_workers, worker);
+  }
+
+  bool IsSuccess() const noexcept {
+    return success;
+  }
+
+protected:
+  /* virtual methods from class Thread */
+  void Run() noexcept override {
+    SetIdlePriority();
+    success = loader.LoadJPG2000(dir, path);
+  }
+};
+
+/**
+ * Decode the requested tiles with several threads.
+ */
+static bool
+LoadTilesParallel(ConstBuffer<struct zzip_dir *> dirs, const char *path,
+                  RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                  OperationEnvironment &env, std::size_t n_tiles,
+                  const std::vector<unsigned> &requested)
+{
+  const unsigned n_workers = std::min<std::size_t>({
+      dirs.size, requested.size(), MAX_WORKERS,
+    });
+
+  /* distribute the tiles round-robin, so each worker gets a similar
+     share */
+  std::vector<uint8_t> tile_workers(n_tiles, uint8_t(-1));
+  for (std::size_t i = 0; i < requested.size(); ++i)
+    tile_workers[requested[i]] = i % n_workers;
+
+  std::list<TerrainDecodeThread> threads;
+  for (unsigned i = 1; i < n_workers; ++i) {
+    auto &thread = threads.emplace_back(mutex, raster_tile_cache, env,
+                                        tile_workers.data(), i,
+                                        dirs[i], path);
+    if (!thread.Start()) {
+      /* no more threads; the remaining tiles will be retried in the
+         next iteration */
+      threads.pop_back();
+      break;
+    }
+  }
+
+  /* the calling thread is worker #0 */
+  TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
+  loader.SetWorker(tile_workers.data(), 0);
+  bool success = loader.LoadJPG2000(dirs[0], path);
+
+  for (auto &thread : threads) {
+    thread.Join();
+    success = success && thread.IsSuccess();
+  }
+
+  return success;
+}
+
 inline bool
-TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
+TerrainLoader::UpdateTiles(ConstBuffer<struct zzip_dir *> dirs,
+                           const char *path,
+                           RasterTileCache &raster_tile_cache,
+                           SharedMutex &mutex,
                            int x, int y, unsigned radius)
 {
-  assert(!scan_overview);
+  assert(!dirs.empty());
+
+  if (!raster_tile_cache.IsValid())
+    return false;
+
+  bool remaining;
+  {
+    /* PollTiles() may discard tiles, which must not happen while
+       another thread reads them */
+    const std::lock_guard<SharedMutex> lock(mutex);
+    if (!raster_tile_cache.PollTiles(x, y, radius))
+      /* nothing to do */
+      return true;
+
+    remaining = raster_tile_cache.MapStoredTiles();
+  }
 
-  if (!raster_tile_cache.PollTiles(x, y, radius))
-    /* nothing to do */
+  if (!remaining) {
+    /* all requested tiles were available in the tile store */
+    raster_tile_cache.FinishTileUpdate();
     return true;
+  }
+
+  NullOperationEnvironment env;
+
+  std::vector<unsigned> requested;
+  if (dirs.size > 1)
+    for (const unsigned i : raster_tile_cache.request_tiles)
+      if (raster_tile_cache.tiles.GetLinear(i).IsRequested())
+        requested.push_back(i);
+
+  bool success;
+  if (requested.size() > 1) {
+    success = LoadTilesParallel(dirs, path, raster_tile_cache, mutex,
+                                env, raster_tile_cache.tiles.GetSize(),
+                                requested);
+  } else {
+    TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
+    success = loader.LoadJPG2000(dirs[0], path);
+  }
 
-  bool success = LoadJPG2000(dir, path);
   raster_tile_cache.FinishTileUpdate();
   return success;
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ConstBuffer<struct zzip_dir *> dirs, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    int x, int y, unsigned radius)
 {
-  if (!raster_tile_cache.IsValid())
-    return false;
-
-  NullOperationEnvironment env;
-  TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
-  return loader.UpdateTiles(dir, path, x, y, radius);
+  return TerrainLoader::UpdateTiles(dirs, path, raster_tile_cache, mutex,
+                                    x, y, radius);
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ConstBuffer<struct zzip_dir *> dirs, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius)
 {
   const auto raster_location = projection.ProjectCoarse(location);
 
-  return UpdateTerrainTiles(dir, path, raster_tile_cache, mutex,
+  return UpdateTerrainTiles(dirs, path, raster_tile_cache, mutex,
                             raster_location.x, raster_location.y,
                             projection.DistancePixelsCoarse(radius));
 }
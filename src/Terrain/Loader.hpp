@@ -25,6 +25,7 @@ Copyright_License {
 #define XCSOAR_TERRAIN_LOADER_HPP
 
 #include "thread/SharedMutex.hpp"
+#include "util/ConstBuffer.hxx"
 
 #include <cstdint>
 
@@ -32,6 +33,7 @@ struct zzip_dir;
 struct GeoPoint;
 struct RasterLocation;
 class RasterTileCache;
+class RasterTileStoreWriter;
 class RasterProjection;
 class OperationEnvironment;
 
@@ -49,6 +51,21 @@ class TerrainLoader {
    */
   mutable unsigned remaining_segments = 0;
 
+  /**
+   * If not nullptr, then this loader is one of several which decode
+   * the requested tiles in parallel.  The array maps each tile index
+   * to the worker which is responsible for it, and this loader
+   * decodes only those assigned to #worker.
+   */
+  const uint8_t *tile_workers = nullptr;
+  uint8_t worker = 0;
+
+  /**
+   * If not nullptr, then all tiles decoded while scanning the
+   * overview are copied to this object.
+   */
+  RasterTileStoreWriter *store_writer = nullptr;
+
 public:
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
@@ -58,10 +75,28 @@ public:
      scan_tiles(!_scan_overview || _scan_all),
      env(_env) {}
 
+  /**
+   * Decode only the tiles which are assigned to the given worker.
+   */
+  void SetWorker(const uint8_t *_tile_workers, uint8_t _worker) noexcept {
+    tile_workers = _tile_workers;
+    worker = _worker;
+  }
+
+  void SetStoreWriter(RasterTileStoreWriter *_store_writer) noexcept {
+    store_writer = _store_writer;
+  }
+
   bool LoadOverview(struct zzip_dir *dir,
                     const char *path, const char *world_file);
-  bool UpdateTiles(struct zzip_dir *dir, const char *path,
-                   int x, int y, unsigned radius);
+
+  bool LoadJPG2000(struct zzip_dir *dir, const char *path);
+
+  static bool UpdateTiles(ConstBuffer<struct zzip_dir *> dirs,
+                          const char *path,
+                          RasterTileCache &raster_tile_cache,
+                          SharedMutex &mutex,
+                          int x, int y, unsigned radius);
 
   /* callback methods for libjasper (via jas_rtc.cpp) */
 
@@ -81,7 +116,9 @@ public:
                    const struct jas_matrix &m);
 
 private:
-  bool LoadJPG2000(struct zzip_dir *dir, const char *path);
+  [[gnu::pure]]
+  bool IsTileWanted(unsigned index) const noexcept;
+
   void ParseBounds(const char *data);
 };
 
@@ -97,6 +134,16 @@ LoadTerrainOverview(struct zzip_dir *dir,
                     bool all,
                     OperationEnvironment &env);
 
+/**
+ * Load the overview and copy all decoded tiles to the given
+ * #RasterTileStoreWriter.
+ */
+bool
+LoadTerrainOverview(struct zzip_dir *dir,
+                    RasterTileCache &raster_tile_cache,
+                    RasterTileStoreWriter &store_writer,
+                    OperationEnvironment &env);
+
 static inline bool
 LoadTerrainOverview(struct zzip_dir *dir,
                     RasterTileCache &tile_cache,
@@ -106,11 +153,26 @@ LoadTerrainOverview(struct zzip_dir *dir,
                              tile_cache, false, env);
 }
 
+/**
+ * Load the tiles near the given location.  The tiles are decoded in
+ * parallel, one thread for each handle in #dirs (the first one is
+ * used by the calling thread).  All of them must refer to the same
+ * file; a handle must not be used by two threads at a time.
+ */
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ConstBuffer<struct zzip_dir *> dirs, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    int x, int y, unsigned radius);
 
+static inline bool
+UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+                   RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                   int x, int y, unsigned radius)
+{
+  return UpdateTerrainTiles(ConstBuffer<struct zzip_dir *>(&dir, 1), path,
+                            raster_tile_cache, mutex, x, y, radius);
+}
+
 static inline bool
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
@@ -121,18 +183,29 @@ UpdateTerrainTiles(struct zzip_dir *dir,
 }
 
 bool
-UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+UpdateTerrainTiles(ConstBuffer<struct zzip_dir *> dirs, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius);
 
+static inline bool
+UpdateTerrainTiles(ConstBuffer<struct zzip_dir *> dirs,
+                   RasterTileCache &tile_cache, SharedMutex &mutex,
+                   const RasterProjection &projection,
+                   const GeoPoint &location, double radius)
+{
+  return UpdateTerrainTiles(dirs, "terrain.jp2", tile_cache, mutex,
+                            projection, location, radius);
+}
+
 static inline bool
 UpdateTerrainTiles(struct zzip_dir *dir,
                    RasterTileCache &tile_cache, SharedMutex &mutex,
                    const RasterProjection &projection,
                    const GeoPoint &location, double radius)
 {
-  return UpdateTerrainTiles(dir, "terrain.jp2", tile_cache, mutex,
+  return UpdateTerrainTiles(ConstBuffer<struct zzip_dir *>(&dir, 1),
+                            tile_cache, mutex,
                             projection, location, radius);
 }
 
@@ -34,7 +34,22 @@ RasterBuffer::Resize(RasterLocation _size) noexcept
   assert(_size.x > 0);
   assert(_size.y > 0);
 
-  data.GrowDiscard(_size.x, _size.y);
+  storage.GrowDiscard(_size.Area());
+  data = storage.begin();
+  size = _size;
+}
+
+void
+RasterBuffer::SetMapped(const TerrainHeight *_data,
+                        RasterLocation _size) noexcept
+{
+  assert(_data != nullptr);
+  assert(_size.x > 0);
+  assert(_size.y > 0);
+
+  storage.ResizeDiscard(0);
+  data = _data;
+  size = _size;
 }
 
 TerrainHeight
@@ -236,7 +251,7 @@ RasterBuffer::ScanLine(RasterLocation a, RasterLocation b,
       const RasterLocation c(a.x + (i * d.x) / (int)size,
                              a.y + (i * d.y) / (int)size);
 
-      *buffer++ = Get(c);
+      *buffer++ = Get(c >> RasterTraits::SUBPIXEL_BITS);
     }
   }
 }
@@ -265,7 +280,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const noexcept
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(data, data + size.Area(),
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
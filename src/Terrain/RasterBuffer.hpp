@@ -27,52 +27,91 @@ Copyright_License {
 #include "RasterTraits.hpp"
 #include "RasterLocation.hpp"
 #include "Height.hpp"
-#include "util/AllocatedGrid.hxx"
+#include "util/AllocatedArray.hxx"
 #include "util/Compiler.h"
 
+#include <cassert>
 #include <cstdint>
 
 class RasterBuffer {
-  AllocatedGrid<TerrainHeight> data;
+  AllocatedArray<TerrainHeight> storage;
+
+  /**
+   * Points to the first pixel.  This is either #storage or read-only
+   * memory owned by somebody else, see SetMapped().
+   */
+  const TerrainHeight *data = nullptr;
+
+  RasterLocation size{0, 0};
 
 public:
   RasterBuffer() noexcept = default;
-  RasterBuffer(unsigned _width, unsigned _height) noexcept
-    :data(_width, _height) {}
+  RasterBuffer(unsigned _width, unsigned _height) noexcept {
+    Resize({_width, _height});
+  }
 
   RasterBuffer(const RasterBuffer &) = delete;
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const noexcept {
-    return data.IsDefined();
+    return data != nullptr;
+  }
+
+  /**
+   * Does this buffer refer to memory owned by somebody else?
+   */
+  bool IsMapped() const noexcept {
+    return data != nullptr && data != storage.begin();
   }
 
   RasterLocation GetSize() const noexcept {
-    return {data.GetWidth(), data.GetHeight()};
+    return size;
   }
 
   RasterLocation GetFineSize() const noexcept {
     return GetSize() << RasterTraits::SUBPIXEL_BITS;
   }
 
+  /**
+   * Returns a writable pointer to the first pixel.  Must not be
+   * called on a mapped buffer.
+   */
   TerrainHeight *GetData() noexcept {
-    return data.begin();
+    assert(!IsMapped());
+
+    return storage.begin();
   }
 
   const TerrainHeight *GetData() const noexcept {
-    return data.begin();
+    return data;
   }
 
   const TerrainHeight *GetDataAt(RasterLocation p) const noexcept {
-    return data.GetPointerAt(p.x, p.y);
+    assert(p.x < size.x);
+    assert(p.y < size.y);
+
+    return data + p.y * size.x + p.x;
   }
 
   void Reset() noexcept {
-    data.Reset();
+    storage.ResizeDiscard(0);
+    data = nullptr;
+    size = {0, 0};
   }
 
+  /**
+   * Allocate (uninitialized) memory for the given size.  This
+   * discards a mapping.
+   */
   void Resize(RasterLocation _size) noexcept;
 
+  /**
+   * Refer to existing read-only memory instead of allocating.  The
+   * caller is responsible for keeping it alive until this buffer is
+   * reset or resized.
+   */
+  void SetMapped(const TerrainHeight *_data, RasterLocation _size) noexcept;
+
   gcc_pure
   TerrainHeight GetInterpolated(unsigned lx, unsigned ly,
                                 unsigned ix, unsigned iy) const noexcept;
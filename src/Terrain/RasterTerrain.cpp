@@ -23,6 +23,7 @@ Copyright_License {
 
 #include "RasterTerrain.hpp"
 #include "Loader.hpp"
+#include "TileStore.hpp"
 #include "Profile/Profile.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/FileCache.hpp"
@@ -35,7 +36,52 @@ Copyright_License {
 #include "util/ConvertString.hpp"
 #include "LogFile.hpp"
 
+#include <algorithm>
+#include <thread>
+
 static const TCHAR *const terrain_cache_name = _T("terrain");
+static const TCHAR *const terrain_tiles_cache_name = _T("terrain_tiles");
+
+/**
+ * Is the #RasterTileStore enabled by default?  It may grow up to
+ * RasterTileStore::MAX_FILE_SIZE, which is too much for the small
+ * flash storage of most Android and Kobo devices.
+ */
+#if defined(ANDROID) || defined(KOBO)
+static constexpr bool DEFAULT_TILE_STORE = false;
+#else
+static constexpr bool DEFAULT_TILE_STORE = true;
+#endif
+
+/**
+ * Shall the #RasterTileStore be used?  This checks the profile
+ * setting; on disabled stores, the old file is deleted to reclaim
+ * its space.
+ */
+static bool
+IsTileStoreEnabled(FileCache &cache) noexcept
+{
+  bool enabled = DEFAULT_TILE_STORE;
+  Profile::Get(ProfileKeys::TerrainTileStore, enabled);
+  if (!enabled)
+    cache.Flush(terrain_tiles_cache_name);
+
+  return enabled;
+}
+
+/**
+ * Is there enough free space for a new #RasterTileStore?  It may grow
+ * up to RasterTileStore::MAX_FILE_SIZE; don't fill up the volume.
+ */
+static bool
+HasSpaceForTileStore(const FileCache &cache) noexcept
+{
+  if (cache.GetFreeSpace() >= RasterTileStore::MAX_FILE_SIZE)
+    return true;
+
+  LogFormat("Not enough space for the terrain tile store");
+  return false;
+}
 
 inline bool
 RasterTerrain::LoadCache(FileCache &cache, Path path)
@@ -59,18 +105,93 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
   os->Commit();
 }
 
+inline bool
+RasterTerrain::LoadTileStore(FileCache &cache, Path path) noexcept
+try {
+  const auto store_path = cache.LoadPath(terrain_tiles_cache_name, path);
+  if (store_path == nullptr)
+    return false;
+
+  if (!map.GetTileCache().SetTileStore(std::make_unique<RasterTileStore>(store_path))) {
+    LogFormat("Terrain tile store does not match");
+    return false;
+  }
+
+  return true;
+} catch (...) {
+  LogError(std::current_exception(), "Failed to load terrain tile store");
+  return false;
+}
+
+/**
+ * Load the overview and write all decoded tiles to a new
+ * #RasterTileStore file, which will be used by LoadTileStore() from
+ * now on.
+ */
+inline bool
+RasterTerrain::LoadOverviewAndTileStore(FileCache &cache, Path path,
+                                        OperationEnvironment &operation)
+{
+  /* delete the old store first, its space may be needed for the new
+     one */
+  cache.Flush(terrain_tiles_cache_name);
+
+  if (!HasSpaceForTileStore(cache))
+    return LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+
+  std::unique_ptr<FileOutputStream> os;
+  try {
+    os = cache.Save(terrain_tiles_cache_name, path);
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save terrain tile store");
+    return LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+  }
+
+  RasterTileStoreWriter writer(*os, os->Tell());
+  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), writer,
+                           operation))
+    return false;
+
+  try {
+    writer.Finish(map.GetTileCache().GetTileCount());
+    os->Commit();
+  } catch (...) {
+    LogError(std::current_exception(), "Failed to save terrain tile store");
+    return true;
+  }
+
+  LoadTileStore(cache, path);
+  return true;
+}
+
 inline bool
 RasterTerrain::Load(Path path, FileCache *cache,
                     OperationEnvironment &operation)
 {
+  const bool tile_store = cache != nullptr && IsTileStoreEnabled(*cache);
+
   try {
-    if (LoadCache(cache, path))
-      return true;
+    if (LoadCache(cache, path)) {
+      if (!tile_store || LoadTileStore(*cache, path))
+        return true;
+
+      /* the tile store is missing (it was just enabled, or it was
+         evicted) or does not match; it can only be written while
+         scanning the overview, so reload the overview unless there
+         is no space for a new store anyway */
+      cache->Flush(terrain_tiles_cache_name);
+      if (!HasSpaceForTileStore(*cache))
+        return true;
+
+      LogFormat("Rebuilding the terrain tile store");
+    }
   } catch (...) {
     LogError(std::current_exception(), "Failed to load terrain cache");
   }
 
-  if (!LoadTerrainOverview(archive.get(), map.GetTileCache(), operation))
+  if (tile_store
+      ? !LoadOverviewAndTileStore(*cache, path, operation)
+      : !LoadTerrainOverview(archive.get(), map.GetTileCache(), operation))
     return false;
 
   map.UpdateProjection();
@@ -86,6 +207,31 @@ RasterTerrain::Load(Path path, FileCache *cache,
   return true;
 }
 
+void
+RasterTerrain::OpenDecoders(Path path) noexcept
+{
+  /* the calling thread decodes, too; leave one core for the rest of
+     the application */
+  constexpr unsigned MAX_DECODERS = 8;
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  const unsigned n_decoders = n_cpus > 2
+    ? std::min(n_cpus - 1, MAX_DECODERS)
+    : 1;
+
+  decoder_dirs.push_back(archive.get());
+
+  for (unsigned i = 1; i < n_decoders; ++i) {
+    try {
+      decoder_archives.emplace_back(path);
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to open terrain");
+      break;
+    }
+
+    decoder_dirs.push_back(decoder_archives.back().get());
+  }
+}
+
 RasterTerrain *
 RasterTerrain::OpenTerrain(FileCache *cache, OperationEnvironment &operation)
 try {
@@ -99,6 +245,13 @@ try {
     return nullptr;
   }
 
+  /* optional memory limit for loaded terrain tiles [MB] */
+  unsigned tile_memory;
+  if (Profile::Get(ProfileKeys::TerrainTileMemory, tile_memory) &&
+      tile_memory > 0)
+    rt->map.GetTileCache().SetMemoryBudget(std::size_t(tile_memory) << 20);
+
+  rt->OpenDecoders(path);
   return rt;
 } catch (const std::runtime_error &e) {
   operation.SetErrorMessage(UTF8ToWideConverter(e.what()));
@@ -112,7 +265,9 @@ RasterTerrain::UpdateTiles(const GeoPoint &location, double radius)
   if (!tile_cache.IsValid())
     return false;
 
-  UpdateTerrainTiles(archive.get(), tile_cache, mutex,
+  UpdateTerrainTiles(ConstBuffer<struct zzip_dir *>(decoder_dirs.data(),
+                                                    decoder_dirs.size()),
+                     tile_cache, mutex,
                      map.GetProjection(), location, radius);
   return map.IsDirty();
 }
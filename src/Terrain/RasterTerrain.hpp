@@ -31,6 +31,8 @@ Copyright_License {
 #include "io/ZipArchive.hpp"
 #include "util/Compiler.h"
 
+#include <vector>
+
 class FileCache;
 class OperationEnvironment;
 
@@ -47,6 +49,19 @@ public:
 private:
   ZipArchive archive;
 
+  /**
+   * Additional handles to the same file, one for each tile decoder
+   * thread; libzzip does not allow using one handle from multiple
+   * threads.
+   */
+  std::vector<ZipArchive> decoder_archives;
+
+  /**
+   * The #zzip_dir pointers of #archive and #decoder_archives, to be
+   * passed to UpdateTerrainTiles().
+   */
+  std::vector<struct zzip_dir *> decoder_dirs;
+
   RasterMap map;
 
 private:
@@ -100,8 +115,22 @@ private:
    */
   void SaveCache(FileCache &cache, Path path) const;
 
+  /**
+   * @return true if the #RasterTileStore has been attached to the
+   * tile cache
+   */
+  bool LoadTileStore(FileCache &cache, Path path) noexcept;
+
+  bool LoadOverviewAndTileStore(FileCache &cache, Path path,
+                                OperationEnvironment &operation);
+
   bool Load(Path path, FileCache *cache,
             OperationEnvironment &operation);
+
+  /**
+   * Open the additional handles for parallel tile decoding.
+   */
+  void OpenDecoders(Path path) noexcept;
 };
 
 #endif
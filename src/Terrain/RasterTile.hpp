@@ -28,6 +28,9 @@ Copyright_License {
 #include "RasterLocation.hpp"
 #include "RasterBuffer.hpp"
 
+#include <atomic>
+#include <cstddef>
+
 struct jas_matrix;
 class BufferedOutputStream;
 class BufferedReader;
@@ -48,6 +51,14 @@ public:
 
   bool request;
 
+  /**
+   * The RasterTileCache generation in which this tile was last
+   * accessed.  This is used to evict the least recently used tiles.
+   * It is updated by readers holding only a shared lock, therefore
+   * it is atomic.
+   */
+  mutable std::atomic<unsigned> last_used{0};
+
   RasterBuffer buffer;
 
 public:
@@ -86,6 +97,24 @@ public:
     request = true;
   }
 
+  unsigned GetLastUsed() const noexcept {
+    return last_used.load(std::memory_order_relaxed);
+  }
+
+  void MarkUsed(unsigned generation) const noexcept {
+    /* avoid writing to the shared cache line if the value is
+       already up to date */
+    if (GetLastUsed() != generation)
+      last_used.store(generation, std::memory_order_relaxed);
+  }
+
+  /**
+   * The number of bytes needed by this tile's heights when loaded.
+   */
+  std::size_t GetMemorySize() const noexcept {
+    return std::size_t(size.Area()) * sizeof(TerrainHeight);
+  }
+
   void ClearRequest() noexcept {
     request = false;
   }
@@ -112,6 +141,17 @@ public:
 
   void CopyFrom(const struct jas_matrix &m) noexcept;
 
+  /**
+   * Use already decoded heights (from a #RasterTileStore) instead of
+   * decoding the tile.  The memory must remain valid until this
+   * tile is disabled.
+   */
+  void MapFrom(const TerrainHeight *data) noexcept {
+    assert(IsDefined());
+
+    buffer.SetMapped(data, size);
+  }
+
   /**
    * Determine the non-interpolated height at the specified pixel
    * location.
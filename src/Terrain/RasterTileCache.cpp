@@ -22,6 +22,7 @@ Copyright_License {
 */
 
 #include "RasterTileCache.hpp"
+#include "TileStore.hpp"
 #include "Math/Angle.hpp"
 #include "Math/FastMath.hpp"
 #include "io/BufferedOutputStream.hxx"
@@ -94,7 +95,7 @@ struct RTDistanceSort {
   constexpr RTDistanceSort(RasterTileCache &_rtc) noexcept:rtc(_rtc) {}
 
   [[gnu::pure]]
-  bool operator()(unsigned short ai, unsigned short bi) const noexcept {
+  bool operator()(unsigned ai, unsigned bi) const noexcept {
     const RasterTile &a = rtc.tiles.GetLinear(ai);
     const RasterTile &b = rtc.tiles.GetLinear(bi);
 
@@ -102,6 +103,31 @@ struct RTDistanceSort {
   }
 };
 
+/**
+ * Sort the tiles by eviction priority: least recently used first,
+ * and among those, the most distant ones first.
+ */
+struct RTEvictionSort {
+  const RasterTileCache &rtc;
+
+  constexpr RTEvictionSort(RasterTileCache &_rtc) noexcept:rtc(_rtc) {}
+
+  [[gnu::pure]]
+  bool operator()(unsigned ai, unsigned bi) const noexcept {
+    const RasterTile &a = rtc.tiles.GetLinear(ai);
+    const RasterTile &b = rtc.tiles.GetLinear(bi);
+
+    /* compare the age instead of the generation number, to be safe
+       against wraparound */
+    const unsigned age_a = rtc.generation - a.GetLastUsed();
+    const unsigned age_b = rtc.generation - b.GetLastUsed();
+    if (age_a != age_b)
+      return age_a > age_b;
+
+    return a.GetDistance() > b.GetDistance();
+  }
+};
+
 bool
 RasterTileCache::PollTiles(int x, int y, unsigned radius) noexcept
 {
@@ -111,56 +137,76 @@ RasterTileCache::PollTiles(int x, int y, unsigned radius) noexcept
      the screen will be loaded in advance */
   radius += 256;
 
-  /**
-   * Maximum number of tiles loaded at a time, to reduce system load
-   * peaks.
-   */
-  constexpr unsigned MAX_ACTIVATE = MAX_ACTIVE_TILES > 32
-    ? 16
-    : MAX_ACTIVE_TILES / 2;
+  ++generation;
 
   /* query all tiles; all tiles which are either in range or already
-     loaded are added to RequestTiles */
+     loaded are added to request_tiles; loaded tiles which are out
+     of range are eviction candidates */
 
+  std::size_t used = 0;
   request_tiles.clear();
-  for (int i = tiles.GetSize() - 1; i >= 0 && !request_tiles.full(); --i)
-    if (tiles.GetLinear(i).VisibilityChanged({x, y}, radius))
-      request_tiles.append(i);
+  evict_tiles.clear();
+  for (unsigned i = 0, n = tiles.GetSize(); i < n; ++i) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (!tile.VisibilityChanged({x, y}, radius))
+      continue;
 
-  /* reduce if there are too many */
+    request_tiles.push_back(i);
 
-  if (request_tiles.size() > MAX_ACTIVE_TILES) {
-    /* sort by distance */
-    const RTDistanceSort sort(*this);
-    std::sort(request_tiles.begin(), request_tiles.end(), sort);
+    if (tile.IsEnabled()) {
+      used += tile.GetMemorySize();
 
-    /* dispose all tiles which are out of range */
-    for (unsigned i = MAX_ACTIVE_TILES; i < request_tiles.size(); ++i) {
-      RasterTile &tile = tiles.GetLinear(request_tiles[i]);
-      tile.Disable();
+      if (unsigned(tile.GetDistance()) > radius)
+        evict_tiles.push_back(i);
     }
-
-    request_tiles.shrink(MAX_ACTIVE_TILES);
   }
 
-  /* fill ActiveTiles and request new tiles */
+  /* load the nearest tiles first */
+  std::sort(request_tiles.begin(), request_tiles.end(),
+            RTDistanceSort(*this));
+
+  std::sort(evict_tiles.begin(), evict_tiles.end(), RTEvictionSort(*this));
+  auto evict = evict_tiles.begin();
+
+  /* request new tiles, evicting old ones to stay within the budget */
 
   dirty = false;
 
   unsigned num_activate = 0;
-  for (unsigned i = 0; i < request_tiles.size(); ++i) {
-    RasterTile &tile = tiles.GetLinear(request_tiles[i]);
+  for (const unsigned i : request_tiles) {
+    RasterTile &tile = tiles.GetLinear(i);
     if (tile.IsEnabled())
       continue;
 
-    if (++num_activate <= MAX_ACTIVATE)
-      /* request the tile in the current iteration */
-      tile.SetRequest();
-    else
+    if (num_activate >= MAX_ACTIVATE) {
       /* this tile will be loaded in the next iteration */
       dirty = true;
+      break;
+    }
+
+    const std::size_t needed = tile.GetMemorySize();
+    while (used + needed > memory_budget && evict != evict_tiles.end()) {
+      RasterTile &victim = tiles.GetLinear(*evict++);
+      used -= victim.GetMemorySize();
+      victim.Disable();
+    }
+
+    if (used + needed > memory_budget)
+      /* the budget is exhausted by tiles in range; the remaining
+         ones are rendered from the overview */
+      break;
+
+    /* request the tile in the current iteration */
+    tile.SetRequest();
+    tile.MarkUsed(generation);
+    used += needed;
+    ++num_activate;
   }
 
+  if (evict != evict_tiles.begin())
+    /* evicted tiles are now rendered from the overview */
+    ++serial;
+
   return num_activate > 0;
 }
 
@@ -172,8 +218,10 @@ RasterTileCache::GetHeight(RasterLocation p) const noexcept
     return TerrainHeight::Invalid();
 
   const RasterTile &tile = tiles.Get(p.x / tile_size.x, p.y / tile_size.y);
-  if (tile.IsEnabled())
+  if (tile.IsEnabled()) {
+    tile.MarkUsed(generation);
     return tile.GetHeight(p);
+  }
 
   // still not found, so go to overview
   return overview.GetInterpolated(p << (RasterTraits::SUBPIXEL_BITS - RasterTraits::OVERVIEW_BITS));
@@ -191,8 +239,10 @@ RasterTileCache::GetInterpolatedHeight(RasterLocation l) const noexcept
   const unsigned int iy = CombinedDivAndMod(py);
 
   const RasterTile &tile = tiles.Get(px / tile_size.x, py / tile_size.y);
-  if (tile.IsEnabled())
+  if (tile.IsEnabled()) {
+    tile.MarkUsed(generation);
     return tile.GetInterpolatedHeight(px, py, ix, iy);
+  }
 
   // still not found, so go to overview
   return overview.GetInterpolated({RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)});
@@ -229,6 +279,13 @@ RasterTileCache::SetLatLonBounds(double _lon_min, double _lon_max,
                               std::min(lat_min, lat_max)));
 }
 
+RasterTileCache::RasterTileCache() noexcept
+{
+  Reset();
+}
+
+RasterTileCache::~RasterTileCache() noexcept = default;
+
 void
 RasterTileCache::Reset() noexcept
 {
@@ -240,6 +297,45 @@ RasterTileCache::Reset() noexcept
 
   for (auto it = tiles.begin(), end = tiles.end(); it != end; ++it)
     it->Disable();
+
+  /* no tile refers to the store anymore */
+  tile_store.reset();
+}
+
+bool
+RasterTileCache::SetTileStore(std::unique_ptr<RasterTileStore> &&store) noexcept
+{
+  assert(store != nullptr);
+
+  if (!IsValid() || store->GetTileCount() != tiles.GetSize())
+    return false;
+
+  tile_store = std::move(store);
+  return true;
+}
+
+bool
+RasterTileCache::MapStoredTiles() noexcept
+{
+  if (tile_store == nullptr)
+    return true;
+
+  bool remaining = false;
+
+  for (const unsigned i : request_tiles) {
+    RasterTile &tile = tiles.GetLinear(i);
+    if (!tile.IsRequested())
+      continue;
+
+    const TerrainHeight *data = tile_store->Get(i, tile.size);
+    if (data != nullptr) {
+      tile.MapFrom(data);
+      tile.ClearRequest();
+    } else
+      remaining = true;
+  }
+
+  return remaining;
 }
 
 const RasterTileCache::MarkerSegmentInfo *
@@ -28,11 +28,15 @@ Copyright_License {
 #include "RasterTile.hpp"
 #include "RasterLocation.hpp"
 #include "Geo/GeoBounds.hpp"
+#include "util/AllocatedGrid.hxx"
 #include "util/StaticArray.hxx"
 #include "util/Serial.hpp"
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #define RASTER_SLOPE_FACT 12
 
@@ -40,21 +44,28 @@ struct jas_matrix;
 struct GridLocation;
 class BufferedOutputStream;
 class BufferedReader;
+class RasterTileStore;
 
 class RasterTileCache {
-  static constexpr unsigned MAX_RTC_TILES = 4096;
-
+public:
   /**
-   * The maximum number of tiles which are loaded at a time.  This
-   * must be limited because the amount of memory is finite.
+   * The default value for SetMemoryBudget(); enough for 128 (Android)
+   * or 512 (desktop) tiles of 256x256 pixels.
    */
 #if defined(ANDROID)
-  static constexpr unsigned MAX_ACTIVE_TILES = 128;
+  static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 16 * 1024 * 1024;
 #else
   // desktop: use a lot of memory
-  static constexpr unsigned MAX_ACTIVE_TILES = 512;
+  static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
 #endif
 
+private:
+  /**
+   * Maximum number of tiles loaded at a time, to reduce system load
+   * peaks.
+   */
+  static constexpr unsigned MAX_ACTIVATE = 16;
+
   /**
    * The width and height of the terrain bitmap is shifted by this
    * number of bits to determine the overview size.
@@ -71,6 +82,7 @@ class RasterTileCache {
 
 protected:
   friend struct RTDistanceSort;
+  friend struct RTEvictionSort;
   friend class TerrainLoader;
 
   struct MarkerSegmentInfo {
@@ -104,7 +116,7 @@ protected:
   };
 
   struct CacheHeader {
-    static constexpr unsigned VERSION = 0xb;
+    static constexpr unsigned VERSION = 0xc;
 
     unsigned version;
     UnsignedPoint2D size;
@@ -122,6 +134,17 @@ protected:
    */
   Serial serial;
 
+  /**
+   * Incremented by each PollTiles() call; readers stamp the tiles
+   * they access with it (RasterTile::MarkUsed()).
+   */
+  unsigned generation = 0;
+
+  /**
+   * The maximum number of bytes occupied by loaded tiles.
+   */
+  std::size_t memory_budget = DEFAULT_MEMORY_BUDGET;
+
   AllocatedGrid<RasterTile> tiles;
   Point2D<uint_least16_t> tile_size;
 
@@ -131,19 +154,30 @@ protected:
 
   GeoBounds bounds;
 
+  /**
+   * If not nullptr, then requested tiles are mapped from this store
+   * instead of being decoded.
+   */
+  std::unique_ptr<RasterTileStore> tile_store;
+
   StaticArray<MarkerSegmentInfo, 8192> segments;
 
   /**
-   * An array that is used to sort the requested tiles by distance.
-   * This is only used by PollTiles() internally, but is stored in the
-   * class because it would be too large for the stack.
+   * The tiles which are either in range or loaded, sorted by
+   * distance.  This is only used by PollTiles() and TerrainLoader,
+   * but is stored in the class to reuse the allocation.
    */
-  StaticArray<uint16_t, MAX_RTC_TILES> request_tiles;
+  std::vector<unsigned> request_tiles;
+
+  /**
+   * Loaded tiles which are out of range, sorted by eviction
+   * priority.  This is only used by PollTiles() internally.
+   */
+  std::vector<unsigned> evict_tiles;
 
 public:
-  RasterTileCache() noexcept {
-    Reset();
-  }
+  RasterTileCache() noexcept;
+  ~RasterTileCache() noexcept;
 
   RasterTileCache(const RasterTileCache &) = delete;
   RasterTileCache &operator=(const RasterTileCache &) = delete;
@@ -247,6 +281,29 @@ public:
 
   void Reset() noexcept;
 
+  /**
+   * Limit the amount of memory occupied by loaded tiles.  When the
+   * limit is reached, the least recently used tiles outside the
+   * requested radius are discarded.  Takes effect in the next
+   * PollTiles() call.
+   */
+  void SetMemoryBudget(std::size_t _budget) noexcept {
+    memory_budget = _budget;
+  }
+
+  /**
+   * Attach a #RasterTileStore which must have been created from the
+   * same map file.  Call this after LoadCache() or after the
+   * overview has been loaded.
+   *
+   * @return false if the store does not match (it is discarded then)
+   */
+  bool SetTileStore(std::unique_ptr<RasterTileStore> &&store) noexcept;
+
+  bool HasTileStore() const noexcept {
+    return tile_store != nullptr;
+  }
+
   const GeoBounds &GetBounds() const noexcept {
     assert(bounds.IsValid());
 
@@ -280,8 +337,21 @@ public:
                        RasterLocation start, RasterLocation end,
                        const struct jas_matrix &m) noexcept;
 
+  /**
+   * Determine which tiles shall be loaded and evict tiles to stay
+   * within the memory budget.  The caller must hold the mutex.
+   */
   bool PollTiles(int x, int y, unsigned radius) noexcept;
 
+  /**
+   * Activate the requested tiles which are available in the
+   * #tile_store.  The caller must hold the mutex.
+   *
+   * @return true if there are remaining tiles which need to be
+   * decoded
+   */
+  bool MapStoredTiles() noexcept;
+
   void PutTileData(unsigned index, const struct jas_matrix &m) noexcept;
 
   void FinishTileUpdate() noexcept;
@@ -302,6 +372,10 @@ public:
     return size;
   }
 
+  unsigned GetTileCount() const noexcept {
+    return tiles.GetSize();
+  }
+
   RasterLocation GetFineSize() const noexcept {
     return size << RasterTraits::SUBPIXEL_BITS;
   }
@@ -309,11 +309,12 @@ RasterTileCache::ScanTileLine(GridLocation start, GridLocation end,
   }
 
   const RasterTile &tile = tiles.Get(start.tile.x, start.tile.y);
-  if (tile.IsEnabled())
+  if (tile.IsEnabled()) {
+    tile.MarkUsed(generation);
     tile.ScanLine(start, end,
                   buffer + start.index, end.index - start.index,
                   interpolate);
-  else
+  } else
     /* need range checking in the overview buffer because its size may
        be rounded down, and then the "fine" location may exceed its
        bounds */
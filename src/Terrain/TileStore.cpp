@@ -0,0 +1,165 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "TileStore.hpp"
+#include "jasper/jas_seq.h"
+#include "io/OutputStream.hxx"
+#include "system/Path.hpp"
+
+#include <stdexcept>
+
+#include <string.h>
+
+RasterTileStore::RasterTileStore(Path path)
+  :mapping(path)
+{
+  const std::size_t size = mapping.size();
+  if (size < sizeof(Trailer))
+    throw std::runtime_error("Terrain tile store too small");
+
+  Trailer trailer;
+  memcpy(&trailer, mapping.at(size - sizeof(trailer)), sizeof(trailer));
+
+  if (trailer.magic != MAGIC || trailer.version != VERSION)
+    throw std::runtime_error("Wrong terrain tile store version");
+
+  const std::size_t table_end = size - sizeof(trailer);
+  if (trailer.table_offset % alignof(Entry) != 0 ||
+      trailer.table_offset > table_end ||
+      trailer.n_tiles > (table_end - trailer.table_offset) / sizeof(Entry))
+    throw std::runtime_error("Malformed terrain tile store");
+
+  table = (const Entry *)mapping.at(trailer.table_offset);
+  n_tiles = trailer.n_tiles;
+}
+
+const TerrainHeight *
+RasterTileStore::Get(unsigned index, RasterLocation size) const noexcept
+{
+  if (index >= n_tiles)
+    return nullptr;
+
+  const Entry &entry = table[index];
+  if (entry.offset == 0 || entry.width != size.x || entry.height != size.y)
+    return nullptr;
+
+  const uint64_t nbytes = uint64_t(size.Area()) * sizeof(TerrainHeight);
+  if (entry.offset % alignof(TerrainHeight) != 0 ||
+      entry.offset > mapping.size() ||
+      nbytes > mapping.size() - entry.offset)
+    return nullptr;
+
+  return (const TerrainHeight *)mapping.at(entry.offset);
+}
+
+inline void
+RasterTileStoreWriter::Write(const void *data, std::size_t size)
+{
+  os.Write(data, size);
+  position += size;
+}
+
+void
+RasterTileStoreWriter::Pad()
+{
+  static constexpr uint8_t zero[RasterTileStore::ALIGNMENT]{};
+
+  const unsigned remainder = position % RasterTileStore::ALIGNMENT;
+  if (remainder > 0)
+    Write(zero, RasterTileStore::ALIGNMENT - remainder);
+}
+
+inline void
+RasterTileStoreWriter::DoPut(unsigned index, RasterLocation size,
+                             const struct jas_matrix &m)
+{
+  if (m.numcols_ != (jas_matind_t)size.x ||
+      m.numrows_ != (jas_matind_t)size.y)
+    /* shouldn't happen; don't store this tile, it will be decoded
+       when needed */
+    return;
+
+  buffer.resize(size.Area());
+
+  auto *dest = buffer.data();
+  for (unsigned y = 0; y < size.y; ++y) {
+    const jas_seqent_t *src = m.rows_[y];
+
+    for (unsigned x = 0; x < size.x; ++x)
+      *dest++ = TerrainHeight(src[x]);
+  }
+
+  Pad();
+
+  const uint64_t nbytes = buffer.size() * sizeof(buffer.front());
+  if (position + nbytes > RasterTileStore::MAX_FILE_SIZE)
+    throw std::runtime_error("Terrain tile store too large");
+
+  if (index >= table.size())
+    table.resize(index + 1, RasterTileStore::Entry{});
+
+  table[index] = {
+    position,
+    uint16_t(size.x), uint16_t(size.y),
+    0,
+  };
+
+  Write(buffer.data(), nbytes);
+}
+
+void
+RasterTileStoreWriter::Put(unsigned index, RasterLocation size,
+                           const struct jas_matrix &m) noexcept
+{
+  if (error)
+    /* an earlier write has failed; ignore all further tiles */
+    return;
+
+  try {
+    DoPut(index, size, m);
+  } catch (...) {
+    error = std::current_exception();
+  }
+}
+
+void
+RasterTileStoreWriter::Finish(unsigned n_tiles)
+{
+  if (error)
+    std::rethrow_exception(error);
+
+  table.resize(n_tiles, RasterTileStore::Entry{});
+
+  Pad();
+
+  RasterTileStore::Trailer trailer;
+  memset(&trailer, 0, sizeof(trailer));
+  trailer.magic = RasterTileStore::MAGIC;
+  trailer.version = RasterTileStore::VERSION;
+  trailer.n_tiles = n_tiles;
+  trailer.table_offset = position;
+
+  Write(table.data(), table.size() * sizeof(table.front()));
+  Write(&trailer, sizeof(trailer));
+}
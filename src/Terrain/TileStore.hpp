@@ -0,0 +1,171 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_TERRAIN_TILE_STORE_HPP
+#define XCSOAR_TERRAIN_TILE_STORE_HPP
+
+#include "RasterLocation.hpp"
+#include "Height.hpp"
+#include "system/FileMapping.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+struct jas_matrix;
+class Path;
+class OutputStream;
+
+/**
+ * An on-disk copy of all decoded terrain tiles, so activating a tile
+ * does not need to run the JPEG2000 decoder.  The file is mapped
+ * into memory, and #RasterTile points directly into the mapping.
+ *
+ * File layout: the tiles (16 bit heights, row by row, each one
+ * starting at a page boundary), followed by a table with one
+ * #Entry per tile and a #Trailer.  All offsets are relative to the
+ * beginning of the file, which allows arbitrary data (e.g. the
+ * #FileCache header) in front of the first tile.
+ */
+class RasterTileStore {
+public:
+  static constexpr uint32_t MAGIC = 0x5445544c;
+  static constexpr uint32_t VERSION = 1;
+
+  /**
+   * Tiles are aligned to this number of bytes.
+   */
+  static constexpr unsigned ALIGNMENT = 4096;
+
+  /**
+   * Don't create files larger than this; FileMapping refuses to map
+   * them anyway.
+   */
+  static constexpr uint64_t MAX_FILE_SIZE = 1024 * 1024 * 1024;
+
+  struct Entry {
+    /**
+     * The offset of the tile within the file; 0 if the tile was not
+     * stored.
+     */
+    uint64_t offset;
+
+    uint16_t width, height;
+
+    uint32_t reserved;
+  };
+
+  struct Trailer {
+    uint32_t magic, version;
+
+    uint32_t n_tiles;
+
+    uint32_t reserved;
+
+    /**
+     * The offset of the #Entry table within the file.
+     */
+    uint64_t table_offset;
+  };
+
+private:
+  FileMapping mapping;
+
+  const Entry *table;
+  unsigned n_tiles;
+
+public:
+  /**
+   * Throws on error.
+   */
+  explicit RasterTileStore(Path path);
+
+  unsigned GetTileCount() const noexcept {
+    return n_tiles;
+  }
+
+  /**
+   * Look up a tile.
+   *
+   * @return a pointer to the heights or nullptr if the tile was not
+   * stored or its size does not match
+   */
+  [[gnu::pure]]
+  const TerrainHeight *Get(unsigned index,
+                           RasterLocation size) const noexcept;
+};
+
+/**
+ * Write a #RasterTileStore file while the JPEG2000 file is being
+ * decoded.
+ */
+class RasterTileStoreWriter {
+  OutputStream &os;
+
+  /**
+   * The current position within the file.
+   */
+  uint64_t position;
+
+  std::vector<RasterTileStore::Entry> table;
+
+  std::vector<TerrainHeight> buffer;
+
+  /**
+   * The first error which occurred in Put(); it will be rethrown by
+   * Finish().
+   */
+  std::exception_ptr error;
+
+public:
+  /**
+   * @param os the file which receives the data
+   * @param _position the current position within the file, i.e. the
+   * size of the data which has already been written
+   */
+  RasterTileStoreWriter(OutputStream &_os, uint64_t _position) noexcept
+    :os(_os), position(_position) {}
+
+  /**
+   * Add a decoded tile.  Errors are postponed until Finish(), because
+   * this is called from inside libjasper.
+   */
+  void Put(unsigned index, RasterLocation size,
+           const struct jas_matrix &m) noexcept;
+
+  /**
+   * Write the tile table.  Throws on error.
+   *
+   * @param n_tiles the total number of tiles
+   */
+  void Finish(unsigned n_tiles);
+
+private:
+  void Write(const void *data, std::size_t size);
+  void Pad();
+  void DoPut(unsigned index, RasterLocation size,
+             const struct jas_matrix &m);
+};
+
+#endif
@@ -30,13 +30,18 @@ Copyright_License {
 #include "net/UniqueSocketDescriptor.hxx"
 #include "util/CRC.hpp"
 
+#include <string.h>
+
 static UniqueSocketDescriptor
-CreateBindUDP(SocketAddress address)
+CreateBindUDP(SocketAddress address, bool reuse_port)
 {
   UniqueSocketDescriptor s;
   if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
     throw MakeSocketError("Failed to create socket");
 
+  if (reuse_port && !s.SetReusePort())
+    throw MakeSocketError("Failed to set SO_REUSEPORT");
+
   if (!s.Bind(address))
     throw MakeSocketError("Failed to connect socket");
 
@@ -46,10 +51,27 @@ CreateBindUDP(SocketAddress address)
 namespace SkyLinesTracking {
 
 Server::Server(EventLoop &event_loop,
-               SocketAddress server_address)
+               SocketAddress server_address,
+               bool reuse_port)
   :socket(event_loop, BIND_THIS_METHOD(OnSocketReady),
-          CreateBindUDP(server_address).Release())
+          CreateBindUDP(server_address, reuse_port).Release())
+#ifdef __linux__
+  , receive_batch(std::make_unique<ReceiveBatch>()),
+   send_queue(std::make_unique<SendQueue>())
+#endif
 {
+#ifdef __linux__
+  auto &r = *receive_batch;
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    r.iov[i].iov_base = r.buffers[i].data();
+    r.iov[i].iov_len = r.buffers[i].size();
+  }
+
+  auto &q = *send_queue;
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i)
+    q.iov[i].iov_base = q.buffers[i].data();
+#endif
+
   socket.ScheduleRead();
 }
 
@@ -58,11 +80,51 @@ Server::~Server()
   socket.Close();
 }
 
+Server::Statistics
+Server::GetStatistics() const noexcept
+{
+  Statistics s;
+  s.received_packets = counters.received_packets.load(std::memory_order_relaxed);
+  s.receive_calls = counters.receive_calls.load(std::memory_order_relaxed);
+  s.sent_packets = counters.sent_packets.load(std::memory_order_relaxed);
+  s.send_calls = counters.send_calls.load(std::memory_order_relaxed);
+  return s;
+}
+
 void
 Server::SendBuffer(SocketAddress address, ConstBuffer<void> buffer) noexcept
 {
+#ifdef __linux__
+  auto &q = *send_queue;
+  if ((in_batch || q.n > 0) && buffer.size <= MAX_QUEUED_SEND_SIZE) {
+    /* while datagrams are waiting for the socket to become
+       writable, queue new ones behind them */
+
+    if (q.n == BATCH_SIZE) {
+      FlushSendQueue();
+
+      if (q.n == BATCH_SIZE) {
+        /* the socket buffer is still full: discard this datagram */
+        const auto e = MakeSocketError(EAGAIN, "Failed to send");
+        OnSendError(address, std::make_exception_ptr(e));
+        return;
+      }
+    }
+
+    const std::size_t i = q.n++;
+    memcpy(q.buffers[i].data(), buffer.data, buffer.size);
+    q.iov[i].iov_len = buffer.size;
+    q.addresses[i] = address;
+    return;
+  }
+#endif
+
+  ++counters.send_calls;
+  ++counters.sent_packets;
+
   try {
-    ssize_t nbytes = socket.GetSocket().Write(buffer.data, buffer.size);
+    ssize_t nbytes = socket.GetSocket().Write(buffer.data, buffer.size,
+                                              address);
     if (nbytes < 0)
       throw MakeSocketError("Failed to send");
   } catch (...) {
@@ -181,10 +243,135 @@ Server::OnDatagramReceived(Client &&client,
   }
 }
 
+#ifdef __linux__
+
 void
-Server::OnSocketReady(unsigned) noexcept
+Server::FlushSendQueue() noexcept
+{
+  auto &q = *send_queue;
+
+  for (std::size_t i = 0; i < q.n; ++i) {
+    auto &hdr = q.msgs[i].msg_hdr;
+    hdr = {};
+    hdr.msg_name = (struct sockaddr *)q.addresses[i];
+    hdr.msg_namelen = q.addresses[i].GetSize();
+    hdr.msg_iov = &q.iov[i];
+    hdr.msg_iovlen = 1;
+  }
+
+  std::size_t position = 0;
+  while (position < q.n) {
+    ++counters.send_calls;
+
+    int n = sendmmsg(socket.GetSocket().Get(),
+                     q.msgs.data() + position, q.n - position,
+                     MSG_DONTWAIT);
+    if (n < 0 && IsSocketErrorSendWouldBlock(GetSocketError()))
+      /* the socket buffer is full; retry the remaining datagrams
+         when the socket becomes writable */
+      break;
+
+    if (n <= 0) {
+      /* report the failed datagram and skip it */
+      try {
+        throw MakeSocketError("Failed to send");
+      } catch (...) {
+        OnSendError(q.addresses[position], std::current_exception());
+      }
+
+      ++position;
+      continue;
+    }
+
+    counters.sent_packets += n;
+    position += n;
+  }
+
+  if (position < q.n) {
+    if (position > 0) {
+      /* move the unsent datagrams to the head of the queue */
+      for (std::size_t i = position; i < q.n; ++i) {
+        const std::size_t j = i - position;
+        memcpy(q.buffers[j].data(), q.buffers[i].data(), q.iov[i].iov_len);
+        q.iov[j].iov_len = q.iov[i].iov_len;
+        q.addresses[j] = q.addresses[i];
+      }
+
+      q.n -= position;
+    }
+
+    socket.ScheduleWrite();
+  } else {
+    q.n = 0;
+    if (socket.IsWritePending())
+      socket.CancelWrite();
+  }
+}
+
+inline void
+Server::ReceiveBatched()
+{
+  auto &r = *receive_batch;
+
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    auto &hdr = r.msgs[i].msg_hdr;
+    hdr = {};
+    hdr.msg_name = (struct sockaddr *)r.addresses[i];
+    hdr.msg_namelen = r.addresses[i].GetCapacity();
+    hdr.msg_iov = &r.iov[i];
+    hdr.msg_iovlen = 1;
+  }
+
+  ++counters.receive_calls;
+
+  int n = recvmmsg(socket.GetSocket().Get(), r.msgs.data(), BATCH_SIZE,
+                   MSG_DONTWAIT, nullptr);
+  if (n < 0) {
+    if (IsSocketErrorReceiveWouldBlock(GetSocketError()))
+      return;
+
+    throw MakeSocketError("Failed to receive");
+  }
+
+  counters.received_packets += n;
+
+  /* collect all responses and send them with as few sendmmsg()
+     calls as possible */
+  BeginSendBatch();
+
+  for (int i = 0; i < n; ++i) {
+    Client client;
+    client.address = SocketAddress((const struct sockaddr *)r.addresses[i],
+                                   r.msgs[i].msg_hdr.msg_namelen);
+
+    OnDatagramReceived(std::move(client), r.buffers[i].data(),
+                       r.msgs[i].msg_len);
+  }
+
+  CommitSendBatch();
+}
+
+#endif
+
+void
+Server::OnSocketReady(unsigned events) noexcept
 try {
-  // TODO: use recvmmsg() on Linux
+#ifdef __linux__
+  if (events & SocketEvent::WRITE) {
+    /* retry the datagrams which were queued by FlushSendQueue() */
+    FlushSendQueue();
+
+    if ((events & ~SocketEvent::WRITE) == 0)
+      return;
+  }
+
+  if (batched) {
+    ReceiveBatched();
+    return;
+  }
+#endif
+
+  ++counters.receive_calls;
 
   Client client;
   socklen_t address_size = sizeof(client.address);
@@ -197,10 +384,15 @@ try {
     throw MakeSocketError("Failed to receive");
 
   client.address.SetSize(address_size);
-  // TODO: set client.key
+  ++counters.received_packets;
 
   OnDatagramReceived(std::move(client), buffer, nbytes);
 } catch (...) {
+#ifdef __linux__
+  in_batch = false;
+  send_queue->n = 0;
+#endif
+
   socket.Close();
   OnError(std::current_exception());
 }
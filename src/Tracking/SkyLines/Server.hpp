@@ -28,11 +28,18 @@ Copyright_License {
 #include "net/StaticSocketAddress.hxx"
 #include "util/ConstBuffer.hxx"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <exception>
+#include <memory>
 
 #include <cstdint>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 struct GeoPoint;
 
 namespace SkyLinesTracking {
@@ -52,8 +59,91 @@ public:
     uint64_t key;
   };
 
+  /**
+   * A snapshot of the I/O counters.
+   */
+  struct Statistics {
+    uint64_t received_packets = 0, receive_calls = 0;
+    uint64_t sent_packets = 0, send_calls = 0;
+
+    Statistics &operator+=(const Statistics &other) noexcept {
+      received_packets += other.received_packets;
+      receive_calls += other.receive_calls;
+      sent_packets += other.sent_packets;
+      send_calls += other.send_calls;
+      return *this;
+    }
+  };
+
+private:
+  /**
+   * I/O counters.  They are only modified by the #EventLoop thread,
+   * but may be read from any thread.
+   */
+  struct {
+    std::atomic<uint64_t> received_packets{0}, receive_calls{0};
+    std::atomic<uint64_t> sent_packets{0}, send_calls{0};
+  } counters;
+
+#ifdef __linux__
+  /**
+   * Receive (and send) up to this many datagrams with one
+   * recvmmsg() (sendmmsg()) system call.
+   */
+  static constexpr std::size_t BATCH_SIZE = 32;
+
+  static constexpr std::size_t MAX_RECEIVE_SIZE = 4096;
+
+  /**
+   * Larger responses bypass the send queue.
+   */
+  static constexpr std::size_t MAX_QUEUED_SEND_SIZE = 1536;
+
+  struct ReceiveBatch {
+    std::array<std::array<char, MAX_RECEIVE_SIZE>, BATCH_SIZE> buffers;
+    std::array<StaticSocketAddress, BATCH_SIZE> addresses;
+    std::array<struct iovec, BATCH_SIZE> iov;
+    std::array<struct mmsghdr, BATCH_SIZE> msgs;
+  };
+
+  /**
+   * Responses generated while handling a #ReceiveBatch; they are
+   * submitted with sendmmsg() after the whole batch has been
+   * handled.  Responses which could not be sent because the socket
+   * buffer was full stay here until the socket becomes writable.
+   */
+  struct SendQueue {
+    std::array<std::array<char, MAX_QUEUED_SEND_SIZE>, BATCH_SIZE> buffers;
+    std::array<StaticSocketAddress, BATCH_SIZE> addresses;
+    std::array<struct iovec, BATCH_SIZE> iov;
+    std::array<struct mmsghdr, BATCH_SIZE> msgs;
+    std::size_t n = 0;
+  };
+
+  std::unique_ptr<ReceiveBatch> receive_batch;
+  std::unique_ptr<SendQueue> send_queue;
+
+  /**
+   * Use recvmmsg()/sendmmsg()?
+   */
+  bool batched = true;
+
+  /**
+   * Are we currently handling a #ReceiveBatch?  While this is set,
+   * SendBuffer() appends to #send_queue.
+   */
+  bool in_batch = false;
+#endif
+
 public:
-  Server(EventLoop &event_loop, SocketAddress server_address);
+  /**
+   * @param reuse_port set SO_REUSEPORT on the socket, which allows
+   * several instances (e.g. one per thread) to bind to the same
+   * address; the kernel then distributes incoming datagrams among
+   * them
+   */
+  Server(EventLoop &event_loop, SocketAddress server_address,
+         bool reuse_port=false);
 
   ~Server();
 
@@ -71,6 +161,24 @@ public:
     return socket.GetEventLoop();
   }
 
+  /**
+   * Enable or disable the batched I/O mode (recvmmsg() and
+   * sendmmsg()).  It is enabled by default where available.
+   */
+  void SetBatched(bool _batched) noexcept {
+#ifdef __linux__
+    batched = _batched;
+#else
+    (void)_batched;
+#endif
+  }
+
+  /**
+   * Obtain a snapshot of the I/O counters.  This method is
+   * thread-safe.
+   */
+  Statistics GetStatistics() const noexcept;
+
   void SendBuffer(SocketAddress address, ConstBuffer<void> buffer) noexcept;
 
   template<typename P>
@@ -78,8 +186,45 @@ public:
     SendBuffer(address, ConstBuffer<void>{&packet, sizeof(packet)});
   }
 
+  /**
+   * Queue all datagrams sent until CommitSendBatch() and submit them
+   * with as few system calls as possible.  This is a no-op if the
+   * batched I/O mode is not available or disabled.
+   */
+  void BeginSendBatch() noexcept {
+#ifdef __linux__
+    if (batched)
+      in_batch = true;
+#endif
+  }
+
+  void CommitSendBatch() noexcept {
+#ifdef __linux__
+    if (in_batch) {
+      in_batch = false;
+      FlushSendQueue();
+    }
+#endif
+  }
+
 private:
   void OnDatagramReceived(Client &&client, void *data, size_t length);
+
+#ifdef __linux__
+  /**
+   * Receive and handle up to #BATCH_SIZE datagrams with one
+   * recvmmsg() call.  Throws on error.
+   */
+  void ReceiveBatched();
+
+  /**
+   * Submit all queued responses with sendmmsg().  If the socket
+   * buffer is full, the unsent responses remain in the queue, and
+   * this method is called again when the socket becomes writable.
+   */
+  void FlushSendQueue() noexcept;
+#endif
+
   void OnSocketReady(unsigned events) noexcept;
 
 protected:
@@ -0,0 +1,223 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#include "AsyncFileOutputStream.hpp"
+#include "FileOutputStream.hxx"
+
+#include <algorithm>
+
+AsyncFileOutputStream::AsyncFileOutputStream(FileOutputStream &_file,
+                                             std::size_t _capacity,
+                                             std::chrono::steady_clock::duration _sync_interval)
+  :Thread("AsyncFile"),
+   file(_file), capacity(_capacity), sync_interval(_sync_interval)
+{
+  pending.reserve(capacity);
+  writing.reserve(capacity);
+
+  synchronous = !Start();
+}
+
+AsyncFileOutputStream::~AsyncFileOutputStream() noexcept
+{
+  if (synchronous)
+    return;
+
+  {
+    const std::lock_guard<Mutex> lock(mutex);
+    should_stop = true;
+    work_cond.notify_one();
+  }
+
+  Join();
+}
+
+inline void
+AsyncFileOutputStream::Append(const void *data, std::size_t size) noexcept
+{
+  assert(size <= capacity - pending.size());
+
+  const bool was_empty = pending.empty();
+
+  const char *p = (const char *)data;
+  pending.insert(pending.end(), p, p + size);
+
+  /* wake up the writer thread to start the sync timer, or to write
+     a complete batch */
+  if (was_empty || IsBatchComplete())
+    work_cond.notify_one();
+}
+
+bool
+AsyncFileOutputStream::TryWrite(const void *data, std::size_t size) noexcept
+{
+  if (synchronous) {
+    try {
+      file.Write(data, size);
+      return true;
+    } catch (...) {
+      const std::lock_guard<Mutex> lock(mutex);
+      n_dropped += size;
+      return false;
+    }
+  }
+
+  const std::lock_guard<Mutex> lock(mutex);
+  if (error || size > capacity - pending.size()) {
+    n_dropped += size;
+    return false;
+  }
+
+  Append(data, size);
+  return true;
+}
+
+void
+AsyncFileOutputStream::Write(const void *data, std::size_t size)
+{
+  if (synchronous) {
+    file.Write(data, size);
+    return;
+  }
+
+  const char *p = (const char *)data;
+
+  std::unique_lock<Mutex> lock(mutex);
+  while (size > 0) {
+    if (error)
+      std::rethrow_exception(error);
+
+    const std::size_t room = capacity - pending.size();
+    if (room == 0) {
+      /* wait for the writer thread to take the pending data */
+      work_cond.notify_one();
+      done_cond.wait(lock);
+      continue;
+    }
+
+    const std::size_t n = std::min(size, room);
+    Append(p, n);
+    p += n;
+    size -= n;
+  }
+}
+
+void
+AsyncFileOutputStream::Flush()
+{
+  if (synchronous) {
+    file.Sync();
+    return;
+  }
+
+  std::unique_lock<Mutex> lock(mutex);
+  const unsigned id = ++n_flush_requested;
+  work_cond.notify_one();
+  done_cond.wait(lock, [this, id]{ return n_flushed >= id; });
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+std::size_t
+AsyncFileOutputStream::GetDroppedBytes() const noexcept
+{
+  const std::lock_guard<Mutex> lock(mutex);
+  return n_dropped;
+}
+
+void
+AsyncFileOutputStream::Run() noexcept
+{
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point sync_deadline = Clock::now();
+
+  /* has data been written since the last sync? */
+  bool dirty = false;
+
+  std::unique_lock<Mutex> lock(mutex);
+
+  while (true) {
+    const unsigned flush_id = n_flush_requested;
+    const bool flush = flush_id != n_flushed;
+    const bool stop = should_stop;
+    const auto now = Clock::now();
+    const bool sync = flush ||
+      ((dirty || !pending.empty()) && now >= sync_deadline);
+
+    if (!stop && !sync && !IsBatchComplete()) {
+      if (dirty || !pending.empty())
+        work_cond.wait_for(lock, sync_deadline - now);
+      else
+        work_cond.wait(lock);
+      continue;
+    }
+
+    /* take all pending data and write it without holding the
+       mutex */
+    writing.swap(pending);
+    done_cond.notify_all();
+
+    const bool failed = (bool)error;
+    lock.unlock();
+
+    std::exception_ptr new_error;
+    if (!failed) {
+      try {
+        if (!writing.empty()) {
+          file.Write(writing.data(), writing.size());
+          dirty = true;
+        }
+
+        if (sync && dirty) {
+          file.Sync();
+          dirty = false;
+        }
+      } catch (...) {
+        new_error = std::current_exception();
+      }
+    }
+
+    writing.clear();
+
+    lock.lock();
+
+    if (new_error)
+      error = std::move(new_error);
+
+    if (sync)
+      sync_deadline = Clock::now() + sync_interval;
+
+    if (flush) {
+      /* all data appended before the Flush() call has been
+         written */
+      n_flushed = flush_id;
+      done_cond.notify_all();
+    }
+
+    if (stop && pending.empty())
+      break;
+  }
+}
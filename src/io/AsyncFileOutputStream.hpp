@@ -0,0 +1,178 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_IO_ASYNC_FILE_OUTPUT_STREAM_HPP
+#define XCSOAR_IO_ASYNC_FILE_OUTPUT_STREAM_HPP
+
+#include "OutputStream.hxx"
+#include "thread/Thread.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <vector>
+
+class FileOutputStream;
+
+/**
+ * An OutputStream which collects data in memory and writes it to a
+ * FileOutputStream in a separate thread, in large batches, so slow
+ * storage (e.g. SD cards) does not stall the threads which produce
+ * the data.
+ *
+ * The data is written when a batch is complete, when Flush() is
+ * called, and at least once per sync interval; in the latter case,
+ * the file is also synced to the storage device, which limits what
+ * can be lost after a crash or power failure.
+ */
+class AsyncFileOutputStream final : public OutputStream, Thread {
+  /**
+   * Wake up the writer thread when this many bytes are pending.
+   */
+  static constexpr std::size_t BATCH_SIZE = 4096;
+
+  FileOutputStream &file;
+
+  const std::size_t capacity;
+
+  const std::chrono::steady_clock::duration sync_interval;
+
+  mutable Mutex mutex;
+
+  /**
+   * Signalled by the producers when the writer thread has something
+   * to do.
+   */
+  Cond work_cond;
+
+  /**
+   * Signalled by the writer thread when it has taken the #pending
+   * data, or when a Flush() has completed.
+   */
+  Cond done_cond;
+
+  /**
+   * Data which has not yet been taken by the writer thread.
+   * Protected by #mutex.
+   */
+  std::vector<char> pending;
+
+  /**
+   * The data currently being written by the writer thread.  Only
+   * used by the writer thread.
+   */
+  std::vector<char> writing;
+
+  /**
+   * The error thrown by FileOutputStream in the writer thread.  It
+   * is rethrown by the next Write() or Flush() call.  Protected by
+   * #mutex.
+   */
+  std::exception_ptr error;
+
+  /**
+   * The number of bytes discarded by TryWrite().  Protected by
+   * #mutex.
+   */
+  std::size_t n_dropped = 0;
+
+  /**
+   * Incremented by Flush() to request writing and syncing the
+   * pending data; #n_flushed follows when it's done.  Protected by
+   * #mutex.
+   */
+  unsigned n_flush_requested = 0, n_flushed = 0;
+
+  bool should_stop = false;
+
+  /**
+   * Could the writer thread not be launched?  Then all data is
+   * written synchronously.
+   */
+  bool synchronous;
+
+public:
+  /**
+   * @param _file the file to write to; it must stay valid until this
+   * object is destructed
+   * @param _capacity the maximum amount of pending data [bytes]
+   */
+  explicit AsyncFileOutputStream(FileOutputStream &_file,
+                                 std::size_t _capacity=64 * 1024,
+                                 std::chrono::steady_clock::duration _sync_interval=std::chrono::seconds(10));
+
+  /**
+   * Writes all pending data (ignoring errors) and stops the thread.
+   */
+  ~AsyncFileOutputStream() noexcept;
+
+  /**
+   * Append data without blocking.  If there is not enough room, the
+   * data is discarded as a whole and counted (see GetDroppedBytes()).
+   * Errors of earlier writes are ignored.
+   *
+   * @return true if the data has been appended
+   */
+  bool TryWrite(const void *data, std::size_t size) noexcept;
+
+  /**
+   * Wait until all data appended so far has been written and synced
+   * to the storage device.  Throws on error.
+   */
+  void Flush();
+
+  /**
+   * @return the number of bytes discarded by TryWrite()
+   */
+  [[gnu::pure]]
+  std::size_t GetDroppedBytes() const noexcept;
+
+  /* virtual methods from class OutputStream */
+
+  /**
+   * Append data.  Blocks while there is not enough room.  Throws if
+   * an earlier write has failed.
+   */
+  void Write(const void *data, std::size_t size) override;
+
+private:
+  /**
+   * Shall the writer thread take the #pending data now?  That is
+   * the case if it fills a batch, or if there is no room left (the
+   * capacity may be smaller than a batch).  Caller must lock
+   * #mutex.
+   */
+  bool IsBatchComplete() const noexcept {
+    return pending.size() >= std::min(BATCH_SIZE, capacity);
+  }
+
+  void Append(const void *data, std::size_t size) noexcept;
+
+  /* virtual methods from class Thread */
+  void Run() noexcept override;
+};
+
+#endif
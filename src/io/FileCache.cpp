@@ -35,7 +35,9 @@ Copyright_License {
 #include <sys/stat.h>
 #include <unistd.h>
 
-#ifndef HAVE_POSIX
+#ifdef HAVE_POSIX
+#include <sys/statvfs.h>
+#else
 #include <windows.h>
 #endif
 
@@ -107,15 +109,13 @@ FileCache::Flush(const TCHAR *name)
   File::Delete(MakeCachePath(name));
 }
 
-std::unique_ptr<Reader>
-FileCache::Load(const TCHAR *name, Path original_path) noexcept
+/**
+ * Open and validate a cache file.  Deletes the file if it is stale
+ * or corrupt.  Returns nullptr on error.
+ */
+static std::unique_ptr<Reader>
+OpenCacheFile(const FileInfo &original_info, Path path) noexcept
 {
-  FileInfo original_info;
-  if (!GetRegularFileInfo(original_path, original_info))
-    return nullptr;
-
-  const auto path = MakeCachePath(name);
-
   FileInfo cached_info;
   if (!GetRegularFileInfo(path, cached_info))
     return nullptr;
@@ -147,6 +147,30 @@ FileCache::Load(const TCHAR *name, Path original_path) noexcept
   return nullptr;
 }
 
+std::unique_ptr<Reader>
+FileCache::Load(const TCHAR *name, Path original_path) noexcept
+{
+  FileInfo original_info;
+  if (!GetRegularFileInfo(original_path, original_info))
+    return nullptr;
+
+  return OpenCacheFile(original_info, MakeCachePath(name));
+}
+
+AllocatedPath
+FileCache::LoadPath(const TCHAR *name, Path original_path) noexcept
+{
+  FileInfo original_info;
+  if (!GetRegularFileInfo(original_path, original_info))
+    return nullptr;
+
+  auto path = MakeCachePath(name);
+  if (!OpenCacheFile(original_info, path))
+    return nullptr;
+
+  return path;
+}
+
 std::unique_ptr<FileOutputStream>
 FileCache::Save(const TCHAR *name, Path original_path)
 {
@@ -166,3 +190,37 @@ FileCache::Save(const TCHAR *name, Path original_path)
   os->Write(&original_info, sizeof(original_info));
   return os;
 }
+
+/**
+ * @return the number of bytes available on the volume containing
+ * the given path or 0 on error
+ */
+static uint64_t
+GetFreeSpace(Path path) noexcept
+{
+#ifdef HAVE_POSIX
+  struct statvfs s;
+  if (statvfs(path.c_str(), &s) < 0)
+    return 0;
+
+  return uint64_t(s.f_bsize) * s.f_bavail;
+#else
+  ULARGE_INTEGER available;
+  if (!GetDiskFreeSpaceEx(path.c_str(), &available, nullptr, nullptr))
+    return 0;
+
+  return available.QuadPart;
+#endif
+}
+
+uint64_t
+FileCache::GetFreeSpace() const noexcept
+{
+  uint64_t result = ::GetFreeSpace(cache_path);
+  if (result == 0)
+    /* the cache directory is created lazily by Save(); try its
+       parent */
+    result = ::GetFreeSpace(cache_path.GetParent());
+
+  return result;
+}
@@ -28,6 +28,8 @@ Copyright_License {
 
 #include <memory>
 
+#include <cstdint>
+
 #include <stdio.h>
 #include <tchar.h>
 
@@ -54,10 +56,24 @@ public:
    */
   std::unique_ptr<Reader> Load(const TCHAR *name, Path original_path) noexcept;
 
+  /**
+   * Like Load(), but only validate the cache file and return its
+   * path, e.g. for mapping it into memory.  The payload begins after
+   * a small header.  Returns nullptr on error.
+   */
+  AllocatedPath LoadPath(const TCHAR *name, Path original_path) noexcept;
+
   /**
    * Throws on error.
    */
   std::unique_ptr<FileOutputStream> Save(const TCHAR *name, Path original_path);
+
+  /**
+   * Determine how many bytes are available on the volume containing
+   * the cache directory.  Returns 0 on error.
+   */
+  gcc_pure
+  uint64_t GetFreeSpace() const noexcept;
 };
 
 #endif
@@ -136,6 +136,12 @@ public:
 	/* virtual methods from class OutputStream */
 	void Write(const void *data, size_t size) override;
 
+	/**
+	 * Make sure all data written so far is on the storage device
+	 * (fsync()).  Throws on error.
+	 */
+	void Sync();
+
 	void Commit();
 	void Cancel() noexcept;
 
@@ -38,7 +38,7 @@ Copyright_License {
 #include <windows.h>
 #endif
 
-FileMapping::FileMapping(Path path)
+FileMapping::FileMapping(Path path, bool allow_empty)
 {
 #ifdef HAVE_POSIX
   auto fd = OpenReadOnly(path.c_str());
@@ -47,9 +47,16 @@ FileMapping::FileMapping(Path path)
   if (fstat(fd.Get(), &st) < 0)
     throw FormatErrno("Failed to stat %s", path.c_str());
 
-  /* mapping empty files can't be useful, let's make this a failure */
-  if (st.st_size <= 0)
+  /* mapping empty files can't be useful, let's make this a failure
+     unless the caller is prepared for it */
+  if (st.st_size <= 0) {
+    if (allow_empty && st.st_size == 0) {
+      m_size = 0;
+      return;
+    }
+
     throw FormatRuntimeError("File empty: %s", path.c_str());
+  }
 
   /* file is too large */
   if (st.st_size > 1024 * 1024 * 1024)
@@ -58,7 +65,7 @@ FileMapping::FileMapping(Path path)
   m_size = (size_t)st.st_size;
 
   m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd.Get(), 0);
-  if (m_data == nullptr)
+  if (m_data == MAP_FAILED)
     throw FormatErrno("Failed to map %s", path.c_str());
 
   madvise(m_data, m_size, MADV_WILLNEED);
@@ -85,6 +92,10 @@ FileMapping::FileMapping(Path path)
 
   m_size = fi.nFileSizeLow;
 
+  if (m_size == 0 && allow_empty)
+    /* CreateFileMapping() would fail */
+    return;
+
   hMapping = ::CreateFileMapping(hFile, nullptr, PAGE_READONLY,
                                  fi.nFileSizeHigh, fi.nFileSizeLow,
                                  nullptr);
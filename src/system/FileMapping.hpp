@@ -46,8 +46,11 @@ class FileMapping {
 public:
   /**
    * Throws on error.
+   *
+   * @param allow_empty if true, then an empty file results in an
+   * empty mapping (with data()==nullptr) instead of an error
    */
-  FileMapping(Path path);
+  FileMapping(Path path, bool allow_empty=false);
 
   ~FileMapping() noexcept;
 
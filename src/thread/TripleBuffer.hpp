@@ -0,0 +1,111 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#ifndef XCSOAR_THREAD_TRIPLE_BUFFER_HPP
+#define XCSOAR_THREAD_TRIPLE_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+
+/**
+ * Passes the latest version of a value from one writer thread to one
+ * reader thread, without locking and without ever blocking either of
+ * them.  The writer fills the "back" buffer and publishes it; the
+ * reader picks up the most recently published buffer.  Versions which
+ * are published while the reader is busy are skipped.
+ *
+ * There must be only one writer and one reader at a time; if more
+ * threads may access one side, they must be serialised by other means
+ * (e.g. a mutex).
+ */
+template<typename T>
+class TripleBuffer {
+  /**
+   * The bits of #middle which contain the buffer index.
+   */
+  static constexpr unsigned INDEX_MASK = 0x3;
+
+  /**
+   * This bit of #middle is set if the writer has published a
+   * buffer which was not yet picked up by the reader.
+   */
+  static constexpr unsigned FRESH = 0x4;
+
+  std::array<T, 3> buffers;
+
+  /**
+   * The buffer index which is currently owned by neither side, and
+   * the #FRESH flag.
+   */
+  std::atomic<unsigned> middle{1};
+
+  /**
+   * The buffer index owned by the writer.
+   */
+  unsigned back = 0;
+
+  /**
+   * The buffer index owned by the reader.
+   */
+  unsigned front = 2;
+
+public:
+  /**
+   * Writer: returns the buffer to be filled.  Its contents are
+   * undefined.
+   */
+  T &GetBack() noexcept {
+    return buffers[back];
+  }
+
+  /**
+   * Writer: make the back buffer available to the reader.
+   */
+  void Publish() noexcept {
+    back = middle.exchange(back | FRESH, std::memory_order_acq_rel)
+      & INDEX_MASK;
+  }
+
+  /**
+   * Reader: pick up the most recently published buffer.
+   *
+   * @return true if a new buffer has been published since the last
+   * call, false if GetFront() is unchanged
+   */
+  bool Consume() noexcept {
+    if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+      return false;
+
+    front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+    return true;
+  }
+
+  /**
+   * Reader: returns the buffer picked up by the last Consume() call.
+   */
+  const T &GetFront() const noexcept {
+    return buffers[front];
+  }
+};
+
+#endif
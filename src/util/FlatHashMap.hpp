@@ -0,0 +1,390 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+
+#ifndef XCSOAR_FLAT_HASH_MAP_HPP
+#define XCSOAR_FLAT_HASH_MAP_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A hash map with open addressing.  The elements are stored in one
+ * std::vector, and a separate table of 32 bit indices (linear
+ * probing) maps hashes to them.  Compared to std::unordered_map, this
+ * needs no allocation per element, and clear() keeps all memory for
+ * the next use.
+ *
+ * Unlike with most flat hash maps, iterators remain valid when the
+ * map grows (they are indices into the element vector); only clear()
+ * and erase() invalidate them.  This is important for the search
+ * algorithms (#Dijkstra, #AStar) which keep iterators in their
+ * queues.
+ *
+ * The elements are in insertion order, unless erase() has moved the
+ * last one into a gap.
+ */
+template<typename Key, typename T,
+         typename Hash=std::hash<Key>,
+         typename KeyEqual=std::equal_to<Key>>
+class FlatHashMap {
+public:
+  typedef Key key_type;
+  typedef T mapped_type;
+  typedef std::pair<const Key, T> value_type;
+  typedef std::size_t size_type;
+
+private:
+  /**
+   * The elements are stored with a mutable key, because erase()
+   * assigns to them; iterators expose the key as "const" (see
+   * #Reference).
+   */
+  typedef std::vector<std::pair<Key, T>> Storage;
+
+  static constexpr std::size_t MIN_SLOTS = 16;
+
+  /**
+   * The value of an empty slot; others contain the element index
+   * plus one.
+   */
+  static constexpr uint32_t EMPTY = 0;
+
+  Storage elements;
+
+  /**
+   * The hash table; its size is zero or a power of two, and it is
+   * never more than half full.
+   */
+  std::vector<uint32_t> slots;
+
+  /**
+   * The number of bits to shift the mixed 64 bit hash to obtain a
+   * slot number.
+   */
+  unsigned shift = 64;
+
+  Hash hash;
+  KeyEqual key_equal;
+
+public:
+  /**
+   * What an iterator points to: unlike std::unordered_map, this is
+   * not a #value_type reference, but a pair of references to the
+   * key, which cannot be modified (that would corrupt the hash
+   * table), and to the mapped value.
+   */
+  template<bool is_const>
+  struct Reference {
+    const Key &first;
+    std::conditional_t<is_const, const T, T> &second;
+  };
+
+  template<bool is_const>
+  class Iterator {
+    friend class FlatHashMap;
+
+    typedef std::conditional_t<is_const, const Storage, Storage> Container;
+
+    Container *elements = nullptr;
+    std::size_t i = 0;
+
+    constexpr Iterator(Container &_elements, std::size_t _i) noexcept
+      :elements(&_elements), i(_i) {}
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef FlatHashMap::value_type value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Reference<is_const> reference;
+
+    struct pointer {
+      reference r;
+
+      const reference *operator->() const noexcept {
+        return &r;
+      }
+    };
+
+    Iterator() noexcept = default;
+
+    /**
+     * Convert an iterator to a const_iterator.
+     */
+    template<bool c = is_const, typename = std::enable_if_t<c>>
+    constexpr Iterator(const Iterator<false> &other) noexcept
+      :elements(other.elements), i(other.i) {}
+
+    reference operator*() const noexcept {
+      auto &element = (*elements)[i];
+      return {element.first, element.second};
+    }
+
+    pointer operator->() const noexcept {
+      return {**this};
+    }
+
+    Iterator &operator++() noexcept {
+      ++i;
+      return *this;
+    }
+
+    Iterator operator++(int) noexcept {
+      Iterator old = *this;
+      ++i;
+      return old;
+    }
+
+    constexpr bool operator==(const Iterator &other) const noexcept {
+      return i == other.i;
+    }
+
+    constexpr bool operator!=(const Iterator &other) const noexcept {
+      return i != other.i;
+    }
+  };
+
+  typedef Iterator<false> iterator;
+  typedef Iterator<true> const_iterator;
+
+  [[gnu::pure]]
+  size_type size() const noexcept {
+    return elements.size();
+  }
+
+  [[gnu::pure]]
+  bool empty() const noexcept {
+    return elements.empty();
+  }
+
+  iterator begin() noexcept {
+    return {elements, 0};
+  }
+
+  iterator end() noexcept {
+    return {elements, elements.size()};
+  }
+
+  const_iterator begin() const noexcept {
+    return {elements, 0};
+  }
+
+  const_iterator end() const noexcept {
+    return {elements, elements.size()};
+  }
+
+  /**
+   * Remove all elements, but keep the allocated memory.
+   */
+  void clear() noexcept {
+    elements.clear();
+    std::fill(slots.begin(), slots.end(), EMPTY);
+  }
+
+  /**
+   * Allocate memory for the given number of elements.
+   *
+   * Throws std::bad_alloc on error.
+   */
+  void reserve(size_type n) {
+    elements.reserve(n);
+    if (2 * n > slots.size())
+      Rehash(2 * n);
+  }
+
+  [[gnu::pure]]
+  iterator find(const Key &key) noexcept {
+    return {elements, Find(key)};
+  }
+
+  [[gnu::pure]]
+  const_iterator find(const Key &key) const noexcept {
+    return {elements, Find(key)};
+  }
+
+  /**
+   * Insert a new element unless one with the same key exists
+   * already.
+   *
+   * Throws std::bad_alloc on error, or whatever the constructor of
+   * #T throws.
+   *
+   * @return an iterator to the new or the existing element, and true
+   * if the element was inserted
+   */
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return emplace(value.first, value.second);
+  }
+
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(const Key &key, Args&&... args) {
+    std::size_t s;
+
+    if (!slots.empty()) {
+      const std::size_t mask = slots.size() - 1;
+      for (s = GetSlot(key);; s = (s + 1) & mask) {
+        const uint32_t slot = slots[s];
+        if (slot == EMPTY)
+          break;
+
+        if (key_equal(elements[slot - 1].first, key))
+          return {{elements, slot - 1}, false};
+      }
+
+      if (2 * (elements.size() + 1) > slots.size()) {
+        Rehash(2 * slots.size());
+        s = FindEmptySlot(key);
+      }
+    } else {
+      Rehash(MIN_SLOTS);
+      s = FindEmptySlot(key);
+    }
+
+    slots[s] = elements.size() + 1;
+    elements.emplace_back(std::piecewise_construct,
+                          std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+    return {{elements, elements.size() - 1}, true};
+  }
+
+  /**
+   * Remove the element with the given key (if one exists).  The last
+   * element is moved into its place, invalidating iterators to it.
+   *
+   * @return the number of elements removed (0 or 1)
+   */
+  size_type erase(const Key &key)
+    noexcept(std::is_nothrow_move_assignable_v<Key> &&
+             std::is_nothrow_move_assignable_v<T>) {
+    if (slots.empty())
+      return 0;
+
+    const std::size_t mask = slots.size() - 1;
+    std::size_t s = GetSlot(key);
+    while (true) {
+      const uint32_t slot = slots[s];
+      if (slot == EMPTY)
+        return 0;
+
+      if (key_equal(elements[slot - 1].first, key))
+        break;
+
+      s = (s + 1) & mask;
+    }
+
+    const std::size_t i = slots[s] - 1;
+
+    /* backward shift deletion: move following elements of the
+       cluster into the hole unless that would put them before their
+       home slot */
+    std::size_t hole = s;
+    for (std::size_t j = (hole + 1) & mask; slots[j] != EMPTY;
+         j = (j + 1) & mask) {
+      const std::size_t home = GetSlot(elements[slots[j] - 1].first);
+      if (((j - home) & mask) >= ((j - hole) & mask)) {
+        slots[hole] = slots[j];
+        hole = j;
+      }
+    }
+
+    slots[hole] = EMPTY;
+
+    const std::size_t last = elements.size() - 1;
+    if (i != last) {
+      /* move the last element into the gap */
+      s = GetSlot(elements[last].first);
+      while (slots[s] != last + 1)
+        s = (s + 1) & mask;
+
+      slots[s] = i + 1;
+      elements[i] = std::move(elements[last]);
+    }
+
+    elements.pop_back();
+    return 1;
+  }
+
+private:
+  [[gnu::pure]]
+  std::size_t GetSlot(const Key &key) const noexcept {
+    /* Fibonacci hashing mixes the bits of simple hash functions such
+       as the identity */
+    return (uint64_t(hash(key)) * UINT64_C(0x9e3779b97f4a7c15)) >> shift;
+  }
+
+  /**
+   * @return the element index or elements.size() if there is no
+   * such element
+   */
+  [[gnu::pure]]
+  std::size_t Find(const Key &key) const noexcept {
+    if (slots.empty())
+      return elements.size();
+
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t s = GetSlot(key);; s = (s + 1) & mask) {
+      const uint32_t slot = slots[s];
+      if (slot == EMPTY)
+        return elements.size();
+
+      if (key_equal(elements[slot - 1].first, key))
+        return slot - 1;
+    }
+  }
+
+  [[gnu::pure]]
+  std::size_t FindEmptySlot(const Key &key) const noexcept {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t s = GetSlot(key);
+    while (slots[s] != EMPTY)
+      s = (s + 1) & mask;
+    return s;
+  }
+
+  void Rehash(std::size_t n) {
+    /* round up to the next power of two */
+    std::size_t size = MIN_SLOTS;
+    unsigned bits = 4;
+    while (size < n) {
+      size *= 2;
+      ++bits;
+    }
+
+    assert(size >= MIN_SLOTS);
+    assert(size > slots.size());
+
+    slots.assign(size, EMPTY);
+    shift = 64 - bits;
+
+    for (std::size_t i = 0; i < elements.size(); ++i)
+      slots[FindEmptySlot(elements[i].first)] = i + 1;
+  }
+};
+
+#endif
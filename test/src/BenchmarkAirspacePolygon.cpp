@@ -0,0 +1,242 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the vectorised #SearchPointArrays kernels with the scalar
+ * #SearchPointVector code on the polygons of an OpenAir/TNP file.
+ * The query points are scattered around each polygon's bounding box,
+ * which resembles the candidates returned by the airspace rtree.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Geo/SearchPointArrays.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/Flat/FlatRay.hpp"
+#include "system/Args.hpp"
+#include "io/FileLineReader.hpp"
+#include "Operation/Operation.hpp"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned N_QUERIES = 64;
+
+/**
+ * Each mode is measured this many times, and the best result is
+ * reported, to reduce the noise.
+ */
+static constexpr unsigned N_ROUNDS = 5;
+
+using Clock = std::chrono::steady_clock;
+
+struct Polygon {
+  const SearchPointVector *border;
+  SearchPointArrays arrays;
+
+  std::vector<GeoPoint> queries;
+  std::vector<FlatGeoPoint> flat_queries;
+};
+
+static double
+ScalarInside(const Polygon &polygon, long &checksum)
+{
+  for (const GeoPoint &p : polygon.queries)
+    checksum += polygon.border->IsInside(p);
+  return polygon.queries.size();
+}
+
+static double
+VectorInside(const Polygon &polygon, long &checksum)
+{
+  for (const GeoPoint &p : polygon.queries)
+    checksum += polygon.arrays.IsInside(p);
+  return polygon.queries.size();
+}
+
+static double
+ScalarNearest(const Polygon &polygon, long &checksum)
+{
+  for (const FlatGeoPoint &p : polygon.flat_queries) {
+    const FlatGeoPoint n = polygon.border->NearestPoint(p);
+    checksum += n.x ^ n.y;
+  }
+  return polygon.flat_queries.size();
+}
+
+static double
+VectorNearest(const Polygon &polygon, long &checksum)
+{
+  for (const FlatGeoPoint &p : polygon.flat_queries) {
+    const FlatGeoPoint n = polygon.arrays.NearestPoint(p);
+    checksum += n.x ^ n.y;
+  }
+  return polygon.flat_queries.size();
+}
+
+static double
+ScalarIntersects(const Polygon &polygon, long &checksum)
+{
+  const auto &border = *polygon.border;
+  const auto &q = polygon.flat_queries;
+  for (std::size_t i = 0; i + 1 < q.size(); ++i) {
+    const FlatRay ray(q[i], q[i + 1]);
+    for (auto it = border.begin(); it + 1 != border.end(); ++it) {
+      const FlatRay segment(it->GetFlatLocation(),
+                            (it + 1)->GetFlatLocation());
+      checksum += ray.DistinctIntersection(segment) >= 0;
+    }
+  }
+  return q.size() - 1;
+}
+
+static double
+VectorIntersects(const Polygon &polygon, long &checksum)
+{
+  const auto &q = polygon.flat_queries;
+  for (std::size_t i = 0; i + 1 < q.size(); ++i) {
+    const FlatRay ray(q[i], q[i + 1]);
+    polygon.arrays.VisitIntersections(ray, [&checksum](double){
+      ++checksum;
+    });
+  }
+  return q.size() - 1;
+}
+
+/**
+ * @return the number of calls per second
+ */
+template<typename F>
+static double
+Run(const std::vector<Polygon> &polygons, F &&f, long &checksum)
+{
+  double best = 0;
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    checksum = 0;
+    double n = 0;
+
+    const auto start = Clock::now();
+    for (const auto &polygon : polygons)
+      n += f(polygon, checksum);
+
+    const std::chrono::duration<double> d = Clock::now() - start;
+    best = std::max(best, n / d.count());
+  }
+
+  return best;
+}
+
+template<typename S, typename V>
+static void
+Compare(const char *name, const std::vector<Polygon> &polygons, S &&s, V &&v)
+{
+  long scalar_checksum, vector_checksum;
+  const double scalar = Run(polygons, s, scalar_checksum);
+  const double vector = Run(polygons, v, vector_checksum);
+
+  printf("%-12s %14.0f %14.0f %8.2fx %s\n", name, scalar, vector,
+         vector / scalar,
+         scalar_checksum == vector_checksum ? "ok" : "MISMATCH");
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  Airspaces airspaces;
+
+  {
+    FileLineReader reader(path, Charset::AUTO);
+    NullOperationEnvironment operation;
+    if (!ParseAirspaceFile(airspaces, reader, operation)) {
+      fprintf(stderr, "Failed to parse input file\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  airspaces.Optimise();
+
+  const FlatProjection &projection = airspaces.GetProjection();
+  std::mt19937 rng(42);
+
+  std::vector<Polygon> polygons;
+  unsigned n_polygons = 0, n_points = 0;
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &as = i.GetAirspace();
+    if (as.GetShape() != AbstractAirspace::Shape::POLYGON)
+      continue;
+
+    ++n_polygons;
+
+    Polygon polygon;
+    polygon.border = &as.GetPoints();
+    polygon.arrays.SetLocations(as.GetPoints());
+    polygon.arrays.SetFlatLocations(as.GetPoints());
+    if (!polygon.arrays.IsDefined())
+      continue;
+
+    n_points += as.GetPoints().size();
+
+    /* scatter the queries over the bounding box and a margin of
+       25% around it */
+    const GeoBounds bounds = as.GetGeoBounds();
+    const double width = bounds.GetWidth().Native();
+    const double height = bounds.GetHeight().Native();
+    std::uniform_real_distribution<double>
+      lon(bounds.GetWest().Native() - width / 4,
+          bounds.GetEast().Native() + width / 4),
+      lat(bounds.GetSouth().Native() - height / 4,
+          bounds.GetNorth().Native() + height / 4);
+
+    for (unsigned j = 0; j < N_QUERIES; ++j) {
+      const GeoPoint p(Angle::Native(lon(rng)), Angle::Native(lat(rng)));
+      polygon.queries.push_back(p);
+      polygon.flat_queries.push_back(projection.ProjectInteger(p));
+    }
+
+    polygons.push_back(std::move(polygon));
+  }
+
+  printf("%u polygons, %zu with at least %u points (%u points)\n",
+         n_polygons, polygons.size(), SearchPointArrays::MIN_POINTS,
+         n_points);
+  printf("%-12s %14s %14s %9s\n", "kernel", "scalar/s", "vector/s",
+         "speedup");
+  Compare("inside", polygons, ScalarInside, VectorInside);
+  Compare("nearest", polygons, ScalarNearest, VectorNearest);
+  Compare("intersects", polygons, ScalarIntersects, VectorIntersects);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,202 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare an airspace rtree built by inserting the airspaces one by
+ * one with a bulk-loaded (packed) one, as built by
+ * Airspaces::Optimise(): build time and the throughput of the
+ * queries used by Airspaces::QueryWithinRange() and
+ * Airspaces::QueryIntersecting().
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/GeoVector.hpp"
+#include "system/Args.hpp"
+#include "io/FileLineReader.hpp"
+#include "Operation/Operation.hpp"
+#include "util/PrintException.hxx"
+
+#include <boost/geometry/geometries/linestring.hpp>
+#include <boost/geometry/algorithms/intersection.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace bgi = boost::geometry::index;
+
+typedef AirspacesInterface::AirspaceTree AirspaceTree;
+typedef AirspacesInterface::AirspaceVector AirspaceVector;
+typedef boost::geometry::model::linestring<FlatGeoPoint> Line;
+
+static constexpr unsigned N_QUERIES = 100000;
+
+/**
+ * Each measurement is repeated this many times, and the best result
+ * is reported, to reduce the noise.
+ */
+static constexpr unsigned N_ROUNDS = 5;
+
+using Clock = std::chrono::steady_clock;
+
+struct Queries {
+  std::vector<FlatBoundingBox> boxes;
+  std::vector<Line> lines;
+};
+
+static AirspaceTree
+BuildInsert(const AirspaceVector &items)
+{
+  AirspaceTree tree;
+  for (const auto &i : items)
+    tree.insert(i);
+  return tree;
+}
+
+static AirspaceTree
+BuildPacked(const AirspaceVector &items)
+{
+  return AirspaceTree(items.begin(), items.end());
+}
+
+template<typename F>
+static double
+MeasureBuild(const AirspaceVector &items, F &&f)
+{
+  double best = 1e9;
+
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    const auto start = Clock::now();
+    const auto tree = f(items);
+    const std::chrono::duration<double, std::milli> d = Clock::now() - start;
+    best = std::min(best, d.count());
+  }
+
+  return best;
+}
+
+template<typename Q>
+static double
+MeasureQueries(const AirspaceTree &tree, const std::vector<Q> &queries,
+               unsigned long &n_results)
+{
+  double best = 0;
+
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    n_results = 0;
+
+    const auto start = Clock::now();
+    for (const auto &q : queries)
+      n_results += std::distance(tree.qbegin(bgi::intersects(q)),
+                                 tree.qend());
+
+    const std::chrono::duration<double> d = Clock::now() - start;
+    best = std::max(best, queries.size() / d.count());
+  }
+
+  return best;
+}
+
+template<typename Q>
+static void
+CompareQueries(const char *name, const AirspaceTree &insert,
+               const AirspaceTree &packed, const std::vector<Q> &queries)
+{
+  unsigned long insert_results, packed_results;
+  const double a = MeasureQueries(insert, queries, insert_results);
+  const double b = MeasureQueries(packed, queries, packed_results);
+
+  printf("%-12s %14.0f %14.0f %8.2fx %6.1f %s\n", name, a, b, b / a,
+         double(packed_results) / queries.size(),
+         insert_results == packed_results ? "ok" : "MISMATCH");
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH");
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  Airspaces airspaces;
+
+  {
+    FileLineReader reader(path, Charset::AUTO);
+    NullOperationEnvironment operation;
+    if (!ParseAirspaceFile(airspaces, reader, operation)) {
+      fprintf(stderr, "Failed to parse input file\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  airspaces.Optimise();
+
+  AirspaceVector items;
+  for (const auto &i : airspaces.QueryAll())
+    items.push_back(i);
+
+  /* the typical queries of the warning manager and the map: a 20 km
+     square around the aircraft, and a 20 km glide path */
+  const TaskProjection &projection = airspaces.GetTaskProjection();
+  const GeoBounds &bounds = projection.GetBounds();
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double>
+    lon(bounds.GetWest().Native(), bounds.GetEast().Native()),
+    lat(bounds.GetSouth().Native(), bounds.GetNorth().Native()),
+    bearing(0, 360);
+
+  Queries queries;
+  for (unsigned i = 0; i < N_QUERIES; ++i) {
+    const GeoPoint p(Angle::Native(lon(rng)), Angle::Native(lat(rng)));
+    queries.boxes.push_back(projection.ProjectSquare(p, 20000));
+
+    const GeoPoint end =
+      GeoVector(20000, Angle::Degrees(bearing(rng))).EndPoint(p);
+    Line line;
+    line.push_back(projection.ProjectInteger(p));
+    line.push_back(projection.ProjectInteger(end));
+    queries.lines.push_back(std::move(line));
+  }
+
+  printf("%zu airspaces\n", items.size());
+  printf("%-12s %14.2f %14.2f ms\n", "build",
+         MeasureBuild(items, BuildInsert), MeasureBuild(items, BuildPacked));
+
+  const auto insert = BuildInsert(items), packed = BuildPacked(items);
+
+  printf("%-12s %14s %14s %9s %6s\n", "query", "insert/s", "packed/s",
+         "speedup", "hits");
+  CompareQueries("range", insert, packed, queries.boxes);
+  CompareQueries("intersect", insert, packed, queries.lines);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
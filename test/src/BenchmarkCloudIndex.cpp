@@ -0,0 +1,180 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the geospatial indexes of the xcsoar-cloud-server with a
+ * simulated workload: all clients move once per round, and a part of
+ * them query their neighbours within the traffic range.
+ */
+
+#include "Cloud/GridIndex.hpp"
+#include "Cloud/RTreeIndex.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr double RANGE = 50000;
+
+/**
+ * The clients are spread over an area of this size (degrees).
+ */
+static constexpr double AREA_SIZE = 10;
+
+/**
+ * The number of clients which query their neighbours in each round.
+ */
+static constexpr unsigned QUERIES_PER_ROUND = 1000;
+
+struct Point : std::enable_shared_from_this<Point>, GeoGridHook {
+  GeoPoint location;
+
+  explicit Point(GeoPoint _location) noexcept:location(_location) {}
+};
+
+using PointPtr = std::shared_ptr<Point>;
+
+struct PointIndexable {
+  typedef GeoPoint result_type;
+
+  [[gnu::pure]]
+  result_type operator()(const PointPtr &point) const noexcept {
+    return point->location;
+  }
+};
+
+struct Result {
+  double insert_ns, update_ns, query_ns;
+  unsigned long n_results;
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double
+NanosecondsPer(Clock::duration d, unsigned long n) noexcept
+{
+  return std::chrono::duration<double, std::nano>(d).count() / n;
+}
+
+template<typename Index>
+static Result
+Run(const std::vector<GeoPoint> &initial, unsigned n_rounds)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> step(-0.001, 0.001);
+
+  std::vector<PointPtr> points;
+  points.reserve(initial.size());
+  for (const auto &i : initial)
+    points.emplace_back(std::make_shared<Point>(i));
+
+  Index index;
+  Result result{};
+
+  auto start = Clock::now();
+  for (const auto &i : points)
+    index.insert(i);
+  result.insert_ns = NanosecondsPer(Clock::now() - start, points.size());
+
+  Clock::duration update_time{}, query_time{};
+  unsigned long n_updates = 0, n_queries = 0;
+
+  for (unsigned round = 0; round < n_rounds; ++round) {
+    start = Clock::now();
+    for (const auto &i : points) {
+      index.remove(i);
+      i->location.longitude += Angle::Degrees(step(rng));
+      i->location.latitude += Angle::Degrees(step(rng));
+      index.insert(i);
+    }
+    update_time += Clock::now() - start;
+    n_updates += points.size();
+
+    start = Clock::now();
+    const std::size_t query_step =
+      std::max<std::size_t>(points.size() / QUERIES_PER_ROUND, 1);
+    for (std::size_t i = round % query_step; i < points.size();
+         i += query_step) {
+      for (const auto &j : index.QueryWithinRange(points[i]->location,
+                                                  RANGE)) {
+        (void)j;
+        ++result.n_results;
+      }
+
+      ++n_queries;
+    }
+    query_time += Clock::now() - start;
+  }
+
+  result.update_ns = NanosecondsPer(update_time, n_updates);
+  result.query_ns = NanosecondsPer(query_time, n_queries);
+  return result;
+}
+
+static void
+Print(const char *name, unsigned n, const Result &r)
+{
+  printf("%-6s %7u %10.0f %10.0f %12.0f %14lu\n",
+         name, n, r.insert_ns, r.update_ns, r.query_ns, r.n_results);
+}
+
+int
+main(int, char **)
+{
+  printf("%-6s %7s %10s %10s %12s %14s\n",
+         "index", "clients", "insert/ns", "update/ns", "query/ns",
+         "results");
+
+  for (const unsigned n : {1000u, 10000u, 100000u}) {
+    std::mt19937 rng(n);
+    std::uniform_real_distribution<double> latitude(44, 44 + AREA_SIZE);
+    std::uniform_real_distribution<double> longitude(4, 4 + AREA_SIZE);
+
+    std::vector<GeoPoint> initial;
+    initial.reserve(n);
+    for (unsigned i = 0; i < n; ++i)
+      initial.emplace_back(Angle::Degrees(longitude(rng)),
+                           Angle::Degrees(latitude(rng)));
+
+    /* the same amount of work for each size */
+    const unsigned n_rounds = std::max(200000u / n, 2u);
+
+    const auto grid =
+      Run<GeoGridIndex<Point, PointIndexable>>(initial, n_rounds);
+    Print("grid", n, grid);
+
+    const auto rtree =
+      Run<GeoRTreeIndex<Point, PointIndexable>>(initial, n_rounds);
+    Print("rtree", n, rtree);
+
+    if (grid.n_results != rtree.n_results)
+      fprintf(stderr, "Result mismatch: %lu != %lu\n",
+              grid.n_results, rtree.n_results);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Replay a flight into the contest traces and measure the exhaustive
+ * solvers which are based on ContestDijkstra: the time and the
+ * number of heap allocations per solve.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Contest/ContestManager.hpp"
+#include "system/Args.hpp"
+#include "DebugReplay.hpp"
+
+#include <chrono>
+#include <new>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static std::size_t n_allocations;
+
+void *
+operator new(std::size_t size)
+{
+  ++n_allocations;
+
+  void *p = malloc(size > 0 ? size : 1);
+  if (p == nullptr)
+    throw std::bad_alloc();
+
+  return p;
+}
+
+void
+operator delete(void *p) noexcept
+{
+  free(p);
+}
+
+void
+operator delete(void *p, std::size_t) noexcept
+{
+  free(p);
+}
+
+static Trace full_trace(0, Trace::null_time, 512);
+static Trace triangle_trace(0, Trace::null_time, 1024);
+static Trace sprint_trace(0, 9000, 128);
+
+static constexpr unsigned N_ROUNDS = 5;
+
+static void
+LoadTraces(DebugReplay &replay)
+{
+  bool released = false;
+
+  while (replay.Next()) {
+    const MoreData &basic = replay.Basic();
+    if (!basic.time_available || !basic.location_available ||
+        !basic.NavAltitudeAvailable())
+      continue;
+
+    if (!released && replay.Calculated().flight.release_time >= 0) {
+      released = true;
+
+      triangle_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      full_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+      sprint_trace.EraseEarlierThan(replay.Calculated().flight.release_time);
+    }
+
+    const TracePoint point(basic);
+    triangle_trace.push_back(point);
+    full_trace.push_back(point);
+    sprint_trace.push_back(point);
+  }
+}
+
+static void
+Run(const char *name, Contest contest)
+{
+  using Clock = std::chrono::steady_clock;
+
+  ContestManager manager(contest, full_trace, triangle_trace, sprint_trace);
+
+  Clock::duration best = Clock::duration::max();
+  std::size_t allocations = 0;
+
+  for (unsigned i = 0; i < N_ROUNDS; ++i) {
+    manager.Reset();
+
+    const std::size_t n = n_allocations;
+    const auto start = Clock::now();
+    manager.SolveExhaustive();
+    best = std::min(best, Clock::now() - start);
+    allocations = n_allocations - n;
+  }
+
+  printf("%-16s %10.2f %12zu %10.1f\n", name,
+         std::chrono::duration<double, std::milli>(best).count(),
+         allocations, manager.GetStats().GetResult().score);
+}
+
+int main(int argc, char **argv)
+{
+  Args args(argc, argv, "DRIVER FILE");
+  DebugReplay *replay = CreateDebugReplay(args);
+  if (replay == NULL)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  LoadTraces(*replay);
+  delete replay;
+
+  printf("%-16s %10s %12s %10s\n",
+         "contest", "time/ms", "allocations", "score");
+  Run("olc_classic", Contest::OLC_CLASSIC);
+  Run("dmst", Contest::DMST);
+  Run("net_coupe", Contest::NET_COUPE);
+  Run("sis_at", Contest::SIS_AT);
+  Run("weglide_distance", Contest::WEGLIDE_DISTANCE);
+  Run("weglide_or", Contest::WEGLIDE_OR);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measure the lock contention between a device's I/O thread and the
+ * DeviceBlackboard readers.  The "locked" mode is the old way: the
+ * I/O thread locks the blackboard mutex for each sentence.  The
+ * "staged" mode is what DeviceDescriptor::ParseLine() does now: it
+ * parses into its own copy and hands it over with a TripleBuffer
+ * (DeviceBlackboard::StageDeviceData()).  Meanwhile, a second thread
+ * simulates DeviceBlackboard::Merge() and the other readers, which
+ * hold the mutex while copying NMEAInfo objects.
+ */
+
+#include "NMEA/Info.hpp"
+#include "Device/Features.hpp"
+#include "thread/Mutex.hxx"
+#include "thread/TripleBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+struct Shared {
+  Mutex mutex;
+
+  NMEAInfo device_data[NUMDEV]{};
+  NMEAInfo merged{};
+
+  TripleBuffer<NMEAInfo> staged;
+
+  std::atomic<bool> stop{false};
+};
+
+struct Result {
+  double ns_per_sentence;
+  double max_us;
+  unsigned long contended;
+};
+
+/**
+ * The "reader" thread: simulates DeviceBlackboard::Merge(), which
+ * holds the mutex while copying all device data.
+ */
+static void
+MergeLoop(Shared &shared) noexcept
+{
+  while (!shared.stop.load(std::memory_order_relaxed)) {
+    {
+      const std::lock_guard<Mutex> lock(shared.mutex);
+
+      if (shared.staged.Consume())
+        shared.device_data[0] = shared.staged.GetFront();
+
+      for (const auto &i : shared.device_data)
+        shared.merged = i;
+    }
+
+    std::this_thread::yield();
+  }
+}
+
+static Result
+Run(bool staged, unsigned long n_sentences) noexcept
+{
+  Shared shared;
+  NMEAInfo parsed{};
+
+  std::thread merge_thread(MergeLoop, std::ref(shared));
+
+  Result result{};
+  Clock::duration max{};
+
+  const auto start = Clock::now();
+  for (unsigned long i = 0; i < n_sentences; ++i) {
+    const auto t = Clock::now();
+
+    if (staged) {
+      /* DeviceDescriptor::ParseLine() */
+      parsed.clock = i;
+      parsed.alive.Update(parsed.clock);
+      shared.staged.GetBack() = parsed;
+      shared.staged.Publish();
+    } else {
+      /* the old DeviceDescriptor::ParseLine() */
+      if (!shared.mutex.try_lock()) {
+        ++result.contended;
+        shared.mutex.lock();
+      }
+
+      NMEAInfo &basic = shared.device_data[0];
+      basic.clock = i;
+      basic.alive.Update(basic.clock);
+
+      shared.mutex.unlock();
+    }
+
+    max = std::max(max, Clock::now() - t);
+  }
+
+  const auto duration = Clock::now() - start;
+
+  shared.stop.store(true, std::memory_order_relaxed);
+  merge_thread.join();
+
+  result.ns_per_sentence =
+    std::chrono::duration<double, std::nano>(duration).count() / n_sentences;
+  result.max_us = std::chrono::duration<double, std::micro>(max).count();
+  return result;
+}
+
+static void
+Print(const char *name, const Result &r)
+{
+  printf("%-7s %10.0f %10.1f %12lu\n",
+         name, r.ns_per_sentence, r.max_us, r.contended);
+}
+
+int
+main(int argc, char **argv)
+{
+  unsigned long n_sentences = 1000000;
+  if (argc > 2) {
+    fprintf(stderr, "Usage: %s [SENTENCES]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (argc == 2) {
+    char *endptr;
+    n_sentences = strtoul(argv[1], &endptr, 10);
+    if (endptr == argv[1] || *endptr != 0 || n_sentences == 0) {
+      fprintf(stderr, "Invalid number of sentences\n");
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("%-7s %10s %10s %12s\n",
+         "mode", "ns/line", "max/us", "contended");
+
+  Print("locked", Run(false, n_sentences));
+  Print("staged", Run(true, n_sentences));
+
+  return EXIT_SUCCESS;
+}
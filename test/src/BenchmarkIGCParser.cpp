@@ -0,0 +1,149 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the line based IGC parser (FileLineReaderA and
+ * IGCParseFix(), as used by DebugReplayIGC) with IGCParseFixes(),
+ * which maps the file and decodes the B records into columns.  Both
+ * results are compared fix by fix.
+ */
+
+#include "IGC/IGCBulkParser.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IGC/IGCFix.hpp"
+#include "io/FileLineReader.hpp"
+#include "system/Args.hpp"
+#include "system/FileUtil.hpp"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * Each measurement is repeated this many times, and the best result
+ * is reported, to reduce the noise.
+ */
+static constexpr unsigned N_ROUNDS = 5;
+
+using Clock = std::chrono::steady_clock;
+
+static void
+ParseLines(Path path, std::vector<IGCFix> &fixes)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  IGCFix fix;
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    if (line[0] == 'I')
+      IGCParseExtensions(line, extensions);
+    else if (IGCParseFix(line, extensions, fix))
+      fixes.push_back(fix);
+  }
+}
+
+template<typename F>
+static double
+Measure(F &&f)
+{
+  double best = 1e9;
+
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    const auto start = Clock::now();
+    f();
+    const std::chrono::duration<double> d = Clock::now() - start;
+    best = std::min(best, d.count());
+  }
+
+  return best;
+}
+
+static bool
+Equals(const IGCFix &a, const IGCFix &b)
+{
+  return a.time == b.time &&
+    a.location.latitude.Native() == b.location.latitude.Native() &&
+    a.location.longitude.Native() == b.location.longitude.Native() &&
+    a.gps_valid == b.gps_valid &&
+    a.gps_altitude == b.gps_altitude &&
+    a.pressure_altitude == b.pressure_altitude &&
+    a.enl == b.enl && a.rpm == b.rpm &&
+    a.hdm == b.hdm && a.hdt == b.hdt && a.trm == b.trm && a.trt == b.trt &&
+    a.gsp == b.gsp && a.ias == b.ias && a.tas == b.tas && a.siu == b.siu;
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.igc");
+  const auto path = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  const uint64_t size = File::GetSize(path);
+
+  std::vector<IGCFix> fixes;
+  const double line_time = Measure([&](){
+      fixes.clear();
+      ParseLines(path, fixes);
+    });
+
+  IGCFixColumns columns;
+  const double bulk_time = Measure([&](){
+      columns.clear();
+      IGCParseFixes(path, columns);
+    });
+
+  std::size_t n_mismatches = 0;
+  if (columns.size() != fixes.size())
+    n_mismatches = std::max(columns.size(), fixes.size());
+  else {
+    for (std::size_t i = 0; i < fixes.size(); ++i) {
+      IGCFix fix;
+      columns.Get(i, fix);
+      if (!Equals(fix, fixes[i]))
+        ++n_mismatches;
+    }
+  }
+
+  const double mb = size / (1024. * 1024.);
+  printf("%.1f MB, %zu fixes\n", mb, fixes.size());
+  printf("%-8s %10s %10s %14s\n", "parser", "ms", "MB/s", "fixes/s");
+  printf("%-8s %10.2f %10.1f %14.0f\n", "line",
+         line_time * 1000, mb / line_time, fixes.size() / line_time);
+  printf("%-8s %10.2f %10.1f %14.0f\n", "bulk",
+         bulk_time * 1000, mb / bulk_time, columns.size() / bulk_time);
+  printf("speedup %.2fx, %s\n", line_time / bulk_time,
+         n_mismatches == 0 ? "ok" : "MISMATCH");
+
+  return n_mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Compare the cost of RoutePlanner::UpdateReach() with a full
+ * RoutePlanner::SolveReach() on a terrain file.  For each origin, the
+ * reach is solved, then the aircraft moves 300m and loses 10m, and
+ * the reach is updated and solved again from the moved position.
+ */
+
+#include "Engine/Route/TerrainRoute.hpp"
+#include "Engine/Route/Config.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "GlideSolvers/GlideSettings.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Operation/Operation.hpp"
+#include "thread/SharedMutex.hpp"
+
+#include <zzip/zzip.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include <climits>
+#include <stdio.h>
+#include <stdlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Each measurement is repeated this many times, and the best result
+ * is used, to reduce the noise.
+ */
+static constexpr unsigned N_ROUNDS = 3;
+
+/**
+ * @return the best duration of Solve() and of Update() [ms], or a
+ * negative update duration if UpdateReach() has rejected the move
+ */
+static std::pair<double, double>
+Run(TerrainRoute &route, const RoutePlannerConfig &config,
+    const AGeoPoint &origin, const AGeoPoint &moved)
+{
+  double solve = 1e9, update = 1e9;
+
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    auto start = Clock::now();
+    route.SolveReach(moved, config, INT_MAX);
+    std::chrono::duration<double, std::milli> d = Clock::now() - start;
+    solve = std::min(solve, d.count());
+
+    route.SolveReach(origin, config, INT_MAX);
+
+    start = Clock::now();
+    if (!route.UpdateReach(moved, config, INT_MAX))
+      return {solve, -1};
+    d = Clock::now() - start;
+    update = std::min(update, d.count());
+  }
+
+  return {solve, update};
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 2) {
+    fprintf(stderr, "Usage: %s FILE.xcm\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  ZZIP_DIR *dir = zzip_dir_open(argv[1], nullptr);
+  if (dir == nullptr) {
+    fprintf(stderr, "Failed to open %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  RasterMap map;
+
+  NullOperationEnvironment operation;
+  if (!LoadTerrainOverview(dir, map.GetTileCache(), operation)) {
+    fprintf(stderr, "failed to load map\n");
+    return EXIT_FAILURE;
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(dir, map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), 100000);
+  } while (map.IsDirty());
+  zzip_dir_close(dir);
+
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+
+  GlidePolar polar(1);
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, SpeedVector::Zero(), 0);
+  route.SetTerrain(&map);
+
+  printf("%-22s %6s %10s %10s %6s\n",
+         "origin", "AGL", "solve/ms", "update/ms", "ratio");
+
+  const GeoPoint center = map.GetMapCenter();
+  double total_solve = 0, total_update = 0;
+
+  for (int i = -1; i <= 1; ++i) {
+    for (int j = -1; j <= 1; ++j) {
+      const GeoPoint origin(center.longitude + Angle::Degrees(0.2 * i),
+                            center.latitude + Angle::Degrees(0.2 * j));
+      const GeoPoint moved = GeoVector(300, Angle::Zero()).EndPoint(origin);
+      const int ground = map.GetHeight(origin).GetValueOr0();
+
+      for (const int agl : {500, 1000, 2000}) {
+        const AGeoPoint aorigin(origin, ground + agl);
+        const AGeoPoint amoved(moved, ground + agl - 10);
+
+        const auto [solve, update] = Run(route, config, aorigin, amoved);
+        if (update < 0)
+          continue;
+
+        total_solve += solve;
+        total_update += update;
+        printf("%10.4f %10.4f %6d %10.2f %10.2f %6.2f\n",
+               origin.longitude.Degrees(), origin.latitude.Degrees(), agl,
+               solve, update, update / solve);
+      }
+    }
+  }
+
+  printf("total %33.2f %10.2f %6.2f\n",
+         total_solve, total_update, total_update / total_solve);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Measure the throughput of RasterBuffer::ScanLine() on a synthetic
+ * terrain buffer, with and without interpolation.
+ */
+
+#include "Terrain/RasterBuffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr unsigned WIDTH = 1024, HEIGHT = 1024;
+
+/**
+ * The number of samples per line; this is similar to what
+ * HeightMatrix::Fill() requests for one screen row.
+ */
+static constexpr unsigned LINE_SIZE = 64;
+
+static constexpr unsigned N_LINES = 200000;
+
+/**
+ * Each mode is measured this many times, and the best result is
+ * reported, to reduce the noise.
+ */
+static constexpr unsigned N_ROUNDS = 5;
+
+using Clock = std::chrono::steady_clock;
+
+static double
+Run(const RasterBuffer &buffer, const std::vector<RasterLocation> &points,
+    bool interpolate, long &checksum)
+{
+  TerrainHeight dest[LINE_SIZE];
+
+  double best = 0;
+  for (unsigned round = 0; round < N_ROUNDS; ++round) {
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i + 1 < points.size(); i += 2) {
+      buffer.ScanLine(points[i], points[i + 1], dest, LINE_SIZE,
+                      interpolate);
+      checksum += dest[0].GetValue() + dest[LINE_SIZE - 1].GetValue();
+    }
+
+    const std::chrono::duration<double> d = Clock::now() - start;
+    best = std::max(best, (points.size() / 2) * LINE_SIZE / d.count());
+  }
+
+  return best;
+}
+
+int
+main(int, char **)
+{
+  std::mt19937 rng(42);
+
+  RasterBuffer buffer(WIDTH, HEIGHT);
+  std::uniform_int_distribution<int> height(0, 3000);
+  auto *p = buffer.GetData();
+  for (unsigned i = 0; i < WIDTH * HEIGHT; ++i)
+    p[i] = TerrainHeight(height(rng));
+
+  /* short lines, so ScanLine() does not fall back to nearest
+     neighbour sampling */
+  const RasterLocation fine = buffer.GetFineSize();
+  const int max_delta = (LINE_SIZE - 1) << RasterTraits::SUBPIXEL_BITS;
+  std::uniform_int_distribution<unsigned> x(max_delta, fine.x - max_delta - 1);
+  std::uniform_int_distribution<unsigned> y(max_delta, fine.y - max_delta - 1);
+  std::uniform_int_distribution<int> delta(-max_delta + 1, max_delta - 1);
+
+  std::vector<RasterLocation> points;
+  points.reserve(2 * N_LINES);
+  for (unsigned i = 0; i < N_LINES; ++i) {
+    const RasterLocation a(x(rng), y(rng));
+    points.push_back(a);
+    points.emplace_back(a.x + delta(rng), a.y + delta(rng));
+  }
+
+  long checksum = 0;
+  printf("%-12s %14s\n", "mode", "samples/s");
+  printf("%-12s %14.0f\n", "nearest",
+         Run(buffer, points, false, checksum));
+  printf("%-12s %14.0f\n", "interpolate",
+         Run(buffer, points, true, checksum));
+  printf("checksum %ld\n", checksum);
+
+  return EXIT_SUCCESS;
+}
@@ -95,4 +95,6 @@ PrintHelper::print(const ContestResult& score)
   std::cout << "#   distance " << score.distance/1000. << " (km)\n";
   std::cout << "#   speed " << score.GetSpeed() * 3.6 << " (kph)\n";
   std::cout << "#   time " << score.time << " (sec)\n";
+  if (score.gap > 0)
+    std::cout << "#   gap " << score.gap * 100 << " (%)\n";
 }
@@ -0,0 +1,292 @@
+/*
+Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * A load generator for the xcsoar-cloud-server.  It simulates a
+ * gaggle of gliders circling around one spot and sends their
+ * SkyLines fix packets at a configurable rate.  Interleaved PING
+ * packets are used to estimate the server's packet loss.
+ */
+
+#include "Tracking/SkyLines/Assemble.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "net/Resolver.hxx"
+#include "net/AddressInfo.hxx"
+#include "net/SocketError.hxx"
+#include "net/UniqueSocketDescriptor.hxx"
+#include "system/Args.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/StringCompare.hxx"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static constexpr double EARTH_METRES_PER_DEGREE = 111195;
+
+/**
+ * Send one PING per this many fixes.
+ */
+static constexpr unsigned PING_INTERVAL = 100;
+
+struct Counters {
+  unsigned fixes = 0, pings = 0;
+  unsigned acks = 0, traffic = 0;
+};
+
+static UniqueSocketDescriptor
+CreateConnectUDP(SocketAddress address)
+{
+  UniqueSocketDescriptor s;
+  if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
+    throw MakeSocketError("Failed to create socket");
+
+  if (!s.Connect(address))
+    throw MakeSocketError("Failed to connect socket");
+
+  s.SetNonBlocking();
+
+  return s;
+}
+
+/**
+ * Calculate the location of the given simulated glider: each one
+ * flies a circle with its own radius and phase.
+ */
+static GeoPoint
+SimulatedLocation(GeoPoint center, unsigned i, double t)
+{
+  const double radius = 100 + (i % 64) * 150;
+  const double phase = i * 2.399963 + t * 0.25;
+
+  const double dlat = radius * cos(phase) / EARTH_METRES_PER_DEGREE;
+  const double dlon = radius * sin(phase)
+    / (EARTH_METRES_PER_DEGREE * center.latitude.cos());
+
+  return GeoPoint(center.longitude + Angle::Degrees(dlon),
+                  center.latitude + Angle::Degrees(dlat));
+}
+
+static SkyLinesTracking::FixPacket
+MakeSimulatedFix(uint64_t key, GeoPoint location, int altitude,
+                 double time)
+{
+  return SkyLinesTracking::MakeFix(key,
+                                   SkyLinesTracking::FixPacket::FLAG_LOCATION |
+                                   SkyLinesTracking::FixPacket::FLAG_ALTITUDE,
+                                   uint32_t(time * 1000),
+                                   location, Angle::Zero(), 0, 0,
+                                   altitude, 0, 0);
+}
+
+static void
+SendPacket(SocketDescriptor s, const void *data, size_t size)
+{
+  /* a full send buffer just drops the packet, like an overloaded
+     network would */
+  s.Write(data, size);
+}
+
+static void
+ReceiveAll(SocketDescriptor s, Counters &c)
+{
+  char buffer[4096];
+  ssize_t nbytes;
+  while ((nbytes = s.Read(buffer, sizeof(buffer))) >=
+         (ssize_t)sizeof(SkyLinesTracking::Header)) {
+    const auto &header = *(const SkyLinesTracking::Header *)buffer;
+    switch (FromBE16(header.type)) {
+    case SkyLinesTracking::ACK:
+      ++c.acks;
+      break;
+
+    case SkyLinesTracking::TRAFFIC_RESPONSE:
+      ++c.traffic;
+      break;
+    }
+  }
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv,
+            "[OPTIONS] HOST\n"
+            "Options:\n"
+            "  --clients=N      Number of simulated gliders (default 1000)\n"
+            "  --rate=N         Fix packets per second (default 10000)\n"
+            "  --duration=N     Seconds to run (default 10)\n"
+            "  --sockets=N      Number of source ports; SO_REUSEPORT servers\n"
+            "                   distribute by source port (default 16)\n"
+            "  --traffic        Each glider requests traffic, so the server\n"
+            "                   fans out every fix to its neighbours");
+
+  unsigned n_clients = 1000, rate = 10000, duration = 10, n_sockets = 16;
+  bool request_traffic = false;
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--clients=")) != nullptr)
+      n_clients = strtoul(value, nullptr, 10);
+    else if ((value = StringAfterPrefix(arg, "--rate=")) != nullptr)
+      rate = strtoul(value, nullptr, 10);
+    else if ((value = StringAfterPrefix(arg, "--duration=")) != nullptr)
+      duration = strtoul(value, nullptr, 10);
+    else if ((value = StringAfterPrefix(arg, "--sockets=")) != nullptr)
+      n_sockets = strtoul(value, nullptr, 10);
+    else if (StringIsEqual(arg, "--traffic"))
+      request_traffic = true;
+    else
+      args.UsageError();
+  }
+
+  const char *host = args.ExpectNext();
+  args.ExpectEnd();
+
+  if (n_clients == 0 || rate == 0 || n_sockets == 0)
+    args.UsageError();
+
+  const auto address_list = Resolve(host, 5597, 0, SOCK_DGRAM);
+
+  std::vector<UniqueSocketDescriptor> sockets;
+  for (unsigned i = 0; i < n_sockets; ++i)
+    sockets.emplace_back(CreateConnectUDP(address_list.front()));
+
+  const GeoPoint center(Angle::Degrees(11.5), Angle::Degrees(47.2));
+
+  /* keys must not be zero; spread them a bit to make the server's
+     hash table work */
+  const auto MakeKey = [](unsigned i){
+    return 0x1234567800000000ULL + i * 0x9e3779b1ULL + 1;
+  };
+
+  /* submit one fix per client first, so the server knows all of
+     them before they request traffic */
+  for (unsigned i = 0; i < n_clients; ++i) {
+    const auto packet =
+      MakeSimulatedFix(MakeKey(i), SimulatedLocation(center, i, 0),
+                       1500 + i % 500, 0);
+    SendPacket(sockets[i % n_sockets], &packet, sizeof(packet));
+  }
+
+  if (request_traffic) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    for (unsigned i = 0; i < n_clients; ++i) {
+      const auto packet =
+        SkyLinesTracking::MakeTrafficRequest(MakeKey(i), false, false, true);
+      SendPacket(sockets[i % n_sockets], &packet, sizeof(packet));
+    }
+  }
+
+  Counters total, second;
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto end = start + std::chrono::seconds(duration);
+  auto next_report = start + std::chrono::seconds(1);
+  uint64_t n_sent = 0;
+  unsigned next_client = 0;
+  uint16_t ping_id = 0;
+
+  while (true) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= end)
+      break;
+
+    const double elapsed = std::chrono::duration<double>(now - start).count();
+
+    for (auto &s : sockets)
+      ReceiveAll(s, second);
+
+    if (now >= next_report) {
+      printf("%u fixes/s  %u pings  %u acks  %u traffic responses\n",
+             second.fixes, second.pings, second.acks, second.traffic);
+
+      total.fixes += second.fixes;
+      total.pings += second.pings;
+      total.acks += second.acks;
+      total.traffic += second.traffic;
+      second = {};
+      next_report += std::chrono::seconds(1);
+    }
+
+    /* send as many packets as needed to catch up with the
+       configured rate */
+    const uint64_t due = uint64_t(elapsed * rate);
+    if (n_sent >= due) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      continue;
+    }
+
+    for (; n_sent < due; ++n_sent) {
+      const unsigned i = next_client;
+      next_client = (next_client + 1) % n_clients;
+
+      if (n_sent % PING_INTERVAL == 0) {
+        const auto ping = SkyLinesTracking::MakePing(MakeKey(i), ++ping_id);
+        SendPacket(sockets[i % n_sockets], &ping, sizeof(ping));
+        ++second.pings;
+      }
+
+      const auto packet =
+        MakeSimulatedFix(MakeKey(i), SimulatedLocation(center, i, elapsed),
+                         1500 + i % 500, elapsed);
+      SendPacket(sockets[i % n_sockets], &packet, sizeof(packet));
+      ++second.fixes;
+    }
+  }
+
+  /* wait for late responses */
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  for (auto &s : sockets)
+    ReceiveAll(s, second);
+
+  total.fixes += second.fixes;
+  total.pings += second.pings;
+  total.acks += second.acks;
+  total.traffic += second.traffic;
+
+  printf("total: %u fixes (%.0f/s), %u of %u pings answered (%.1f%% loss), "
+         "%u traffic responses\n",
+         total.fixes, double(total.fixes) / duration,
+         total.acks, total.pings,
+         total.pings > 0
+         ? 100. * (total.pings - std::min(total.acks, total.pings)) / total.pings
+         : 0.,
+         total.traffic);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
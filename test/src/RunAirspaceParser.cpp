@@ -22,21 +22,38 @@ Copyright_License {
 */
 
 #include "Airspace/AirspaceParser.hpp"
+#include "Airspace/AirspaceStore.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "system/Args.hpp"
 #include "io/FileLineReader.hpp"
+#include "io/FileOutputStream.hxx"
 #include "Operation/Operation.hpp"
 #include "util/PrintException.hxx"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include <stdio.h>
 #include <tchar.h>
 
+using Clock = std::chrono::steady_clock;
+
+static double
+ToMilliseconds(Clock::duration d)
+{
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
+  Args args(argc, argv, "PATH [STORE]");
   const auto path = args.ExpectNextPath();
+  const auto store_path = args.IsEmpty() ? nullptr : args.ExpectNextPath();
   args.ExpectEnd();
 
+  auto start = Clock::now();
+
   FileLineReader reader(path, Charset::AUTO);
 
   Airspaces airspaces;
@@ -49,6 +66,53 @@ try {
 
   airspaces.Optimise();
 
+  printf("parse: %u airspaces in %.2f ms\n",
+         airspaces.GetSize(), ToMilliseconds(Clock::now() - start));
+
+  {
+    const unsigned n_threads = std::max(std::thread::hardware_concurrency(),
+                                        2u);
+
+    start = Clock::now();
+
+    FileLineReader reader2(path, Charset::AUTO);
+
+    Airspaces parallel;
+    if (!ParseAirspaceFile(parallel, reader2, operation, n_threads)) {
+      fprintf(stderr, "Failed to parse input file\n");
+      return 1;
+    }
+
+    parallel.Optimise();
+
+    printf("parse (%u threads): %u airspaces in %.2f ms\n", n_threads,
+           parallel.GetSize(), ToMilliseconds(Clock::now() - start));
+
+    if (parallel.GetSize() != airspaces.GetSize()) {
+      fprintf(stderr, "Parallel parser does not match\n");
+      return 1;
+    }
+  }
+
+  if (store_path != nullptr) {
+    FileOutputStream os(store_path);
+    AirspaceStore::Save(os, 0, airspaces, 0);
+    os.Commit();
+
+    start = Clock::now();
+
+    Airspaces loaded;
+    AirspaceStore::Load(store_path, 0, loaded);
+
+    printf("load: %u airspaces in %.2f ms\n",
+           loaded.GetSize(), ToMilliseconds(Clock::now() - start));
+
+    if (loaded.GetSize() != airspaces.GetSize()) {
+      fprintf(stderr, "Store does not match input file\n");
+      return 1;
+    }
+  }
+
   printf("OK\n");
 
   return EXIT_SUCCESS;
@@ -0,0 +1,315 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Analyse many IGC files in parallel.  Each worker thread replays one
+ * flight after another through its own GlideComputer (without the
+ * calculations which only feed the user interface) and writes one
+ * JSON object per flight to stdout ("JSON lines").  The throughput is
+ * printed to stderr.
+ */
+
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "DebugReplayIGC.hpp"
+#include "Formatter/TimeFormatter.hpp"
+#include "JSON/Writer.hpp"
+#include "JSON/GeoWriter.hpp"
+#include "io/OutputStream.hxx"
+#include "io/BufferedOutputStream.hxx"
+#include "thread/Mutex.hxx"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "util/StringCompare.hxx"
+#include "util/PrintException.hxx"
+#include "util/RuntimeError.hxx"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* fake symbols: */
+
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void
+ConditionMonitorsUpdate(const NMEAInfo &basic, const DerivedInfo &calculated,
+                        const ComputerSettings &settings)
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent(const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent(const NMEAInfo &gps_info) {}
+void Logger::LogPoint(const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+/**
+ * Collects the JSON of one flight, which is then written to stdout
+ * in one piece.
+ */
+class StringOutputStream final : public OutputStream {
+  std::string value;
+
+public:
+  const std::string &GetValue() const noexcept {
+    return value;
+  }
+
+  /* virtual methods from class OutputStream */
+  void Write(const void *data, size_t size) override {
+    value.append((const char *)data, size);
+  }
+};
+
+static void
+WriteEvent(JSON::ObjectWriter &object, const char *name,
+           const MoreData &basic, double time, const GeoPoint &location)
+{
+  if (time < 0 || !basic.date_time_utc.IsDatePlausible())
+    return;
+
+  object.WriteElement(name, [&](BufferedOutputStream &writer){
+      JSON::ObjectWriter event(writer);
+
+      NarrowString<64> buffer;
+      FormatISO8601(buffer.buffer(), basic.GetDateTimeAt(time));
+      event.WriteElement("time", JSON::WriteString, buffer);
+
+      if (location.IsValid())
+        JSON::WriteGeoPointAttributes(event, location);
+    });
+}
+
+static void
+WriteContest(BufferedOutputStream &writer, const ContestResult &result)
+{
+  JSON::ObjectWriter object(writer);
+
+  object.WriteElement("score", JSON::WriteDouble, result.score);
+  object.WriteElement("distance", JSON::WriteDouble, result.distance);
+  object.WriteElement("duration", JSON::WriteUnsigned, (unsigned)result.time);
+  object.WriteElement("speed", JSON::WriteDouble, result.GetSpeed());
+}
+
+static void
+WriteFlight(BufferedOutputStream &writer, const char *path,
+            unsigned long n_fixes,
+            const MoreData &basic, const DerivedInfo &calculated)
+{
+  JSON::ObjectWriter object(writer);
+
+  object.WriteElement("file", JSON::WriteString, path);
+  object.WriteElement("fixes", JSON::WriteLong, (long)n_fixes);
+
+  const FlyingState &flight = calculated.flight;
+  WriteEvent(object, "takeoff", basic,
+             flight.takeoff_time, flight.takeoff_location);
+  WriteEvent(object, "release", basic,
+             flight.release_time, flight.release_location);
+  WriteEvent(object, "landing", basic,
+             flight.landing_time, flight.landing_location);
+  object.WriteElement("flight_time", JSON::WriteUnsigned,
+                      (unsigned)flight.flight_time);
+
+  if (calculated.circling_percentage >= 0)
+    object.WriteElement("circling_percentage", JSON::WriteDouble,
+                        calculated.circling_percentage);
+
+  const ContestResult &contest = calculated.contest_stats.GetResult();
+  if (contest.IsDefined())
+    object.WriteElement("contest", WriteContest, contest);
+}
+
+/**
+ * Replay one IGC file through a new GlideComputer instance.
+ *
+ * Throws if the file contains no fixes.
+ *
+ * @return the JSON line or an empty string if the file could not be
+ * opened
+ */
+static std::string
+AnalyseFlight(const char *path)
+{
+  std::unique_ptr<DebugReplay> replay(DebugReplayIGC::Create(Path(path)));
+  if (replay == nullptr)
+    return std::string();
+
+  const Waypoints waypoints;
+  Airspaces airspaces;
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+  settings.contest.enable = true;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, waypoints);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, waypoints, airspaces,
+                               protected_task_manager, task_events);
+  glide_computer.SetHeadless(true);
+  glide_computer.SetContestIncremental(false);
+  glide_computer.Initialise();
+
+  /* like the calculation thread: the idle calculations run at a
+     lower rate than ProcessGPS() */
+  unsigned long n_fixes = 0;
+  unsigned i = 0;
+  while (replay->Next()) {
+    glide_computer.ReadBlackboard(replay->Basic());
+    glide_computer.ProcessGPS();
+    ++n_fixes;
+
+    if (++i == 8) {
+      i = 0;
+      glide_computer.ProcessIdle();
+    }
+  }
+
+  replay.reset();
+
+  if (n_fixes == 0)
+    throw FormatRuntimeError("No fixes in %s", path);
+
+  glide_computer.ProcessExhaustive();
+
+  StringOutputStream sos;
+  BufferedOutputStream writer(sos);
+  WriteFlight(writer, path, n_fixes,
+              glide_computer.Basic(), glide_computer.Calculated());
+  writer.Write('\n');
+  writer.Flush();
+  return sos.GetValue();
+}
+
+struct Batch {
+  const std::vector<const char *> &paths;
+
+  std::atomic_size_t next{0};
+  std::atomic_uint n_failed{0};
+
+  Mutex output_mutex;
+
+  explicit Batch(const std::vector<const char *> &_paths) noexcept
+    :paths(_paths) {}
+
+  void Run() noexcept {
+    std::size_t i;
+    while ((i = next.fetch_add(1)) < paths.size()) {
+      std::string line;
+      try {
+        line = AnalyseFlight(paths[i]);
+      } catch (...) {
+        PrintException(std::current_exception());
+      }
+
+      if (line.empty()) {
+        fprintf(stderr, "Failed to analyse %s\n", paths[i]);
+        ++n_failed;
+        continue;
+      }
+
+      const std::lock_guard<Mutex> lock(output_mutex);
+      fwrite(line.data(), 1, line.length(), stdout);
+    }
+  }
+};
+
+int
+main(int argc, char **argv)
+{
+  unsigned n_jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+  Args args(argc, argv,
+            "[--jobs=N] FILE.igc ...\n"
+            "Options:\n"
+            "  --jobs=N   Number of worker threads (default = number of CPUs)");
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--jobs=")) != nullptr) {
+      n_jobs = strtoul(value, nullptr, 10);
+      if (n_jobs == 0) {
+        fputs("The jobs parameter could not be parsed correctly.\n", stderr);
+        args.UsageError();
+      }
+    } else
+      args.UsageError();
+  }
+
+  std::vector<const char *> paths;
+  paths.push_back(args.ExpectNext());
+  while (!args.IsEmpty())
+    paths.push_back(args.GetNext());
+
+  n_jobs = std::min<std::size_t>(n_jobs, paths.size());
+
+  Batch batch(paths);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < n_jobs; ++i)
+    threads.emplace_back([&batch](){ batch.Run(); });
+
+  batch.Run();
+
+  for (auto &t : threads)
+    t.join();
+
+  const std::chrono::duration<double> duration =
+    std::chrono::steady_clock::now() - start;
+  const std::size_t n_flights = paths.size() - batch.n_failed;
+  fprintf(stderr, "%zu flights in %.2f s with %u threads: %.2f flights/s\n",
+          n_flights, duration.count(), n_jobs,
+          n_flights / duration.count());
+
+  return batch.n_failed > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
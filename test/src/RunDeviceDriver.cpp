@@ -34,7 +34,12 @@ Copyright_License {
 #include "util/ConvertString.hpp"
 #include "util/StringStrip.hxx"
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include <stdio.h>
+#include <stdlib.h>
 
 const struct DeviceRegister *driver;
 
@@ -181,7 +186,9 @@ Dump(const NMEAInfo &basic)
 int main(int argc, char **argv)
 {
   NarrowString<1024> usage;
-  usage = "DRIVER\n\n"
+  usage = "DRIVER [ROUNDS]\n\n"
+          "If ROUNDS is given, the input is parsed that many times, and\n"
+          "the throughput is printed to stderr.\n\n"
           "Where DRIVER is one of:";
   {
     const DeviceRegister *driver;
@@ -193,6 +200,7 @@ int main(int argc, char **argv)
 
   Args args(argc, argv, usage);
   tstring driver_name = args.ExpectNextT();
+  const unsigned rounds = args.IsEmpty() ? 0 : atoi(args.GetNext());
   args.ExpectEnd();
 
   driver = FindDriverByName(driver_name.c_str());
@@ -214,14 +222,41 @@ int main(int argc, char **argv)
   NMEAInfo data;
   data.Reset();
 
+  std::vector<std::string> lines;
+  std::size_t n_bytes = 0;
+
   char buffer[1024];
   while (fgets(buffer, sizeof(buffer), stdin) != nullptr) {
     StripRight(buffer);
 
+    if (rounds > 0) {
+      /* benchmark mode: parse from memory later */
+      lines.emplace_back(buffer);
+      n_bytes += lines.back().length() + 1;
+      continue;
+    }
+
     if (device == nullptr || !device->ParseNMEA(buffer, data))
       parser.ParseLine(buffer, data);
   }
 
+  if (rounds > 0) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned i = 0; i < rounds; ++i) {
+      for (const auto &line : lines)
+        if (device == nullptr || !device->ParseNMEA(line.c_str(), data))
+          parser.ParseLine(line.c_str(), data);
+    }
+
+    const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start;
+    const double n_lines = double(lines.size()) * rounds;
+    fprintf(stderr, "%.0f lines in %.3f s: %.0f lines/s, %.1f MB/s\n",
+            n_lines, duration.count(), n_lines / duration.count(),
+            double(n_bytes) * rounds / duration.count() / (1024 * 1024));
+  }
+
   Dump(data);
 
   return EXIT_SUCCESS;
@@ -34,6 +34,8 @@ Copyright_License {
 #include "Operation/Operation.hpp"
 #include "TestUtil.hpp"
 
+#include <algorithm>
+
 #include <tchar.h>
 
 struct AirspaceClassTestCouple
@@ -43,13 +45,13 @@ struct AirspaceClassTestCouple
 };
 
 static bool
-ParseFile(Path path, Airspaces &airspaces)
+ParseFile(Path path, Airspaces &airspaces, unsigned n_threads=1)
 {
   FileLineReader reader(path, Charset::AUTO);
 
   NullOperationEnvironment operation;
 
-  if (!ok1(ParseAirspaceFile(airspaces, reader, operation)))
+  if (!ok1(ParseAirspaceFile(airspaces, reader, operation, n_threads)))
     return false;
 
   airspaces.Optimise();
@@ -272,12 +274,68 @@ TestTNP()
   }
 }
 
+static bool
+Equals(const AirspaceAltitude &a, const AirspaceAltitude &b)
+{
+  return a.reference == b.reference && a.altitude == b.altitude &&
+    a.flight_level == b.flight_level &&
+    a.altitude_above_terrain == b.altitude_above_terrain;
+}
+
+static bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b)
+{
+  if (a.GetShape() != b.GetShape() ||
+      !StringIsEqual(a.GetName(), b.GetName()) ||
+      a.GetType() != b.GetType() ||
+      !Equals(a.GetBase(), b.GetBase()) ||
+      !Equals(a.GetTop(), b.GetTop()) ||
+      a.GetRadioText() != b.GetRadioText() ||
+      !a.GetDays().equals(b.GetDays()))
+    return false;
+
+  const SearchPointVector &pa = a.GetPoints(), &pb = b.GetPoints();
+  if (pa.size() != pb.size())
+    return false;
+
+  for (std::size_t i = 0; i < pa.size(); ++i)
+    if (pa[i].GetLocation() != pb[i].GetLocation())
+      return false;
+
+  return true;
+}
+
+/**
+ * The parallel OpenAir parser must produce the same airspaces in the
+ * same order as the serial one.
+ */
+static void
+TestParallel()
+{
+  const Path path(_T("test/data/AirspaceAus-DAA.txt"));
+
+  Airspaces serial, parallel;
+  if (!ParseFile(path, serial) || !ParseFile(path, parallel, 4)) {
+    skip(2, 0, "Failed to parse input file");
+    return;
+  }
+
+  ok1(serial.GetSize() == parallel.GetSize());
+
+  const auto a = serial.QueryAll(), b = parallel.QueryAll();
+  ok1(std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                 [](const Airspace &x, const Airspace &y){
+                   return Equals(x.GetAirspace(), y.GetAirspace());
+                 }));
+}
+
 int main(int argc, char **argv)
 try {
-  plan_tests(102);
+  plan_tests(106);
 
   TestOpenAir();
   TestTNP();
+  TestParallel();
 
   return exit_status();
 } catch (const std::runtime_error &e) {
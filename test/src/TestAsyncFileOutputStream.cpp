@@ -0,0 +1,207 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "io/AsyncFileOutputStream.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/FileReader.hxx"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <string>
+#include <thread>
+
+#include <stdio.h>
+
+static const Path path(_T("output/test/TestAsyncFileOutputStream.txt"));
+
+/**
+ * A sync interval which is never reached while a test runs.
+ */
+static constexpr std::chrono::steady_clock::duration NEVER =
+  std::chrono::hours(1);
+
+static std::string
+ReadFile()
+{
+  FileReader reader(path);
+
+  std::string result;
+  char buffer[4096];
+  std::size_t n;
+  while ((n = reader.Read(buffer, sizeof(buffer))) > 0)
+    result.append(buffer, n);
+
+  return result;
+}
+
+static void
+TestTryWrite()
+{
+  const std::string a(600, 'a'), b(399, 'b');
+
+  FileOutputStream file(path, FileOutputStream::Mode::CREATE_VISIBLE);
+
+  {
+    AsyncFileOutputStream os(file, 1000, NEVER);
+
+    /* the first sync is due immediately; after this Flush(), the
+       writer thread does not take any data until the next Flush()
+       or until the buffer is full */
+    os.Write("x", 1);
+    os.Flush();
+    ok1(ReadFile() == "x");
+
+    ok1(os.TryWrite(a.data(), a.size()));
+    ok1(os.GetDroppedBytes() == 0);
+
+    /* not enough room: discarded as a whole */
+    ok1(!os.TryWrite(a.data(), a.size()));
+    ok1(os.GetDroppedBytes() == a.size());
+
+    /* this leaves room for one byte */
+    ok1(os.TryWrite(b.data(), b.size()));
+    ok1(!os.TryWrite("cc", 2));
+    ok1(os.GetDroppedBytes() == a.size() + 2);
+    ok1(ReadFile() == "x");
+
+    os.Flush();
+    ok1(ReadFile() == "x" + a + b);
+
+    /* there is room again */
+    ok1(os.TryWrite("d", 1));
+    ok1(os.GetDroppedBytes() == a.size() + 2);
+  }
+
+  file.Commit();
+  ok1(ReadFile() == "x" + a + b + "d");
+}
+
+static constexpr unsigned N_RECORDS = 5000;
+
+/**
+ * The size of one record written by WriteRecords().  The capacity
+ * is a multiple of this, so Write() never has to split a record,
+ * and records of the two threads cannot be mixed.
+ */
+static constexpr std::size_t RECORD_SIZE = 8;
+
+static void
+WriteRecords(AsyncFileOutputStream &os, char name)
+{
+  for (unsigned i = 0; i < N_RECORDS; ++i) {
+    char record[RECORD_SIZE + 1];
+    snprintf(record, sizeof(record), "%c%06u\n", name, i);
+    os.Write(record, RECORD_SIZE);
+
+    if (i % 97 == 0)
+      os.Flush();
+  }
+
+  os.Flush();
+}
+
+/**
+ * Check that the file contains all records of both threads, each in
+ * order.
+ */
+static bool
+CheckRecords(const std::string &contents)
+{
+  if (contents.size() != 2 * N_RECORDS * RECORD_SIZE)
+    return false;
+
+  unsigned next_a = 0, next_b = 0;
+  for (std::size_t i = 0; i < contents.size(); i += RECORD_SIZE) {
+    unsigned &next = contents[i] == 'a' ? next_a : next_b;
+
+    char expected[RECORD_SIZE + 1];
+    snprintf(expected, sizeof(expected), "%c%06u\n",
+             contents[i] == 'a' ? 'a' : 'b', next++);
+    if (contents.compare(i, RECORD_SIZE, expected) != 0)
+      return false;
+  }
+
+  return next_a == N_RECORDS && next_b == N_RECORDS;
+}
+
+static void
+TestThreads()
+{
+  FileOutputStream file(path, FileOutputStream::Mode::CREATE_VISIBLE);
+
+  {
+    AsyncFileOutputStream os(file, 32 * RECORD_SIZE);
+
+    std::thread a(WriteRecords, std::ref(os), 'a');
+    std::thread b(WriteRecords, std::ref(os), 'b');
+    a.join();
+    b.join();
+
+    /* everything was flushed by the threads */
+    ok1(CheckRecords(ReadFile()));
+    ok1(os.GetDroppedBytes() == 0);
+  }
+
+  file.Commit();
+  ok1(CheckRecords(ReadFile()));
+}
+
+static void
+TestDestructor()
+{
+  std::string expected = "x";
+  for (unsigned i = 0; i < 300; ++i)
+    expected.append("0123456789");
+
+  FileOutputStream file(path, FileOutputStream::Mode::CREATE_VISIBLE);
+
+  {
+    AsyncFileOutputStream os(file, 64 * 1024, NEVER);
+    os.Write("x", 1);
+    os.Flush();
+
+    /* less than a batch: stays pending until the destructor */
+    os.Write(expected.data() + 1, expected.size() - 1);
+    ok1(ReadFile() == "x");
+  }
+
+  ok1(ReadFile() == expected);
+
+  file.Commit();
+  ok1(ReadFile() == expected);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(19);
+
+  Directory::Create(Path(_T("output/test")));
+
+  TestTryWrite();
+  TestThreads();
+  TestDestructor();
+
+  File::Delete(path);
+
+  return exit_status();
+}
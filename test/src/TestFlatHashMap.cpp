@@ -0,0 +1,167 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "util/FlatHashMap.hpp"
+#include "TestUtil.hpp"
+
+#include <map>
+#include <random>
+
+/* unlike with std::unordered_map, iterators do not point to a
+   value_type, but the key cannot be modified through them either */
+static_assert(std::is_same_v<FlatHashMap<unsigned, unsigned>::value_type,
+                             std::pair<const unsigned, unsigned>>);
+static_assert(std::is_same_v<decltype(FlatHashMap<unsigned, unsigned>::iterator()->first),
+                             const unsigned &>);
+
+/**
+ * A bad hash function, to provoke collisions.
+ */
+struct BadHash {
+  std::size_t operator()(unsigned key) const noexcept {
+    return key & 0xff;
+  }
+};
+
+template<typename Map>
+static bool
+CompareWith(const Map &map, const std::map<unsigned, unsigned> &reference)
+{
+  if (map.size() != reference.size())
+    return false;
+
+  for (const auto &[key, value] : reference) {
+    const auto i = map.find(key);
+    if (i == map.end() || i->first != key || i->second != value)
+      return false;
+  }
+
+  /* iteration visits each element exactly once */
+  std::size_t n = 0;
+  for (const auto &i : map) {
+    const auto r = reference.find(i.first);
+    if (r == reference.end() || r->second != i.second)
+      return false;
+    ++n;
+  }
+
+  return n == reference.size();
+}
+
+template<typename Map>
+static void
+TestRandom()
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<unsigned> keys(0, 5000);
+
+  Map map;
+  std::map<unsigned, unsigned> reference;
+
+  /* an iterator must survive growing the map */
+  const auto first = map.insert({12345678, 1}).first;
+  reference.emplace(12345678, 1);
+
+  bool inserted_ok = true;
+  for (unsigned i = 0; i < 3000; ++i) {
+    const unsigned key = keys(rng);
+    const auto [it, inserted] = map.insert({key, i});
+    const bool expected = reference.emplace(key, i).second;
+    inserted_ok = inserted_ok && inserted == expected && it->first == key;
+  }
+
+  ok1(inserted_ok);
+  ok1(first->first == 12345678 && first->second == 1);
+  ok1(CompareWith(map, reference));
+  ok1(map.find(5001) == map.end());
+
+  /* a copy is independent of the original */
+  Map copy = map;
+  copy.find(12345678)->second = 2;
+  ok1(map.find(12345678)->second == 1);
+  ok1(CompareWith(copy, [&]{
+        auto r = reference;
+        r[12345678] = 2;
+        return r;
+      }()));
+
+  map.clear();
+  ok1(map.empty());
+  ok1(map.find(12345678) == map.end());
+  ok1(map.begin() == map.end());
+
+  /* reuse after clear() */
+  reference.clear();
+  for (unsigned i = 0; i < 100; ++i) {
+    map.emplace(i * 7, i);
+    reference.emplace(i * 7, i);
+  }
+
+  ok1(CompareWith(map, reference));
+}
+
+template<typename Map>
+static void
+TestErase()
+{
+  std::mt19937 rng(43);
+  std::uniform_int_distribution<unsigned> keys(0, 2000);
+
+  Map map;
+  std::map<unsigned, unsigned> reference;
+
+  ok1(map.erase(1) == 0);
+
+  bool erased_ok = true;
+  for (unsigned i = 0; i < 20000; ++i) {
+    const unsigned key = keys(rng);
+    if (i % 3 == 0) {
+      erased_ok = erased_ok && map.erase(key) == reference.erase(key);
+    } else {
+      map.emplace(key, i);
+      reference.emplace(key, i);
+    }
+  }
+
+  ok1(erased_ok);
+  ok1(CompareWith(map, reference));
+
+  /* erase everything */
+  for (const auto &i : reference)
+    erased_ok = erased_ok && map.erase(i.first) == 1;
+
+  ok1(erased_ok);
+  ok1(map.empty());
+  ok1(map.find(reference.begin()->first) == map.end());
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(32);
+
+  TestRandom<FlatHashMap<unsigned, unsigned>>();
+  TestRandom<FlatHashMap<unsigned, unsigned, BadHash>>();
+  TestErase<FlatHashMap<unsigned, unsigned>>();
+  TestErase<FlatHashMap<unsigned, unsigned, BadHash>>();
+
+  return exit_status();
+}
@@ -0,0 +1,182 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Cloud/GridIndex.hpp"
+#include "TestUtil.hpp"
+
+#include <set>
+
+struct TestObject : GeoGridHook {
+  unsigned id;
+  GeoPoint location;
+
+  TestObject(unsigned _id, GeoPoint _location) noexcept
+    :id(_id), location(_location) {}
+};
+
+using TestObjectPtr = std::shared_ptr<TestObject>;
+
+struct TestObjectIndexable {
+  typedef GeoPoint result_type;
+
+  [[gnu::pure]]
+  result_type operator()(const TestObjectPtr &object) const {
+    return object->location;
+  }
+};
+
+using TestIndex = GeoGridIndex<TestObject, TestObjectIndexable>;
+
+static TestObjectPtr
+Insert(TestIndex &index, unsigned id, double longitude, double latitude)
+{
+  auto object = std::make_shared<TestObject>(id,
+                                             GeoPoint(Angle::Degrees(longitude),
+                                                      Angle::Degrees(latitude)));
+  index.insert(object);
+  return object;
+}
+
+/**
+ * Returns the ids of all objects returned by
+ * GeoGridIndex::QueryWithinRange().  Duplicates are counted, so they
+ * make the result differ from a std::set.
+ */
+static std::multiset<unsigned>
+Query(const TestIndex &index, double longitude, double latitude,
+      double range)
+{
+  std::multiset<unsigned> result;
+  for (const auto &i : index.QueryWithinRange(GeoPoint(Angle::Degrees(longitude),
+                                                       Angle::Degrees(latitude)),
+                                              range))
+    result.insert(i->id);
+  return result;
+}
+
+static bool
+Equals(const std::multiset<unsigned> &result,
+       std::initializer_list<unsigned> expected)
+{
+  return result == std::multiset<unsigned>(expected);
+}
+
+static void
+TestAntimeridian()
+{
+  TestIndex index;
+  Insert(index, 1, 179.9, 10);
+  Insert(index, 2, -179.95, 10);
+  Insert(index, 3, -179.9, 10.05);
+  Insert(index, 4, -179.8, 10);
+  Insert(index, 5, 179.7, 10);
+  Insert(index, 6, -179.95, 10.25);
+  Insert(index, 7, 0, 10);
+  Insert(index, 8, -179.95, -10);
+  Insert(index, 9, 180, 10);
+
+  /* 20 km is 0.18 degrees latitude and 0.183 degrees longitude at
+     10 degrees north */
+  ok1(Equals(Query(index, 179.95, 10, 20000), {1, 2, 3, 9}));
+  ok1(Equals(Query(index, -179.95, 10, 20000), {1, 2, 3, 4, 9}));
+  ok1(Equals(Query(index, 179.8, 10, 20000), {1, 5}));
+  ok1(Equals(Query(index, -179.95, -10, 20000), {8}));
+}
+
+static void
+TestPole()
+{
+  TestIndex index;
+  Insert(index, 1, 10, 89.9);
+  Insert(index, 2, -170, 89.9);
+  Insert(index, 3, 100, 89.8);
+  Insert(index, 4, 0, 90);
+  Insert(index, 5, 10, 89.5);
+  Insert(index, 6, -170, 89.5);
+  Insert(index, 7, -45, -89.95);
+  Insert(index, 8, 135, -89.95);
+  Insert(index, 9, 135, -89.5);
+
+  /* the range includes the pole, so it covers all longitudes */
+  ok1(Equals(Query(index, 10, 89.9, 30000), {1, 2, 3, 4}));
+  ok1(Equals(Query(index, -45, -89.95, 20000), {7, 8}));
+
+  /* the range only touches the pole */
+  ok1(Equals(Query(index, -170, 89.8, 22300), {1, 2, 3, 4}));
+
+  ok1(Equals(Query(index, 10, 89.5, 20000), {5}));
+}
+
+static void
+TestMove()
+{
+  TestIndex index;
+
+  /* the default cell size is 0.25 degrees, i.e. there is a cell
+     boundary at 10.25 degrees east */
+  auto a = Insert(index, 1, 10.24, 45);
+  Insert(index, 2, 10.245, 45);
+  auto c = Insert(index, 3, 10.23, 45);
+  Insert(index, 4, 10.27, 45);
+  ok1(index.size() == 4);
+
+  ok1(Equals(Query(index, 10.24, 45, 1000), {1, 2, 3}));
+  ok1(Equals(Query(index, 10.26, 45, 1000), {4}));
+
+  /* move the first object of the cell across the boundary */
+  index.remove(a);
+  a->location.longitude = Angle::Degrees(10.26);
+  index.insert(a);
+  ok1(index.size() == 4);
+
+  ok1(Equals(Query(index, 10.24, 45, 1000), {2, 3}));
+  ok1(Equals(Query(index, 10.26, 45, 1000), {1, 4}));
+  ok1(Equals(Query(index, 10.2, 45, 1000), {}));
+
+  /* the object which was moved into the gap can still be removed */
+  index.remove(c);
+  ok1(index.size() == 3);
+  ok1(Equals(Query(index, 10.24, 45, 1000), {2}));
+
+  /* move it back */
+  index.remove(a);
+  a->location.longitude = Angle::Degrees(10.24);
+  index.insert(a);
+  ok1(index.size() == 3);
+  ok1(Equals(Query(index, 10.24, 45, 1000), {1, 2}));
+  ok1(Equals(Query(index, 10.265, 45, 500), {4}));
+
+  index.clear();
+  ok1(index.empty());
+  ok1(Equals(Query(index, 10.24, 45, 1000), {}));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(22);
+
+  TestAntimeridian();
+  TestPole();
+  TestMove();
+
+  return exit_status();
+}
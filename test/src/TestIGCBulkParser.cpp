@@ -0,0 +1,161 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "IGC/IGCBulkParser.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "IGC/IGCFix.hpp"
+#include "time/BrokenTime.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <string.h>
+#include <tchar.h>
+
+static const char *const input_lines[] = {
+  "AXCSfoo",
+  "HFDTE040910",
+  "I033638ENL3941GSP4243SIU",
+  "B1122385103117N00742367EA004900048700112301",
+  "B1122395103117S00742367WV-001200487",
+  "B1122405103117N00742367EA0049000487 9",
+  /* not the standard layout, but accepted by IGCParseFix() */
+  "B1122415103117N00742367EA+049000487",
+  "B1122425103117N00742367XA0049000487",
+  "B1122435103117N00742367EA004900048700112301\r",
+  "LXCS comment",
+};
+
+/**
+ * Parse #input_lines one by one with IGCParseFix(), like the
+ * line-based code does.
+ */
+static unsigned
+ParseReference(IGCFix *fixes)
+{
+  IGCExtensions extensions;
+  extensions.clear();
+
+  unsigned n = 0;
+  char buffer[64];
+  for (const char *line : input_lines) {
+    strcpy(buffer, line);
+    char *cr = strchr(buffer, '\r');
+    if (cr != nullptr)
+      *cr = 0;
+
+    if (buffer[0] == 'I')
+      IGCParseExtensions(buffer, extensions);
+    else if (IGCParseFix(buffer, extensions, fixes[n]))
+      ++n;
+  }
+
+  return n;
+}
+
+static bool
+Equals(const IGCFix &a, const IGCFix &b)
+{
+  return a.time == b.time &&
+    a.location.latitude.Native() == b.location.latitude.Native() &&
+    a.location.longitude.Native() == b.location.longitude.Native() &&
+    a.gps_valid == b.gps_valid &&
+    a.gps_altitude == b.gps_altitude &&
+    a.pressure_altitude == b.pressure_altitude &&
+    a.enl == b.enl && a.gsp == b.gsp && a.siu == b.siu &&
+    a.rpm == b.rpm;
+}
+
+static void
+TestFile()
+{
+  Directory::Create(Path(_T("output/test")));
+
+  const Path empty_path(_T("output/test/empty.igc"));
+  File::Delete(empty_path);
+  File::CreateExclusive(empty_path);
+
+  /* an empty file is not an error, it just has no fixes */
+  IGCFixColumns columns;
+  bool success = true;
+  try {
+    IGCParseFixes(empty_path, columns);
+  } catch (...) {
+    success = false;
+  }
+
+  ok1(success && columns.empty());
+  File::Delete(empty_path);
+
+  /* a missing file is */
+  success = false;
+  try {
+    IGCParseFixes(Path(_T("output/test/does_not_exist.igc")), columns);
+  } catch (...) {
+    success = true;
+  }
+
+  ok1(success);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(18);
+
+  std::string input;
+  for (const char *line : input_lines) {
+    input.append(line);
+    input.push_back('\n');
+  }
+
+  IGCFixColumns columns;
+  IGCParseFixes(input.data(), input.data() + input.length(), columns);
+
+  IGCFix expected[8];
+  const unsigned n = ParseReference(expected);
+  ok1(n == 5);
+  ok1(columns.size() == n);
+
+  ok1(columns.date == BrokenDate(2010, 9, 4));
+
+  /* declared extensions get a column, the others stay empty */
+  ok1(columns.enl.size() == n);
+  ok1(columns.gsp.size() == n);
+  ok1(columns.siu.size() == n);
+  ok1(columns.rpm.empty());
+
+  ok1(columns.time[0] == 11 * 3600 + 22 * 60 + 38);
+  ok1(columns.pressure_altitude[1] == -12);
+  ok1(columns.enl[0] == 1);
+  ok1(columns.siu[0] == 1);
+
+  for (unsigned i = 0; i < n && i < columns.size(); ++i) {
+    IGCFix fix;
+    columns.Get(i, fix);
+    ok(Equals(fix, expected[i]), "fix %u", i);
+  }
+
+  TestFile();
+
+  return exit_status();
+}
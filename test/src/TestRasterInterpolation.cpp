@@ -0,0 +1,144 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/RasterBuffer.hpp"
+#include "Math/FastMath.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <random>
+
+/**
+ * The reference implementation: one division and one
+ * GetInterpolated() call per sample.
+ */
+static void
+ReferenceScanLine(const RasterBuffer &buffer,
+                  RasterLocation a, RasterLocation b,
+                  TerrainHeight *dest, unsigned size)
+{
+  --size;
+  const IntPoint2D d(b.x - a.x, b.y - a.y);
+  for (int i = 0; (unsigned)i <= size; ++i) {
+    unsigned cx = a.x + (i * d.x) / (int)size;
+    unsigned cy = a.y + (i * d.y) / (int)size;
+
+    const unsigned ix = CombinedDivAndMod(cx);
+    const unsigned iy = CombinedDivAndMod(cy);
+
+    *dest++ = buffer.GetInterpolated(cx, cy, ix, iy);
+  }
+}
+
+/**
+ * The reference implementation without interpolation.
+ */
+static void
+ReferenceScanLineNearest(const RasterBuffer &buffer,
+                         RasterLocation a, RasterLocation b,
+                         TerrainHeight *dest, unsigned size)
+{
+  --size;
+  const IntPoint2D d(b.x - a.x, b.y - a.y);
+  for (int i = 0; (unsigned)i <= size; ++i) {
+    const RasterLocation c(a.x + (i * d.x) / (int)size,
+                           a.y + (i * d.y) / (int)size);
+    *dest++ = buffer.Get(c >> RasterTraits::SUBPIXEL_BITS);
+  }
+}
+
+static bool
+Equals(const TerrainHeight *a, const TerrainHeight *b, unsigned size)
+{
+  for (unsigned i = 0; i < size; ++i)
+    if (a[i].GetValue() != b[i].GetValue())
+      return false;
+
+  return true;
+}
+
+static unsigned
+Clamp(int value, unsigned size)
+{
+  return value < 0 ? 0 : std::min(unsigned(value), size - 1);
+}
+
+static constexpr unsigned N_LINES = 200;
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 * N_LINES);
+
+  std::mt19937 random(42);
+
+  RasterBuffer buffer(97, 61);
+  std::uniform_int_distribution<int> height(-500, 3000);
+  std::uniform_int_distribution<int> special(0, 20);
+  auto *p = buffer.GetData();
+  for (unsigned i = 0; i < 97 * 61; ++i)
+    /* sprinkle some water and invalid values */
+    p[i] = special(random) == 0
+      ? TerrainHeight::Invalid()
+      : (special(random) == 0
+         ? TerrainHeight(-31000)
+         : TerrainHeight(height(random)));
+
+  const RasterLocation fine = buffer.GetFineSize();
+  std::uniform_int_distribution<unsigned> fx(0, fine.x - 1);
+  std::uniform_int_distribution<unsigned> fy(0, fine.y - 1);
+
+  TerrainHeight result[64], expected[64];
+
+  for (unsigned i = 0; i < N_LINES; ++i) {
+    const unsigned size = 2 + i % 63;
+
+    /* keep the line short enough to be interpolated, see
+       RasterBuffer::ScanLine() */
+    const int max_delta = (size - 1) << RasterTraits::SUBPIXEL_BITS;
+    std::uniform_int_distribution<int> delta(-max_delta + 1, max_delta - 1);
+
+    const RasterLocation a(fx(random), fy(random));
+
+    /* a diagonal line */
+    RasterLocation b(Clamp(int(a.x) + delta(random), fine.x),
+                     Clamp(int(a.y) + delta(random), fine.y));
+    if (b.y == a.y)
+      b.y = a.y > 0 ? a.y - 1 : a.y + 1;
+
+    buffer.ScanLine(a, b, result, size, true);
+    ReferenceScanLine(buffer, a, b, expected, size);
+    ok1(Equals(result, expected, size));
+
+    /* a horizontal line */
+    const RasterLocation c(Clamp(int(a.x) + delta(random), fine.x), a.y);
+    buffer.ScanLine(a, c, result, size, true);
+    ReferenceScanLine(buffer, a, c, expected, size);
+    ok1(Equals(result, expected, size));
+
+    /* a diagonal line without interpolation */
+    buffer.ScanLine(a, b, result, size, false);
+    ReferenceScanLineNearest(buffer, a, b, expected, size);
+    ok1(Equals(result, expected, size));
+  }
+
+  return exit_status();
+}
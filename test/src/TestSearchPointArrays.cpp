@@ -0,0 +1,170 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Geo/SearchPointArrays.hpp"
+#include "Geo/SearchPointVector.hpp"
+#include "Geo/Flat/FlatProjection.hpp"
+#include "TestUtil.hpp"
+
+#include <random>
+#include <vector>
+
+static constexpr unsigned N_POLYGONS = 100;
+static constexpr unsigned N_QUERIES = 200;
+
+/**
+ * Generate a random, closed, star-shaped (but usually not convex)
+ * polygon.
+ */
+static SearchPointVector
+MakePolygon(std::mt19937 &random, const GeoPoint &center, unsigned n,
+            const FlatProjection &projection)
+{
+  std::uniform_real_distribution<double> radius(0.01, 0.2);
+
+  SearchPointVector border;
+  for (unsigned i = 0; i < n; ++i) {
+    const Angle angle = Angle::FullCircle() * (double(i) / n);
+    const double r = radius(random);
+    border.emplace_back(GeoPoint(center.longitude + Angle::Degrees(r * angle.cos()),
+                                 center.latitude + Angle::Degrees(r * angle.sin())),
+                        projection);
+  }
+
+  border.emplace_back(border.front());
+  return border;
+}
+
+static bool
+CheckInside(const SearchPointArrays &arrays, const SearchPointVector &border,
+            const std::vector<GeoPoint> &queries)
+{
+  for (const GeoPoint &p : queries)
+    if (arrays.IsInside(p) != border.IsInside(p))
+      return false;
+
+  return true;
+}
+
+static bool
+CheckNearestPoint(const SearchPointArrays &arrays,
+                  const SearchPointVector &border,
+                  const std::vector<GeoPoint> &queries,
+                  const FlatProjection &projection)
+{
+  for (const GeoPoint &p : queries) {
+    const FlatGeoPoint f = projection.ProjectInteger(p);
+    if (!(arrays.NearestPoint(f) == border.NearestPoint(f)))
+      return false;
+  }
+
+  return true;
+}
+
+static bool
+CheckIntersections(const SearchPointArrays &arrays,
+                   const SearchPointVector &border,
+                   const std::vector<GeoPoint> &queries,
+                   const FlatProjection &projection)
+{
+  for (unsigned i = 0; i + 1 < queries.size(); ++i) {
+    const FlatRay ray(projection.ProjectInteger(queries[i]),
+                      projection.ProjectInteger(queries[i + 1]));
+
+    /* the loop from AirspacePolygon::Intersects() */
+    std::vector<double> expected;
+    for (auto it = border.begin(); it + 1 != border.end(); ++it) {
+      const FlatRay segment(it->GetFlatLocation(),
+                            (it + 1)->GetFlatLocation());
+      const double t = ray.DistinctIntersection(segment);
+      if (t >= 0)
+        expected.push_back(t);
+    }
+
+    std::vector<double> result;
+    arrays.VisitIntersections(ray, [&result](double t){
+      result.push_back(t);
+    });
+
+    if (result != expected)
+      return false;
+  }
+
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(3 * N_POLYGONS + 1);
+
+  std::mt19937 random(42);
+
+  const GeoPoint center(Angle::Degrees(8.5), Angle::Degrees(47.2));
+  const FlatProjection projection(center);
+
+  /* small polygons are left to the scalar code */
+  {
+    SearchPointArrays arrays;
+    arrays.SetLocations(MakePolygon(random, center,
+                                    SearchPointArrays::MIN_POINTS - 2,
+                                    projection));
+    ok1(!arrays.IsDefined());
+  }
+
+  std::uniform_real_distribution<double> offset(-0.25, 0.25);
+  std::uniform_int_distribution<unsigned> size(SearchPointArrays::MIN_POINTS,
+                                               300);
+
+  for (unsigned i = 0; i < N_POLYGONS; ++i) {
+    const auto border = MakePolygon(random, center, size(random), projection);
+
+    SearchPointArrays arrays;
+    arrays.SetLocations(border);
+    arrays.SetFlatLocations(border);
+
+    std::vector<GeoPoint> queries;
+    for (unsigned j = 0; j < N_QUERIES; ++j)
+      queries.emplace_back(center.longitude + Angle::Degrees(offset(random)),
+                           center.latitude + Angle::Degrees(offset(random)));
+
+    /* distant points, whose squared flat distance does not fit in
+       32 bits */
+    for (unsigned j = 0; j < 4; ++j)
+      queries.emplace_back(center.longitude + Angle::Degrees(60 * offset(random)),
+                           center.latitude + Angle::Degrees(60 * offset(random)));
+
+    /* exercise the edge cases: vertices, and points on the same
+       latitude as a vertex */
+    for (unsigned j = 0; j < border.size(); j += 3) {
+      const GeoPoint &v = border[j].GetLocation();
+      queries.push_back(v);
+      queries.emplace_back(center.longitude + Angle::Degrees(offset(random)),
+                           v.latitude);
+    }
+
+    ok1(CheckInside(arrays, border, queries));
+    ok1(CheckNearestPoint(arrays, border, queries, projection));
+    ok1(CheckIntersections(arrays, border, queries, projection));
+  }
+
+  return exit_status();
+}
@@ -0,0 +1,110 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "Terrain/RasterTerrain.hpp"
+#include "Terrain/TileStore.hpp"
+#include "Profile/Profile.hpp"
+#include "io/FileCache.hpp"
+#include "system/FileUtil.hpp"
+#include "system/Path.hpp"
+#include "Operation/Operation.hpp"
+#include "TestUtil.hpp"
+
+#include <memory>
+
+#include <tchar.h>
+
+static const TCHAR *const map_path = _T("test/data/benalla9.xcm");
+static const TCHAR *const tiles_cache_name = _T("terrain_tiles");
+
+static bool
+HasTileStore(RasterTerrain &terrain)
+{
+  RasterTerrain::ExclusiveLease lease(terrain);
+  return lease->GetTileCache().HasTileStore();
+}
+
+static bool
+HasTileStoreFile(FileCache &cache)
+{
+  return cache.LoadPath(tiles_cache_name, Path(map_path)) != nullptr;
+}
+
+/**
+ * Open the terrain with the given #FileCache and check whether it
+ * uses a #RasterTileStore.
+ */
+static bool
+OpenWithTileStore(FileCache &cache)
+{
+  NullOperationEnvironment operation;
+  std::unique_ptr<RasterTerrain> terrain(RasterTerrain::OpenTerrain(&cache,
+                                                                    operation));
+  return terrain != nullptr && HasTileStore(*terrain);
+}
+
+int
+main(int, char **)
+{
+  plan_tests(9);
+
+  const Path cache_path(_T("output/test/TestTerrainCache"));
+  Directory::Create(Path(_T("output/test")));
+  Directory::Create(cache_path);
+
+  FileCache cache{AllocatedPath(cache_path)};
+  cache.Flush(_T("terrain"));
+  cache.Flush(tiles_cache_name);
+
+  if (cache.GetFreeSpace() < RasterTileStore::MAX_FILE_SIZE) {
+    /* RasterTerrain would not write a store */
+    skip(9, 0, "not enough free space");
+    return exit_status();
+  }
+
+  Profile::Set(ProfileKeys::MapFile, map_path);
+  Profile::Set(ProfileKeys::TerrainTileStore, true);
+
+  /* first start: the overview cache and the store are written */
+  ok1(OpenWithTileStore(cache));
+  ok1(HasTileStoreFile(cache));
+
+  /* both caches are valid */
+  ok1(OpenWithTileStore(cache));
+
+  /* the overview cache is valid, but the store has been evicted */
+  cache.Flush(tiles_cache_name);
+  ok1(OpenWithTileStore(cache));
+  ok1(HasTileStoreFile(cache));
+
+  /* disabling the store deletes it */
+  Profile::Set(ProfileKeys::TerrainTileStore, false);
+  ok1(!OpenWithTileStore(cache));
+  ok1(!HasTileStoreFile(cache));
+
+  /* enabling it later writes a new one */
+  Profile::Set(ProfileKeys::TerrainTileStore, true);
+  ok1(OpenWithTileStore(cache));
+  ok1(HasTileStoreFile(cache));
+
+  return exit_status();
+}
@@ -0,0 +1,104 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+/*
+ * Check that the resumable TriangleContest search, suspended after a
+ * small time budget in each round, ends up with the same triangle as
+ * one exhaustive solve.
+ */
+
+#include "Engine/Contest/Solvers/OLCFAI.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "IGC/IGCBulkParser.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <chrono>
+
+#include <tchar.h>
+
+/**
+ * Stop after this many rounds; the search is expected to finish much
+ * earlier.
+ */
+static constexpr unsigned MAX_ROUNDS = 100000;
+
+static void
+LoadTrace(Path path, Trace &trace)
+{
+  IGCFixColumns columns;
+  IGCParseFixes(path, columns);
+
+  for (std::size_t i = 0; i < columns.size(); ++i) {
+    if (!columns.gps_valid[i])
+      continue;
+
+    if (!trace.empty() && columns.time[i] <= trace.back().GetTime())
+      continue;
+
+    const GeoPoint location(columns.longitude[i], columns.latitude[i]);
+    trace.push_back(TracePoint(location, columns.time[i],
+                               columns.gps_altitude[i], 0, 0));
+  }
+}
+
+static void
+TestResumable(Path path)
+{
+  Trace trace(0, Trace::null_time, 1024);
+  LoadTrace(path, trace);
+
+  OLCFAI reference(trace, false);
+  reference.Solve(true);
+  const ContestResult &expected = reference.GetBestResult();
+
+  OLCFAI resumable(trace, false);
+  resumable.SetTickBudget(std::chrono::milliseconds(1));
+
+  unsigned n_rounds = 0;
+  while (n_rounds < MAX_ROUNDS) {
+    ++n_rounds;
+    resumable.Solve(false);
+
+    const ContestResult &result = resumable.GetBestResult();
+    if (result.IsDefined() && result.progress >= 1)
+      break;
+  }
+
+  const ContestResult &result = resumable.GetBestResult();
+  ok1(expected.IsDefined());
+  ok1(n_rounds > 1);
+  ok1(result.progress >= 1);
+  ok1(result.gap == 0);
+  ok1(equals(result.score, expected.score));
+  ok1(equals(result.distance, expected.distance));
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(12);
+
+  TestResumable(Path(_T("test/data/01lz1hq1.igc")));
+  TestResumable(Path(_T("test/data/9crx3101.igc")));
+
+  return exit_status();
+}
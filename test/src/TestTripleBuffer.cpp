@@ -0,0 +1,99 @@
+/* Copyright_License {
+
+  XCSoar Glide Computer - http://www.xcsoar.org/
+  Copyright (C) 2000-2021 The XCSoar Project
+  A detailed list of copyright holders can be found in the file "AUTHORS".
+
+  This program is free software; you can redistribute it and/or
+  modify it under the terms of the GNU General Public License
+  as published by the Free Software Foundation; either version 2
+  of the License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+}
+*/
+
+#include "thread/TripleBuffer.hpp"
+#include "TestUtil.hpp"
+
+#include <thread>
+
+struct Pair {
+  unsigned a, b;
+};
+
+static void
+TestSingleThread()
+{
+  TripleBuffer<unsigned> buffer;
+  ok1(!buffer.Consume());
+
+  buffer.GetBack() = 1;
+  buffer.Publish();
+  ok1(buffer.Consume());
+  ok1(buffer.GetFront() == 1);
+  ok1(!buffer.Consume());
+  ok1(buffer.GetFront() == 1);
+
+  /* the reader gets only the latest version */
+  buffer.GetBack() = 2;
+  buffer.Publish();
+  buffer.GetBack() = 3;
+  buffer.Publish();
+  ok1(buffer.Consume());
+  ok1(buffer.GetFront() == 3);
+  ok1(!buffer.Consume());
+}
+
+static void
+TestTwoThreads()
+{
+  static constexpr unsigned N = 100000;
+
+  TripleBuffer<Pair> buffer;
+
+  std::thread writer([&buffer]{
+    for (unsigned i = 1; i <= N; ++i) {
+      Pair &p = buffer.GetBack();
+      p.a = i;
+      p.b = i;
+      buffer.Publish();
+    }
+  });
+
+  bool consistent = true, monotonic = true;
+  unsigned last = 0;
+  while (last < N) {
+    if (!buffer.Consume())
+      continue;
+
+    const Pair &p = buffer.GetFront();
+    if (p.a != p.b)
+      consistent = false;
+    if (p.a <= last)
+      monotonic = false;
+    last = p.a;
+  }
+
+  writer.join();
+
+  ok1(consistent);
+  ok1(monotonic);
+}
+
+int main(int argc, char **argv)
+{
+  plan_tests(10);
+
+  TestSingleThread();
+  TestTwoThreads();
+
+  return exit_status();
+}
@@ -33,6 +33,7 @@
 #include "GlideSolvers/GlideSettings.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Geo/SpeedVector.hpp"
+#include "Geo/GeoVector.hpp"
 #include "Operation/Operation.hpp"
 #include "system/FileUtil.hpp"
 
@@ -101,8 +102,78 @@ test_reach(const RasterMap &map, double mwind, double mc, double height_min_work
   //  printf("# pixel size %g\n", (double)pd);
 }
 
+static void
+test_reach_update(const RasterMap &map, double mc)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+
+  GlidePolar polar(mc);
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, SpeedVector::Zero(), 0);
+  route.SetTerrain(&map);
+
+  const GeoPoint origin(map.GetMapCenter());
+  const int horigin = map.GetHeight(origin).GetValueOr0() + 1000;
+  route.SolveReach(AGeoPoint(origin, horigin), config, INT_MAX);
+
+  // a few seconds later: 300m further north, and 10m lower
+  const AGeoPoint moved(GeoVector(300, Angle::Zero()).EndPoint(origin),
+                        horigin - 10);
+  ok(route.UpdateReach(moved, config, INT_MAX), "reach update", 0);
+  ok(!route.IsTerrainReachEmpty(), "reach update not empty", 0);
+
+  // compare with a full solve from the same position
+  TerrainRoute full;
+  full.UpdatePolar(settings, config, polar, polar, SpeedVector::Zero(), 0);
+  full.SetTerrain(&map);
+  full.SolveReach(moved, config, INT_MAX);
+
+  bool conservative = true;
+  unsigned n_full = 0, n_updated = 0;
+  for (unsigned i = 0; i < 20; ++i) {
+    for (unsigned j = 0; j < 20; ++j) {
+      const GeoPoint x(origin.longitude + Angle::Degrees(0.03 * i - 0.3),
+                       origin.latitude + Angle::Degrees(0.03 * j - 0.3));
+      const AGeoPoint dest(x, map.GetHeight(x).GetValueOr0());
+
+      ReachResult updated, solved;
+      route.FindPositiveArrival(dest, updated);
+      full.FindPositiveArrival(dest, solved);
+
+      if (solved.IsReachableTerrain())
+        ++n_full;
+
+      if (!updated.IsReachableTerrain())
+        continue;
+
+      ++n_updated;
+      if (!solved.IsReachableTerrain() || updated.terrain > solved.terrain) {
+        printf("# update overestimates %d/%d at %u,%u\n",
+               updated.terrain, solved.terrain, i, j);
+        conservative = false;
+      }
+    }
+  }
+
+  printf("# reachable: full %u, updated %u\n", n_full, n_updated);
+  ok(conservative, "reach update conservative", 0);
+  ok(n_updated > 0 && n_updated * 10 >= n_full * 9,
+     "reach update close to full solve", 0);
+
+  // climbed too much, or moved too far: needs a full solve
+  ok(!route.UpdateReach(AGeoPoint(moved, horigin + 100), config, INT_MAX),
+     "reach update after climb", 0);
+  ok(!route.UpdateReach(AGeoPoint(GeoVector(5000, Angle::Zero()).EndPoint(origin),
+                                  horigin - 100),
+                        config, INT_MAX),
+     "reach update after long glide", 0);
+}
+
 int main(int argc, char** argv) {
-  static const char hc_path[] = "tmp/map.xcm";
+  static const char hc_path[] = "test/data/benalla9.xcm";
   const char *map_path;
   if ((argc<2) || !strlen(argv[1])) {
     map_path = hc_path;
@@ -135,11 +206,12 @@ int main(int argc, char** argv) {
   } while (map.IsDirty());
   zzip_dir_close(dir);
 
-  plan_tests(8);
+  plan_tests(14);
   test_reach(map, 0, 0.1, 0);
   test_reach(map, 0, 0.1, 750);
   test_reach(map, 0, 0.1, 500);
   test_reach(map, 0, 0.1, 250);
+  test_reach_update(map, 0.1);
 
   return exit_status();
 }